@@ -1,24 +1,21 @@
-// https://vulkan-tutorial.com/Drawing_a_triangle/Graphics_pipeline_basics/Shader_modules#page_Compiling-the-shaders
+// https://vulkan-tutorial.com/Vertex_buffers/Vertex_input_description
 
 #version 450
 
-layout(location=0)out vec3 fragColor;
+// https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#interfaces-resources-pushconst
+layout(push_constant) uniform PushConstants {
+    mat4 proj_view_matrix;
+} push_constants;
 
-vec2 positions[3]=vec2[](
-    vec2(0.,-.5),
-    vec2(.5,.5),
-    vec2(-.5,.5)
-);
+// 位置和颜色分别来自两个vertex binding（SoA），颜色为R8G8B8A8_UNORM，读取时自动归一化到[0,1]
+layout(location=0)in vec3 inPosition;
+layout(location=1)in vec4 inColor;
 
-vec3 colors[3]=vec3[](
-    vec3(1.,0.,0.),
-    vec3(0.,1.,0.),
-    vec3(0.,0.,1.)
-);
+layout(location=0)out vec4 fragColor;
 
 void main(){
-    gl_Position=vec4(positions[gl_VertexIndex],0.,1.);
-    // ! DebugDrawManager::setupPipelines：当i==0时，会检查着色器中是否包含point size，因此只需要加上即可
+    gl_Position=push_constants.proj_view_matrix*vec4(inPosition,1.);
+    // ! 点图元的pipeline会检查着色器中是否写入了point size，因此只需要加上即可
     gl_PointSize=2;
-    fragColor=colors[gl_VertexIndex];
-}
\ No newline at end of file
+    fragColor=inColor;
+}
@@ -0,0 +1,28 @@
+// https://vulkan-tutorial.com/Vertex_buffers/Vertex_input_description
+
+#version 450
+
+layout(push_constant) uniform PushConstants {
+    mat4 proj_view_matrix;
+} push_constants;
+
+// binding 0：单位网格的顶点，w为胶囊体半球的方向（+1/-1），其他形状为0
+layout(location=0)in vec4 inPosition;
+// binding 1：逐实例数据，3x4仿射变换按行存放
+layout(location=1)in vec4 inTransformRow0;
+layout(location=2)in vec4 inTransformRow1;
+layout(location=3)in vec4 inTransformRow2;
+layout(location=4)in float inCapOffset;
+layout(location=5)in vec4 inColor;
+
+layout(location=0)out vec4 fragColor;
+
+void main(){
+    // 胶囊体两端的半球沿局部y轴撑开，得到任意长度的胶囊
+    vec4 local_position=vec4(inPosition.xyz+vec3(0.,inPosition.w*inCapOffset,0.),1.);
+    vec3 world_position=vec3(dot(inTransformRow0,local_position),
+                             dot(inTransformRow1,local_position),
+                             dot(inTransformRow2,local_position));
+    gl_Position=push_constants.proj_view_matrix*vec4(world_position,1.);
+    fragColor=inColor;
+}
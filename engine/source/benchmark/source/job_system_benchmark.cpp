@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "runtime/core/job/job_system.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t k_job_count = 100000;
+    constexpr uint32_t k_parallel_for_batch_size = 64;
+    constexpr uint32_t k_repeat_count = 5;
+
+    // 小任务：几百纳秒的整数运算，结果写回各自的槽位，避免被编译器优化掉
+    inline uint64_t smallWork(uint64_t seed)
+    {
+        uint64_t value = seed;
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            value ^= value << 13;
+            value ^= value >> 7;
+            value ^= value << 17;
+        }
+        return value;
+    }
+
+    // 重复k_repeat_count次取最快的一次，返回每秒完成的job数
+    double measureJobsPerSecond(const std::function<void()>& body)
+    {
+        double best_seconds = 0.0;
+        for (uint32_t i = 0; i < k_repeat_count; ++i)
+        {
+            Clock::time_point begin_time = Clock::now();
+            body();
+            double seconds = std::chrono::duration<double>(Clock::now() - begin_time).count();
+            best_seconds = i == 0 ? seconds : std::min(best_seconds, seconds);
+        }
+        return k_job_count / best_seconds;
+    }
+
+    // 值为0的列输出"-"
+    std::string formatRate(double rate)
+    {
+        return rate > 0.0 ? std::to_string(static_cast<uint64_t>(rate)) : std::string("-");
+    }
+
+    void printRow(const std::string& threads, double empty_jobs, double small_jobs, double parallel_for_items)
+    {
+        std::cout << std::setw(12) << threads
+            << std::setw(16) << formatRate(empty_jobs)
+            << std::setw(16) << formatRate(small_jobs)
+            << std::setw(20) << formatRate(parallel_for_items) << std::endl;
+    }
+} // namespace
+
+// 任务系统的扩展性测试：依次用1..N个线程（含主线程）执行空job、小job和parallelFor，输出每秒完成的数量。
+// 1个线程时没有工作线程，直接在主线程上串行执行作为基准
+int main(int argc, char** argv) {
+    uint32_t max_thread_count = std::max(std::thread::hardware_concurrency(), 2u);
+    if (argc > 1)
+    {
+        max_thread_count = std::max(static_cast<uint32_t>(std::stoul(argv[1])), 2u);
+    }
+
+    std::vector<uint64_t> results(k_job_count);
+    std::cout << k_job_count << " jobs per run, best of " << k_repeat_count << " runs, parallelFor batch size " << k_parallel_for_batch_size << std::endl;
+    std::cout << std::setw(12) << "threads"
+        << std::setw(16) << "empty jobs/s"
+        << std::setw(16) << "small jobs/s"
+        << std::setw(20) << "parallelFor items/s" << std::endl;
+
+    {
+        // 串行执行没有调度开销，空job没有可比的基准
+        double small_jobs = measureJobsPerSecond([&results]() {
+            for (uint32_t i = 0; i < k_job_count; ++i)
+            {
+                results[i] = smallWork(i + 1);
+            }
+        });
+        printRow("1 (serial)", 0.0, small_jobs, small_jobs);
+    }
+
+    for (uint32_t thread_count = 2; thread_count <= max_thread_count; ++thread_count)
+    {
+        Mercury::JobSystem job_system;
+        job_system.initialize(thread_count - 1);
+
+        double empty_jobs = measureJobsPerSecond([&job_system]() {
+            Mercury::JobCounter counter;
+            for (uint32_t i = 0; i < k_job_count; ++i)
+            {
+                job_system.run([]() {}, &counter);
+            }
+            job_system.wait(counter);
+        });
+        double small_jobs = measureJobsPerSecond([&job_system, &results]() {
+            Mercury::JobCounter counter;
+            for (uint32_t i = 0; i < k_job_count; ++i)
+            {
+                job_system.run([&results, i]() { results[i] = smallWork(i + 1); }, &counter);
+            }
+            job_system.wait(counter);
+        });
+        double parallel_for_items = measureJobsPerSecond([&job_system, &results]() {
+            job_system.parallelFor(k_job_count, k_parallel_for_batch_size, [&results](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    results[i] = smallWork(i + 1);
+                }
+            });
+        });
+        printRow(std::to_string(thread_count), empty_jobs, small_jobs, parallel_for_items);
+
+        job_system.clear();
+    }
+
+    return 0;
+}
@@ -10,9 +10,56 @@ int main(int argc, char** argv) {
     std::filesystem::path executable_path(argv[0]);
     std::filesystem::path config_file_path = executable_path.parent_path() / "";
 
+    // 命令行参数：--headless 不创建窗口；--frames N 运行N帧后退出；--capture-dir DIR 把每帧画面保存到DIR（仅headless）；
+    // --profile FILE 采集CPU分析数据，退出时导出为Chrome trace JSON；--logic-thread 逻辑在独立线程上执行；
+    // --target-fps N 限制最高帧率；--present-mode fifo|mailbox|immediate|fifo_relaxed；--frames-in-flight N 同时处理的帧数；
+    // --bench-commands N 录制N组viewport/scissor/draw并输出每条命令的录制耗时
+    Mercury::EngineStartInfo start_info;
+    start_info.config_file_path = config_file_path.generic_string();
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+        if (arg == "--headless")
+        {
+            start_info.is_headless = true;
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            start_info.frame_count = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--capture-dir" && i + 1 < argc)
+        {
+            start_info.frame_capture_dir = argv[++i];
+        }
+        else if (arg == "--profile" && i + 1 < argc)
+        {
+            start_info.profile_output_path = argv[++i];
+        }
+        else if (arg == "--logic-thread")
+        {
+            start_info.is_logic_thread_enabled = true;
+        }
+        else if (arg == "--target-fps" && i + 1 < argc)
+        {
+            start_info.target_fps = std::stof(argv[++i]);
+        }
+        else if (arg == "--present-mode" && i + 1 < argc)
+        {
+            start_info.present_mode = argv[++i];
+        }
+        else if (arg == "--frames-in-flight" && i + 1 < argc)
+        {
+            start_info.frames_in_flight = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--bench-commands" && i + 1 < argc)
+        {
+            start_info.command_benchmark_count = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+    }
+
     // 引擎创建与初始化
     Mercury::MercuryEngine* engine = new Mercury::MercuryEngine();
-    engine->startEngine(config_file_path.generic_string());
+    engine->startEngine(start_info);
     engine->initialize();
 
     // 编辑器创建与初始化
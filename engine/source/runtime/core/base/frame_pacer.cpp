@@ -0,0 +1,76 @@
+#include "runtime/core/base/frame_pacer.h"
+#include "runtime/core/base/profiler.h"
+
+#include <cmath>
+#include <thread>
+
+namespace Mercury
+{
+    void FramePacer::setTargetFPS(float target_fps)
+    {
+        m_target_fps = target_fps > 0.f ? target_fps : 0.f;
+        m_frame_duration = m_target_fps > 0.f ?
+            std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_target_fps)) :
+            Clock::duration(0);
+        m_next_frame_time = Clock::now() + m_frame_duration;
+    }
+
+    void FramePacer::waitForNextFrame()
+    {
+        if (m_target_fps <= 0.f)
+        {
+            return;
+        }
+
+        MERCURY_PROFILE_SCOPE("FramePacer::waitForNextFrame");
+        Clock::time_point now = Clock::now();
+        if (now < m_next_frame_time)
+        {
+            preciseSleepUntil(m_next_frame_time);
+            m_next_frame_time += m_frame_duration;
+        }
+        else
+        {
+            // 已经超时（例如窗口拖动或断点）时不补帧，从当前时刻重新开始计时
+            m_next_frame_time = now + m_frame_duration;
+        }
+    }
+
+    void FramePacer::preciseSleepUntil(Clock::time_point deadline)
+    {
+        using Seconds = std::chrono::duration<double>;
+
+        // 每次sleep 1ms，用Welford算法在线更新sleep实际耗时的均值和方差
+        double remaining = Seconds(deadline - Clock::now()).count();
+        while (remaining > m_sleep_estimate)
+        {
+            Clock::time_point start = Clock::now();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            double observed = Seconds(Clock::now() - start).count();
+            remaining -= observed;
+
+            ++m_sleep_count;
+            double delta = observed - m_sleep_mean;
+            m_sleep_mean += delta / m_sleep_count;
+            m_sleep_m2 += delta * (observed - m_sleep_mean);
+            double stddev = std::sqrt(m_sleep_m2 / (m_sleep_count - 1));
+            m_sleep_estimate = m_sleep_mean + stddev;
+        }
+
+        // 最后一段自旋，精度取决于时钟而不是调度器
+        while (Clock::now() < deadline)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void FramePacer::markInputSampled()
+    {
+        m_last_input_sample_time.store(Clock::now().time_since_epoch().count(), std::memory_order_release);
+    }
+
+    FramePacer::Clock::time_point FramePacer::getLastInputSampleTime() const
+    {
+        return Clock::time_point(Clock::duration(m_last_input_sample_time.load(std::memory_order_acquire)));
+    }
+} // namespace Mercury
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Mercury
+{
+    /*
+    * 帧节奏控制：限制最高帧率（降低功耗），并记录每帧采样输入的时刻用于统计输入到present的延迟。
+    * 限帧时先用系统sleep睡到截止时间附近，剩下的一小段再自旋，避免sleep的调度粒度（Windows上默认约15.6ms）导致帧时间抖动。
+    * https://blog.bearcats.nl/perfect-sleep-function/
+    */
+    class FramePacer
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        // target_fps <= 0 表示不限帧
+        void setTargetFPS(float target_fps);
+        float getTargetFPS() const { return m_target_fps; }
+
+        // 每帧结束时调用一次：没有限帧时直接返回，否则等待到下一帧的开始时刻
+        void waitForNextFrame();
+
+        // 在轮询输入之后调用；可以从其他线程读取
+        void markInputSampled();
+        Clock::time_point getLastInputSampleTime() const;
+
+    private:
+        void preciseSleepUntil(Clock::time_point deadline);
+
+        float m_target_fps{ 0.f };
+        Clock::duration m_frame_duration{ 0 };
+        Clock::time_point m_next_frame_time{};
+
+        // sleep实际耗时的估计值（均值 + 标准差），剩余时间小于它时改为自旋
+        double m_sleep_estimate{ 5e-3 };
+        double m_sleep_mean{ 5e-3 };
+        double m_sleep_m2{ 0.0 };
+        uint64_t m_sleep_count{ 1 };
+
+        std::atomic<int64_t> m_last_input_sample_time{ 0 };
+    };
+} // namespace Mercury
@@ -1,4 +1,42 @@
 #pragma once
 
 #include <cstddef>
-#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace Mercury
+{
+    /*
+    * 把参与比较的字段按字节依次追加到key中，key直接作为缓存的键（std::string自带hash和相等比较）。
+    * 只比较hash时两个不同的状态hash冲突会拿到错误的对象，用完整的key比较则不会。
+    * 变长的数据（字符串、字节数组）先写入长度，避免不同的拆分方式拼出相同的key。
+    */
+    template<typename T>
+    inline void key_append(std::string& key, const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "key_append only accepts trivially copyable values");
+        key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    inline void key_append_bytes(std::string& key, const void* data, std::size_t size)
+    {
+        key_append(key, size);
+        if (data != nullptr && size != 0)
+        {
+            key.append(static_cast<const char*>(data), size);
+        }
+    }
+
+    inline void key_append(std::string& key, std::string_view value)
+    {
+        key_append_bytes(key, value.data(), value.size());
+    }
+
+    template<typename T, typename... Ts>
+    inline void key_append(std::string& key, const T& value, const Ts&... rest)
+    {
+        key_append(key, value);
+        (key_append(key, rest), ...);
+    }
+} // namespace Mercury
@@ -0,0 +1,260 @@
+#include "runtime/core/base/profiler.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace Mercury
+{
+    namespace
+    {
+        struct ProfileEvent
+        {
+            const char* name;
+            int64_t begin_time;
+            int64_t end_time;
+        };
+
+        // 每个线程最多记录 k_events_per_chunk * k_max_chunk_count 个区间，超出的丢弃并计数
+        constexpr uint32_t k_events_per_chunk = 4096;
+        constexpr uint32_t k_max_chunk_count = 256;
+
+        struct ProfileEventChunk
+        {
+            ProfileEvent events[k_events_per_chunk];
+        };
+
+        // 只有所属线程写入；event_count以release发布，导出线程acquire读取后可以安全访问之前的事件
+        struct ProfileThreadBuffer
+        {
+            ProfileThreadBuffer()
+            {
+                for (std::atomic<ProfileEventChunk*>& chunk : chunks)
+                {
+                    chunk.store(nullptr, std::memory_order_relaxed);
+                }
+            }
+
+            ~ProfileThreadBuffer()
+            {
+                for (std::atomic<ProfileEventChunk*>& chunk : chunks)
+                {
+                    delete chunk.load(std::memory_order_relaxed);
+                }
+            }
+
+            uint32_t thread_index{ 0 };
+            std::atomic<const char*> thread_name{ nullptr };
+            // 缓冲区中的事件属于哪一次采集；与当前采集不同时由所属线程在下一次写入前清空
+            std::atomic<uint32_t> generation{ 0 };
+            std::atomic<uint32_t> event_count{ 0 };
+            std::atomic<uint32_t> dropped_count{ 0 };
+            std::atomic<ProfileEventChunk*> chunks[k_max_chunk_count];
+        };
+
+        struct ProfilerState
+        {
+            // 保护缓冲区注册，并让导出与开始新采集互斥
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ProfileThreadBuffer>> buffers;
+            std::atomic<uint32_t> generation{ 0 };
+            const std::chrono::steady_clock::time_point epoch{ std::chrono::steady_clock::now() };
+
+            std::mutex name_mutex;
+            std::unordered_set<std::string> names; // 元素的地址在rehash时不变
+        };
+
+        ProfilerState& getState()
+        {
+            static ProfilerState state;
+            return state;
+        }
+
+        // 线程第一次记录时注册缓冲区，之后通过thread_local直接访问；线程退出后缓冲区保留到程序结束，已记录的事件仍可导出
+        ProfileThreadBuffer* registerBuffer()
+        {
+            ProfilerState& state = getState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.buffers.push_back(std::make_unique<ProfileThreadBuffer>());
+            ProfileThreadBuffer* buffer = state.buffers.back().get();
+            buffer->thread_index = static_cast<uint32_t>(state.buffers.size() - 1);
+            return buffer;
+        }
+
+        ProfileThreadBuffer& getThreadBuffer()
+        {
+            thread_local ProfileThreadBuffer* t_buffer = nullptr;
+            if (t_buffer == nullptr)
+            {
+                t_buffer = registerBuffer();
+            }
+            return *t_buffer;
+        }
+
+        // GPU区间不属于任何CPU线程，单独作为一条轨道导出
+        ProfileThreadBuffer& getGpuBuffer()
+        {
+            static ProfileThreadBuffer* s_buffer = [] {
+                ProfileThreadBuffer* buffer = registerBuffer();
+                buffer->thread_name.store("GPU", std::memory_order_release);
+                return buffer;
+            }();
+            return *s_buffer;
+        }
+
+        void appendEvent(ProfileThreadBuffer& buffer, const char* name, int64_t begin_time, int64_t end_time)
+        {
+            const uint32_t generation = getState().generation.load(std::memory_order_acquire);
+            if (buffer.generation.load(std::memory_order_relaxed) != generation)
+            {
+                // 新的采集：先清空计数再发布新的generation，导出线程看到新generation时计数一定已经清空
+                buffer.event_count.store(0, std::memory_order_relaxed);
+                buffer.dropped_count.store(0, std::memory_order_relaxed);
+                buffer.generation.store(generation, std::memory_order_release);
+            }
+
+            const uint32_t event_index = buffer.event_count.load(std::memory_order_relaxed);
+            const uint32_t chunk_index = event_index / k_events_per_chunk;
+            if (chunk_index >= k_max_chunk_count)
+            {
+                buffer.dropped_count.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            ProfileEventChunk* chunk = buffer.chunks[chunk_index].load(std::memory_order_relaxed);
+            if (chunk == nullptr)
+            {
+                // 块在两次采集之间复用，只在第一次用到时分配
+                chunk = new ProfileEventChunk();
+                buffer.chunks[chunk_index].store(chunk, std::memory_order_release);
+            }
+            chunk->events[event_index % k_events_per_chunk] = { name, begin_time, end_time };
+            buffer.event_count.store(event_index + 1, std::memory_order_release);
+        }
+
+        void writeJsonString(std::ofstream& file, const char* text)
+        {
+            file << '"';
+            for (const char* c = text; *c != '\0'; ++c)
+            {
+                if (*c == '"' || *c == '\\')
+                {
+                    file << '\\';
+                }
+                file << *c;
+            }
+            file << '"';
+        }
+    } // namespace
+
+    std::atomic<bool> Profiler::s_is_capturing{ false };
+
+    void Profiler::beginCapture()
+    {
+        ProfilerState& state = getState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.generation.fetch_add(1, std::memory_order_release);
+        s_is_capturing.store(true, std::memory_order_relaxed);
+    }
+
+    void Profiler::endCapture()
+    {
+        s_is_capturing.store(false, std::memory_order_relaxed);
+    }
+
+    int64_t Profiler::now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - getState().epoch).count();
+    }
+
+    void Profiler::setThreadName(const char* name)
+    {
+        getThreadBuffer().thread_name.store(name, std::memory_order_release);
+    }
+
+    void Profiler::recordZone(const char* name, int64_t begin_time, int64_t end_time)
+    {
+        appendEvent(getThreadBuffer(), name, begin_time, end_time);
+    }
+
+    void Profiler::recordGpuZone(const char* name, int64_t begin_time, int64_t end_time)
+    {
+        appendEvent(getGpuBuffer(), name, begin_time, end_time);
+    }
+
+    const char* Profiler::internName(const std::string& name)
+    {
+        ProfilerState& state = getState();
+        std::lock_guard<std::mutex> lock(state.name_mutex);
+        return state.names.insert(name).first->c_str();
+    }
+
+    bool Profiler::exportChromeTrace(const std::filesystem::path& path)
+    {
+        endCapture();
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file)
+        {
+            std::cout << "failed to open " << path.generic_string() << std::endl;
+            return false;
+        }
+
+        ProfilerState& state = getState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        const uint32_t generation = state.generation.load(std::memory_order_acquire);
+
+        // https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+        // 完整事件（ph为X）用开始时间和持续时间描述一个区间，时间单位为微秒
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool is_first_event = true;
+        uint64_t event_count = 0;
+        uint64_t dropped_count = 0;
+        for (const std::unique_ptr<ProfileThreadBuffer>& buffer : state.buffers)
+        {
+            const char* thread_name = buffer->thread_name.load(std::memory_order_acquire);
+            if (thread_name != nullptr)
+            {
+                file << (is_first_event ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread_index << ",\"args\":{\"name\":";
+                writeJsonString(file, thread_name);
+                file << "}}";
+                is_first_event = false;
+            }
+
+            // 这个线程在本次采集中没有记录过事件
+            if (buffer->generation.load(std::memory_order_acquire) != generation)
+            {
+                continue;
+            }
+
+            const uint32_t buffer_event_count = buffer->event_count.load(std::memory_order_acquire);
+            for (uint32_t i = 0; i < buffer_event_count; ++i)
+            {
+                const ProfileEventChunk* chunk = buffer->chunks[i / k_events_per_chunk].load(std::memory_order_acquire);
+                const ProfileEvent& event = chunk->events[i % k_events_per_chunk];
+                file << (is_first_event ? "" : ",") << "\n{\"name\":";
+                writeJsonString(file, event.name);
+                file << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_index
+                    << ",\"ts\":" << event.begin_time / 1000 << "." << (event.begin_time % 1000) / 100
+                    << ",\"dur\":" << (event.end_time - event.begin_time) / 1000 << "." << ((event.end_time - event.begin_time) % 1000) / 100
+                    << "}";
+                is_first_event = false;
+            }
+            event_count += buffer_event_count;
+            dropped_count += buffer->dropped_count.load(std::memory_order_relaxed);
+        }
+        file << "\n]}\n";
+
+        std::cout << "export chrome trace success! " << event_count << " zones";
+        if (dropped_count > 0)
+        {
+            std::cout << ", " << dropped_count << " dropped";
+        }
+        std::cout << std::endl;
+        return true;
+    }
+} // namespace Mercury
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// 编译期开关：定义为0时所有MERCURY_PROFILE_*宏展开为空
+#ifndef MERCURY_ENABLE_PROFILER
+#define MERCURY_ENABLE_PROFILER 1
+#endif
+
+namespace Mercury
+{
+    /*
+    * CPU帧分析器：在代码中用MERCURY_PROFILE_SCOPE标记区间，采集期间记录每个区间的开始/结束时间，导出为Chrome trace JSON，
+    * 可以在chrome://tracing或https://ui.perfetto.dev中查看每一帧、每个线程的时间线（嵌套区间按时间自动形成层级）。
+    * 平均FPS会掩盖偶发的长帧，时间线能直接看到是哪一帧、哪一段耗时。
+    *
+    * 每个线程写入自己的事件缓冲区（只有该线程写，不加锁），缓冲区按块增长，块的地址一旦发布就不会移动，导出时可以无锁读取。
+    * 没有采集时每个区间只有一次relaxed原子读。
+    * 区间名必须是生命周期覆盖整个采集过程的字符串（通常是字面量），记录时只保存指针。
+    * https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+    */
+    class Profiler
+    {
+    public:
+        // 开始新的采集，丢弃之前采集的事件
+        static void beginCapture();
+        static void endCapture();
+        static bool isCapturing() { return s_is_capturing.load(std::memory_order_relaxed); }
+
+        // 结束采集并导出；不能与beginCapture并发调用
+        static bool exportChromeTrace(const std::filesystem::path& path);
+
+        // 导出时显示的线程名，name需要是字面量
+        static void setThreadName(const char* name);
+
+        // 从分析器的时间起点开始的纳秒数
+        static int64_t now();
+        static void recordZone(const char* name, int64_t begin_time, int64_t end_time);
+        // 记录到单独的"GPU"轨道上，时间需要由调用者换算到分析器的时间线；只能由一个线程（渲染线程）调用
+        static void recordGpuZone(const char* name, int64_t begin_time, int64_t end_time);
+        // 返回与name内容相同、生命周期到程序结束的字符串，用于运行时生成的区间名
+        static const char* internName(const std::string& name);
+
+    private:
+        static std::atomic<bool> s_is_capturing;
+    };
+
+    // 构造时记录开始时间，析构时记录一个完整区间
+    class ProfileScope
+    {
+    public:
+        explicit ProfileScope(const char* name)
+        {
+            if (Profiler::isCapturing())
+            {
+                m_name = name;
+                m_begin_time = Profiler::now();
+            }
+        }
+
+        ~ProfileScope()
+        {
+            if (m_name != nullptr)
+            {
+                Profiler::recordZone(m_name, m_begin_time, Profiler::now());
+            }
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        const char* m_name{ nullptr };
+        int64_t m_begin_time{ 0 };
+    };
+} // namespace Mercury
+
+#if MERCURY_ENABLE_PROFILER
+#define MERCURY_PROFILE_CONCAT_IMPL(a, b) a##b
+#define MERCURY_PROFILE_CONCAT(a, b) MERCURY_PROFILE_CONCAT_IMPL(a, b)
+#define MERCURY_PROFILE_SCOPE(name) ::Mercury::ProfileScope MERCURY_PROFILE_CONCAT(_mercury_profile_scope_, __COUNTER__)(name)
+#define MERCURY_PROFILE_THREAD(name) ::Mercury::Profiler::setThreadName(name)
+#else
+#define MERCURY_PROFILE_SCOPE(name) ((void)0)
+#define MERCURY_PROFILE_THREAD(name) ((void)0)
+#endif
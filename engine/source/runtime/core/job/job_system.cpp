@@ -0,0 +1,306 @@
+#include "runtime/core/job/job_system.h"
+#include "runtime/core/base/profiler.h"
+
+#include <algorithm>
+
+namespace Mercury
+{
+    namespace
+    {
+        constexpr uint32_t k_invalid_worker_index = ~0u;
+        // 当前线程在JobSystem中的下标，不属于JobSystem的线程为k_invalid_worker_index
+        thread_local uint32_t t_worker_index = k_invalid_worker_index;
+    } // namespace
+
+    void JobSystem::initialize(uint32_t worker_count)
+    {
+        if (worker_count == 0)
+        {
+            // 主线程本身也会执行job
+            worker_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        }
+
+        m_main_thread_id = std::this_thread::get_id();
+        t_worker_index = k_main_thread_index;
+        m_is_stopping = false;
+
+        m_queues.clear();
+        for (uint32_t i = 0; i < worker_count + 1; ++i)
+        {
+            m_queues.push_back(std::make_unique<WorkerQueue>());
+        }
+        for (uint32_t i = 1; i < worker_count + 1; ++i)
+        {
+            m_workers.emplace_back(&JobSystem::workerLoop, this, i);
+        }
+    }
+
+    void JobSystem::clear()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_is_stopping = true;
+        }
+        m_sleep_condition.notify_all();
+
+        for (std::thread& worker : m_workers)
+        {
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+        m_workers.clear();
+
+        // 工作线程退出后剩下的只有主线程job
+        processMainThreadJobs();
+        m_queues.clear();
+    }
+
+    bool JobSystem::isMainThread() const
+    {
+        return std::this_thread::get_id() == m_main_thread_id;
+    }
+
+    uint32_t JobSystem::getCurrentWorkerIndex()
+    {
+        return t_worker_index;
+    }
+
+    void JobSystem::run(std::function<void()> function, JobCounter* counter, JobAffinity affinity)
+    {
+        if (counter != nullptr)
+        {
+            counter->m_value.fetch_add(1, std::memory_order_relaxed);
+        }
+        enqueue(Job{ std::move(function), counter, affinity });
+    }
+
+    void JobSystem::runAfter(JobCounter& dependency, std::function<void()> function, JobCounter* counter, JobAffinity affinity)
+    {
+        // 提交时就计数，这样在依赖完成之前等待counter的线程也不会提前返回
+        if (counter != nullptr)
+        {
+            counter->m_value.fetch_add(1, std::memory_order_relaxed);
+        }
+        Job job{ std::move(function), counter, affinity };
+        {
+            // 与finishJob中的加锁配对：要么这里看到计数已经归零，要么finishJob一定能取到这里挂上的job
+            std::lock_guard<std::mutex> lock(dependency.m_mutex);
+            if (dependency.m_value.load(std::memory_order_acquire) != 0)
+            {
+                dependency.m_continuations.push_back(std::move(job));
+                return;
+            }
+        }
+        enqueue(std::move(job));
+    }
+
+    void JobSystem::parallelFor(uint32_t count, uint32_t batch_size, const std::function<void(uint32_t, uint32_t)>& function)
+    {
+        batch_size = std::max(batch_size, 1u);
+        JobCounter counter;
+        for (uint32_t begin = 0; begin < count; begin += batch_size)
+        {
+            uint32_t end = std::min(begin + batch_size, count);
+            run([&function, begin, end]() { function(begin, end); }, &counter);
+        }
+        wait(counter);
+    }
+
+    void JobSystem::wait(JobCounter& counter)
+    {
+        uint32_t worker_index = t_worker_index;
+        const bool is_main_thread = worker_index == k_main_thread_index;
+        while (!counter.isDone())
+        {
+            if (is_main_thread && tryRunMainThreadJob())
+            {
+                continue;
+            }
+
+            Job job;
+            if (tryGetJob(worker_index, job))
+            {
+                execute(job);
+                continue;
+            }
+
+            // 剩下的job都在其他线程上执行，休眠而不是空转，counter归零或有新的job入队时被唤醒
+            std::unique_lock<std::mutex> lock(m_sleep_mutex);
+            ++m_waiting_thread_count;
+            m_wait_condition.wait(lock, [&] {
+                return counter.isDone() || m_queued_job_count.load(std::memory_order_acquire) > 0 || (is_main_thread && hasMainThreadJob());
+            });
+            --m_waiting_thread_count;
+        }
+        // 等最后一个finishJob释放counter的锁之后再返回，调用方随后可以安全地销毁counter
+        std::lock_guard<std::mutex> lock(counter.m_mutex);
+    }
+
+    void JobSystem::processMainThreadJobs()
+    {
+        while (tryRunMainThreadJob())
+        {
+        }
+    }
+
+    void JobSystem::workerLoop(uint32_t worker_index)
+    {
+        t_worker_index = worker_index;
+        MERCURY_PROFILE_THREAD("Job Worker");
+        while (true)
+        {
+            Job job;
+            if (tryGetJob(worker_index, job))
+            {
+                execute(job);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleep_mutex);
+            m_sleep_condition.wait(lock, [this] { return m_is_stopping || m_queued_job_count.load(std::memory_order_acquire) > 0; });
+            if (m_is_stopping && m_queued_job_count.load(std::memory_order_acquire) == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    void JobSystem::enqueue(Job&& job)
+    {
+        if (job.affinity == JobAffinity::main_thread)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_main_thread_queue.mutex);
+                m_main_thread_queue.jobs.push_back(std::move(job));
+            }
+            // 主线程可能正在wait中休眠
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            notifyWaitingThreads();
+            return;
+        }
+
+        // worker线程放入自己的队列，其他线程（例如资源加载线程）轮流放入各个队列
+        uint32_t queue_index = t_worker_index;
+        if (queue_index >= m_queues.size())
+        {
+            queue_index = m_next_queue_index.fetch_add(1, std::memory_order_relaxed) % static_cast<uint32_t>(m_queues.size());
+        }
+        // 先计数再入队，计数只会短暂偏大，不会因为job被立即取走而下溢
+        m_queued_job_count.fetch_add(1, std::memory_order_release);
+        {
+            WorkerQueue& queue = *m_queues[queue_index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(std::move(job));
+        }
+
+        // 先拿一次休眠锁，避免工作线程在检查条件和进入等待之间错过通知
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            notifyWaitingThreads();
+        }
+        m_sleep_condition.notify_one();
+    }
+
+    bool JobSystem::tryGetJob(uint32_t worker_index, Job& job)
+    {
+        uint32_t queue_count = static_cast<uint32_t>(m_queues.size());
+        if (worker_index < queue_count)
+        {
+            WorkerQueue& queue = *m_queues[worker_index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                job = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+                m_queued_job_count.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // 从下一个队列开始窃取，避免所有空闲线程都去抢同一个队列
+        uint32_t start_index = worker_index < queue_count ? worker_index + 1 : 0;
+        for (uint32_t i = 0; i < queue_count; ++i)
+        {
+            uint32_t victim_index = (start_index + i) % queue_count;
+            if (victim_index == worker_index)
+            {
+                continue;
+            }
+            WorkerQueue& queue = *m_queues[victim_index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                job = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+                m_queued_job_count.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool JobSystem::tryRunMainThreadJob()
+    {
+        Job job;
+        {
+            std::lock_guard<std::mutex> lock(m_main_thread_queue.mutex);
+            if (m_main_thread_queue.jobs.empty())
+            {
+                return false;
+            }
+            job = std::move(m_main_thread_queue.jobs.front());
+            m_main_thread_queue.jobs.pop_front();
+        }
+        execute(job);
+        return true;
+    }
+
+    bool JobSystem::hasMainThreadJob()
+    {
+        std::lock_guard<std::mutex> lock(m_main_thread_queue.mutex);
+        return !m_main_thread_queue.jobs.empty();
+    }
+
+    void JobSystem::notifyWaitingThreads()
+    {
+        if (m_waiting_thread_count > 0)
+        {
+            m_wait_condition.notify_all();
+        }
+    }
+
+    void JobSystem::execute(Job& job)
+    {
+        {
+            MERCURY_PROFILE_SCOPE("Job");
+            job.function();
+        }
+        if (job.counter != nullptr)
+        {
+            finishJob(*job.counter);
+        }
+    }
+
+    void JobSystem::finishJob(JobCounter& counter)
+    {
+        std::vector<Job> continuations;
+        {
+            // 持锁递减，与runAfter的检查互斥；解锁之后counter可能被等待方销毁，不能再访问
+            std::lock_guard<std::mutex> lock(counter.m_mutex);
+            if (counter.m_value.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            {
+                return;
+            }
+            continuations.swap(counter.m_continuations);
+        }
+        for (Job& continuation : continuations)
+        {
+            enqueue(std::move(continuation));
+        }
+        // 计数已经在上面归零，等待的线程在休眠锁下检查条件，拿锁之后再通知不会丢失唤醒
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        notifyWaitingThreads();
+    }
+} // namespace Mercury
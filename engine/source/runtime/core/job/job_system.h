@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Mercury
+{
+    class JobCounter;
+
+    // 有些工作只能在主线程执行（例如GLFW的大部分函数），这类job只会被主线程取走
+    enum class JobAffinity : uint8_t
+    {
+        any,
+        main_thread,
+    };
+
+    struct Job
+    {
+        std::function<void()> function;
+        JobCounter* counter{ nullptr }; // job执行完后递减，可为空
+        JobAffinity affinity{ JobAffinity::any };
+    };
+
+    /*
+    * 一组job的完成计数：提交时加1，执行完减1，归零表示这一组job全部完成。
+    * 依赖通过JobSystem::runAfter表达：挂在计数器上的后续job在计数归零时才会被放入队列，等待的线程不会被占用。
+    * 计数器必须在所有关联的job执行完之前保持有效。
+    */
+    class JobCounter
+    {
+    public:
+        bool isDone() const { return m_value.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> m_value{ 0 };
+        std::mutex m_mutex;
+        std::vector<Job> m_continuations;
+    };
+
+    /*
+    * work-stealing的任务系统：主线程和每个工作线程各有一个双端队列，
+    * 线程从自己队列的尾部存取job（后进先出，缓存友好），空闲时从其他线程队列的头部窃取（先进先出，窃取的通常是较大的任务）。
+    * 主线程也是一个worker（下标0），在wait中会执行job而不是空等。
+    * https://www.gdcvault.com/play/1022186/Parallelizing-the-Naughty-Dog-Engine
+    */
+    class JobSystem
+    {
+    public:
+        static constexpr uint32_t k_main_thread_index = 0;
+
+        // 必须在主线程调用，worker_count为0时按核心数创建工作线程（不含主线程）
+        void initialize(uint32_t worker_count = 0);
+        // 已提交的job会在工作线程退出前执行完
+        void clear();
+
+        void run(std::function<void()> function, JobCounter* counter = nullptr, JobAffinity affinity = JobAffinity::any);
+        // dependency归零后再把job放入队列
+        void runAfter(JobCounter& dependency, std::function<void()> function, JobCounter* counter = nullptr, JobAffinity affinity = JobAffinity::any);
+        // 把[0, count)按batch_size切分成多个job并等待全部完成，function的参数为[begin, end)
+        void parallelFor(uint32_t count, uint32_t batch_size, const std::function<void(uint32_t, uint32_t)>& function);
+        // 等待期间当前线程会执行其他job；在主线程上等待时也会执行主线程job。
+        // 没有可执行的job时休眠，直到counter归零或有新的job入队
+        void wait(JobCounter& counter);
+        // 每帧在主线程调用一次，执行所有只能在主线程执行的job
+        void processMainThreadJobs();
+
+        // 包括主线程
+        uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_queues.size()); }
+        bool isMainThread() const;
+        // 当前线程的worker下标（主线程为0），可用于索引每个线程独占的资源，例如录制命令用的command pool；
+        // 不属于任务系统的线程返回getWorkerCount()之外的值
+        static uint32_t getCurrentWorkerIndex();
+
+    private:
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+
+        void workerLoop(uint32_t worker_index);
+        void enqueue(Job&& job);
+        bool tryGetJob(uint32_t worker_index, Job& job);
+        bool tryRunMainThreadJob();
+        bool hasMainThreadJob();
+        // 需要持有m_sleep_mutex
+        void notifyWaitingThreads();
+        void execute(Job& job);
+        void finishJob(JobCounter& counter);
+
+        std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+        std::vector<std::thread> m_workers;
+        WorkerQueue m_main_thread_queue;
+        std::thread::id m_main_thread_id;
+        std::atomic<uint32_t> m_next_queue_index{ 0 };
+
+        // 队列中可被任意线程执行的job数量，工作线程在没有job时休眠
+        std::atomic<uint32_t> m_queued_job_count{ 0 };
+        std::mutex m_sleep_mutex;
+        std::condition_variable m_sleep_condition;
+        bool m_is_stopping{ false };
+        // 在wait中休眠的线程，counter归零或有新job时唤醒；与工作线程分开，避免每个counter归零都唤醒所有工作线程
+        std::condition_variable m_wait_condition;
+        uint32_t m_waiting_thread_count{ 0 };
+    };
+} // namespace Mercury
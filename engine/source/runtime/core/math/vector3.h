@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cmath>
+
+namespace Mercury
+{
+    // 紧凑的三维向量，内存布局与GLSL的vec3（无padding的顶点属性）一致，可以直接拷贝到顶点缓冲区
+    struct Vector3
+    {
+        float x{ 0.f };
+        float y{ 0.f };
+        float z{ 0.f };
+
+        Vector3() = default;
+        Vector3(float x_, float y_, float z_) : x(x_), y(y_), z(z_) {}
+
+        Vector3 operator+(const Vector3& rhs) const { return Vector3(x + rhs.x, y + rhs.y, z + rhs.z); }
+        Vector3 operator-(const Vector3& rhs) const { return Vector3(x - rhs.x, y - rhs.y, z - rhs.z); }
+        Vector3 operator*(float scalar) const { return Vector3(x * scalar, y * scalar, z * scalar); }
+        Vector3 operator-() const { return Vector3(-x, -y, -z); }
+
+        Vector3& operator+=(const Vector3& rhs)
+        {
+            x += rhs.x;
+            y += rhs.y;
+            z += rhs.z;
+            return *this;
+        }
+
+        float dotProduct(const Vector3& rhs) const { return x * rhs.x + y * rhs.y + z * rhs.z; }
+
+        Vector3 crossProduct(const Vector3& rhs) const
+        {
+            return Vector3(y * rhs.z - z * rhs.y, z * rhs.x - x * rhs.z, x * rhs.y - y * rhs.x);
+        }
+
+        float length() const { return std::sqrt(dotProduct(*this)); }
+
+        Vector3 normalisedCopy() const
+        {
+            float len = length();
+            return len > 0.f ? *this * (1.f / len) : *this;
+        }
+    };
+
+    static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3 must be tightly packed");
+} // namespace Mercury
@@ -1,18 +1,39 @@
 #include "runtime/engine.h"
 
+#include <array>
+#include <iostream>
+
 #include "runtime/function/global/global_context.h"
+#include "runtime/core/base/profiler.h"
 #include "engine.h"
 
 namespace Mercury
 {
-    void MercuryEngine::startEngine(const std::string& config_file_path) {
-        g_runtime_global_context.startSystems(config_file_path);
-
+    void MercuryEngine::startEngine(const EngineStartInfo& start_info) {
+        m_max_frame_count = start_info.frame_count;
+        m_profile_output_path = start_info.profile_output_path;
+        m_frame_pacer.setTargetFPS(start_info.target_fps);
+        MERCURY_PROFILE_THREAD("Main Thread");
+        if (!m_profile_output_path.empty())
+        {
+            Profiler::beginCapture();
+        }
+        g_runtime_global_context.startSystems(start_info);
+        // 逻辑线程读写render system的swap context，需要在各个系统创建之后启动
+        setLogicThreadEnabled(start_info.is_logic_thread_enabled);
     }
 
 
     void MercuryEngine::shutdownEngine() {
+        setLogicThreadEnabled(false);
+        // headless模式没有窗口标题，退出时输出一行汇总
+        std::cout << "frames: " << m_frame_count << ", average fps: " << getFPS()
+            << ", input to present latency: " << g_runtime_global_context.m_render_system->getInputToPresentLatency() * 1000.f << " ms" << std::endl;
         g_runtime_global_context.shutdownSystems();
+        if (!m_profile_output_path.empty())
+        {
+            Profiler::exportChromeTrace(m_profile_output_path);
+        }
     }
 
 
@@ -32,15 +53,46 @@ namespace Mercury
 
     bool MercuryEngine::tickOneFrame(float delta_time)
     {
+        MERCURY_PROFILE_SCOPE("MercuryEngine::tickOneFrame");
         calculateFPS(delta_time);
 
-        rendererTick(delta_time);
-    
+        if (isLogicThreadEnabled())
+        {
+            // 逻辑线程计算第N帧的同时，主线程渲染第N-1帧发布的快照；
+            // 渲染留在主线程上，因为交换链重建需要调用只能在主线程使用的GLFW函数
+            kickLogicFrame(delta_time);
+            rendererTick(delta_time);
+        }
+        else
+        {
+            logicalTick(delta_time);
+            rendererTick(delta_time);
+        }
+
+        // 其他线程提交的、只能在主线程执行的job（例如GLFW调用）
+        g_runtime_global_context.m_job_system->processMainThreadJobs();
         g_runtime_global_context.m_window_system->pollEvents();
+        // 下一帧的逻辑使用这次采样的输入
+        m_frame_pacer.markInputSampled();
+        // 输入到present的延迟与FPS一起显示，开启逻辑线程或增加帧并发数时可以直接看到延迟的变化
+        const int latency_ms = static_cast<int>(g_runtime_global_context.m_render_system->getInputToPresentLatency() * 1000.f + 0.5f);
         g_runtime_global_context.m_window_system->setTitle(
-            std::string("Mercury - " + std::to_string(getFPS()) + " FPS").c_str()
+            std::string("Mercury - " + std::to_string(getFPS()) + " FPS - " + std::to_string(latency_ms) + " ms latency").c_str()
         );
+        if (m_max_frame_count != 0 && static_cast<uint32_t>(m_frame_count) >= m_max_frame_count)
+        {
+            g_runtime_global_context.m_window_system->requestClose();
+        }
         const bool should_window_close = g_runtime_global_context.m_window_system->shouldClose();
+
+        // 逻辑线程最多领先渲染一帧
+        if (isLogicThreadEnabled())
+        {
+            waitLogicFrame();
+        }
+
+        // 设置了目标帧率时在这里等待，之后下一帧的calculateDeltaTime会包含等待的时间
+        m_frame_pacer.waitForNextFrame();
         return !should_window_close;
     }
 
@@ -77,6 +129,115 @@ namespace Mercury
     }
 
 
+    bool MercuryEngine::logicalTick(float delta_time) {
+        MERCURY_PROFILE_SCOPE("MercuryEngine::logicalTick");
+        // 开启逻辑线程时这里与渲染并行执行，只能读写逻辑侧的数据，交给渲染侧的内容写入swap data
+        RenderSwapContext& swap_context = g_runtime_global_context.m_render_system->getSwapContext();
+        RenderSwapData& swap_data = swap_context.getLogicSwapData();
+        swap_data.delta_time = delta_time;
+        swap_data.input_sample_time = m_frame_pacer.getLastInputSampleTime();
+
+        std::array<int, 2> window_size = g_runtime_global_context.m_window_system->getWindowSize();
+        if (window_size[0] > 0 && window_size[1] > 0)
+        {
+            m_camera.setAspectRatio(static_cast<float>(window_size[0]) / static_cast<float>(window_size[1]));
+        }
+        m_camera.tick(delta_time);
+        m_camera.getProjViewMatrix(swap_data.proj_view_matrix);
+        swap_data.has_proj_view_matrix = true;
+
+        drawReferenceGrid();
+
+        swap_context.publishLogicSwapData();
+        return true;
+    }
+
+    // 地面网格和坐标轴，通过逻辑线程自己的debug draw context提交
+    void MercuryEngine::drawReferenceGrid() {
+        MERCURY_PROFILE_SCOPE("MercuryEngine::drawReferenceGrid");
+        DebugDrawContext* context = g_runtime_global_context.m_debugdraw_manager->getDebugDrawContext();
+
+        const int half_line_count = 10;
+        const float extent = static_cast<float>(half_line_count);
+        std::array<Vector3, (half_line_count * 2 + 1) * 4> points;
+        uint32_t point_count = 0;
+        for (int i = -half_line_count; i <= half_line_count; ++i)
+        {
+            const float offset = static_cast<float>(i);
+            points[point_count++] = Vector3(offset, 0.f, -extent);
+            points[point_count++] = Vector3(offset, 0.f, extent);
+            points[point_count++] = Vector3(-extent, 0.f, offset);
+            points[point_count++] = Vector3(extent, 0.f, offset);
+        }
+        context->addLines(points.data(), point_count, DebugDrawColor{ 0.4f, 0.4f, 0.4f, 1.f });
+
+        context->addArrow(Vector3(0.f, 0.f, 0.f), Vector3(2.f, 0.f, 0.f), DebugDrawColor{ 1.f, 0.f, 0.f, 1.f });
+        context->addArrow(Vector3(0.f, 0.f, 0.f), Vector3(0.f, 2.f, 0.f), DebugDrawColor{ 0.f, 1.f, 0.f, 1.f });
+        context->addArrow(Vector3(0.f, 0.f, 0.f), Vector3(0.f, 0.f, 2.f), DebugDrawColor{ 0.f, 0.f, 1.f, 1.f });
+    }
+
+    void MercuryEngine::setLogicThreadEnabled(bool enable) {
+        if (enable == isLogicThreadEnabled())
+        {
+            return;
+        }
+
+        if (enable)
+        {
+            m_is_logic_thread_stopping = false;
+            m_is_logic_frame_pending = false;
+            m_logic_thread = std::thread(&MercuryEngine::logicThreadLoop, this);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_logic_mutex);
+            m_is_logic_thread_stopping = true;
+        }
+        m_logic_condition.notify_all();
+        m_logic_thread.join();
+    }
+
+    void MercuryEngine::logicThreadLoop() {
+        MERCURY_PROFILE_THREAD("Logic Thread");
+        while (true)
+        {
+            float delta_time;
+            {
+                std::unique_lock<std::mutex> lock(m_logic_mutex);
+                m_logic_condition.wait(lock, [this] { return m_is_logic_thread_stopping || m_is_logic_frame_pending; });
+                if (m_is_logic_thread_stopping)
+                {
+                    return;
+                }
+                delta_time = m_logic_delta_time;
+            }
+
+            logicalTick(delta_time);
+
+            {
+                std::lock_guard<std::mutex> lock(m_logic_mutex);
+                m_is_logic_frame_pending = false;
+            }
+            m_logic_condition.notify_all();
+        }
+    }
+
+    void MercuryEngine::kickLogicFrame(float delta_time) {
+        {
+            std::lock_guard<std::mutex> lock(m_logic_mutex);
+            m_logic_delta_time = delta_time;
+            m_is_logic_frame_pending = true;
+        }
+        m_logic_condition.notify_all();
+    }
+
+    void MercuryEngine::waitLogicFrame() {
+        MERCURY_PROFILE_SCOPE("MercuryEngine::waitLogicFrame");
+        std::unique_lock<std::mutex> lock(m_logic_mutex);
+        m_logic_condition.wait(lock, [this] { return !m_is_logic_frame_pending; });
+    }
+
     bool MercuryEngine::rendererTick(float delta_time) {
         g_runtime_global_context.m_render_system->tick(delta_time);
         return true;
@@ -3,15 +3,44 @@
 #include <filesystem>
 #include <string>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "runtime/core/base/frame_pacer.h"
+#include "runtime/function/render/render_camera.h"
 
 namespace Mercury
 {
+    struct EngineStartInfo
+    {
+        std::string config_file_path;
+        // 不创建窗口，渲染到离屏图像，用于没有显示设备的机器上的性能与回归测试
+        bool is_headless{ false };
+        // 运行的帧数，0表示一直运行到窗口关闭；headless时通常需要设置
+        uint32_t frame_count{ 0 };
+        // 非空时把每帧画面保存到该目录（仅headless）
+        std::filesystem::path frame_capture_dir;
+        // 非空时从启动开始采集CPU分析数据，退出时导出为Chrome trace JSON
+        std::filesystem::path profile_output_path;
+        // 逻辑在独立线程上执行，与上一帧的渲染并行
+        bool is_logic_thread_enabled{ false };
+        // 最高帧率，<= 0表示不限帧
+        float target_fps{ 0.f };
+        // "fifo"、"mailbox"、"immediate"或"fifo_relaxed"，为空时使用RHI的默认值
+        std::string present_mode;
+        // 同时处理的帧数，0表示使用RHI的默认值
+        uint32_t frames_in_flight{ 0 };
+        // 非0时在第一帧的debug draw pass中额外录制N组viewport/scissor/draw，输出每条命令的平均录制耗时
+        uint32_t command_benchmark_count{ 0 };
+    };
+
     class MercuryEngine
     {
         friend class MercuryEditor; // 使得编辑器MercuryEditor类可以访问引擎MercuryEngine的私有和保护成员
         static const float s_fps_alpha;
     public:
-        void startEngine(const std::string& config_file_path);
+        void startEngine(const EngineStartInfo& start_info);
         void shutdownEngine();
 
         void initialize();
@@ -21,6 +50,13 @@ namespace Mercury
         bool tickOneFrame(float delta_time);
         int getFPS() const { return m_fps; }
 
+        // 开启后逻辑在独立线程上执行，第N帧的逻辑与第N-1帧的渲染并行；需要在主线程调用
+        void setLogicThreadEnabled(bool enable);
+        bool isLogicThreadEnabled() const { return m_logic_thread.joinable(); }
+
+        // 限帧、输入采样时刻
+        FramePacer& getFramePacer() { return m_frame_pacer; }
+
     protected:
         float calculateDeltaTime();
         void calculateFPS(float delta_time);
@@ -28,10 +64,30 @@ namespace Mercury
     protected:
         int m_fps{ 0 };
         int m_frame_count{ 0 };
+        uint32_t m_max_frame_count{ 0 };
+        std::filesystem::path m_profile_output_path;
         float m_average_duration{ 0.f };
         std::chrono::steady_clock::time_point m_last_tick_time_point{ std::chrono::steady_clock::now() };
+        FramePacer m_frame_pacer;
 
+        bool logicalTick(float delta_time);
+        void drawReferenceGrid();
         bool rendererTick(float delta_time);
+
+        void logicThreadLoop();
+        void kickLogicFrame(float delta_time);
+        void waitLogicFrame();
+
+        // 逻辑线程：每帧由主线程唤醒一次，执行完后通知主线程
+        std::thread m_logic_thread;
+        std::mutex m_logic_mutex;
+        std::condition_variable m_logic_condition;
+        bool m_is_logic_frame_pending{ false };
+        bool m_is_logic_thread_stopping{ false };
+        float m_logic_delta_time{ 0.f };
+
+        // 逻辑侧状态，只在logicalTick中读写，渲染侧通过swap data拿到结果
+        RenderCamera m_camera;
     };
 
 
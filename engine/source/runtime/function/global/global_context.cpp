@@ -1,26 +1,98 @@
 #include "runtime/function/global/global_context.h"
+#include "runtime/engine.h"
 #include "runtime/function/render/window_system.h"
 #include "runtime/function/render/render_system.h"
+#include "runtime/function/render/interface/rhi.h"
+
+#include <algorithm>
+#include <iostream>
 
 namespace Mercury
 {
     RuntimeGlobalContext g_runtime_global_context;
-    void RuntimeGlobalContext::startSystems(const std::string& config_file_path) {
+
+    namespace
+    {
+        bool parsePresentMode(const std::string& name, RHIPresentModeKHR& present_mode)
+        {
+            if (name == "fifo")
+            {
+                present_mode = RHI_PRESENT_MODE_FIFO_KHR;
+            }
+            else if (name == "mailbox")
+            {
+                present_mode = RHI_PRESENT_MODE_MAILBOX_KHR;
+            }
+            else if (name == "immediate")
+            {
+                present_mode = RHI_PRESENT_MODE_IMMEDIATE_KHR;
+            }
+            else if (name == "fifo_relaxed")
+            {
+                present_mode = RHI_PRESENT_MODE_FIFO_RELAXED_KHR;
+            }
+            else
+            {
+                return false;
+            }
+            return true;
+        }
+    } // namespace
+
+    void RuntimeGlobalContext::startSystems(const EngineStartInfo& start_info) {
+        // 任务系统最先创建，调用startSystems的线程即为主线程
+        m_job_system = std::make_shared<JobSystem>();
+        m_job_system->initialize();
+
         // 初始化窗口系统
         m_window_system = std::make_shared<WindowSystem>();
         WindowCreateInfo window_create_info;
+        window_create_info.is_headless = start_info.is_headless;
         m_window_system->initialize(window_create_info);
 
         // 初始化渲染系统
         m_render_system = std::make_shared<RenderSystem>();
         RenderSystemInitInfo render_init_info;
         render_init_info.window_system = m_window_system;
+        render_init_info.pipeline_cache_path = std::filesystem::path(start_info.config_file_path) / "pipeline_cache.bin";
+        render_init_info.frame_capture_dir = start_info.frame_capture_dir;
         m_render_system->initialize(render_init_info);
 
+        // 启动参数中的帧节奏设置，在第一帧之前生效
+        std::shared_ptr<RHI> rhi = m_render_system->getRHI();
+        if (!start_info.present_mode.empty())
+        {
+            RHIPresentModeKHR present_mode;
+            if (parsePresentMode(start_info.present_mode, present_mode))
+            {
+                rhi->setPresentMode(present_mode);
+            }
+            else
+            {
+                std::cout << "unknown present mode " << start_info.present_mode << ", ignored" << std::endl;
+            }
+        }
+        if (start_info.frames_in_flight != 0)
+        {
+            rhi->setFramesInFlight(static_cast<uint8_t>(std::min<uint32_t>(start_info.frames_in_flight, 255)));
+        }
+
         // 初始化debug绘制
         m_debugdraw_manager = std::make_shared<DebugDrawManager>();
         m_debugdraw_manager->initialize();
+        m_debugdraw_manager->setCommandBenchmarkCount(start_info.command_benchmark_count);
     }
 
-    void RuntimeGlobalContext::shutdownSystems() {}
+    void RuntimeGlobalContext::shutdownSystems() {
+        // 先执行完所有在途的job，它们可能引用下面要销毁的系统
+        m_job_system->clear();
+
+        m_debugdraw_manager.reset();
+
+        m_render_system->clear();
+        m_render_system.reset();
+
+        m_window_system.reset();
+        m_job_system.reset();
+    }
 } // namespace Mercury
@@ -3,22 +3,26 @@
 #include <memory>
 #include <string>
 
+#include "runtime/core/job/job_system.h"
 #include "runtime/function/render/window_system.h"
 #include "runtime/function/render/render_system.h"
 #include "runtime/function/render/debugdraw/debug_draw_manager.h"
 
 namespace Mercury
 {
+    struct EngineStartInfo;
+
     // 管理所有全局系统的生命周期以及创造/销毁顺序
     class RuntimeGlobalContext
     {
     public:
         // create all global systems and initialize these systems
-        void startSystems(const std::string& config_file_path);
+        void startSystems(const EngineStartInfo& start_info);
         // destroy all global systems
         void shutdownSystems();
     
     public:
+        std::shared_ptr<JobSystem> m_job_system;
         std::shared_ptr<WindowSystem> m_window_system;
         std::shared_ptr<RenderSystem> m_render_system;
         std::shared_ptr<DebugDrawManager> m_debugdraw_manager ;
@@ -0,0 +1,224 @@
+#include "runtime/function/render/debugdraw/debug_draw_context.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace Mercury
+{
+    void DebugDrawChunkList::append(const Vector3* positions, uint32_t vertex_count, uint32_t color)
+    {
+        while (vertex_count > 0)
+        {
+            if (m_used_chunk_count == 0 || m_chunks[m_used_chunk_count - 1]->vertex_count == DebugDrawVertexChunk::k_capacity)
+            {
+                if (m_used_chunk_count == m_chunks.size())
+                {
+                    m_chunks.push_back(std::make_unique<DebugDrawVertexChunk>());
+                }
+                m_chunks[m_used_chunk_count]->vertex_count = 0;
+                ++m_used_chunk_count;
+            }
+
+            DebugDrawVertexChunk& chunk = *m_chunks[m_used_chunk_count - 1];
+            uint32_t copy_count = std::min(vertex_count, DebugDrawVertexChunk::k_capacity - chunk.vertex_count);
+            std::copy(positions, positions + copy_count, chunk.positions + chunk.vertex_count);
+            std::fill(chunk.colors + chunk.vertex_count, chunk.colors + chunk.vertex_count + copy_count, color);
+            chunk.vertex_count += copy_count;
+            positions += copy_count;
+            vertex_count -= copy_count;
+        }
+    }
+
+    void DebugDrawChunkList::reset()
+    {
+        m_used_chunk_count = 0;
+    }
+
+    void DebugDrawChunkList::appendTo(DebugDrawPipelineType pipeline_type, DebugDrawGroup& group) const
+    {
+        for (uint32_t i = 0; i < m_used_chunk_count; ++i)
+        {
+            const DebugDrawVertexChunk& chunk = *m_chunks[i];
+            group.append(pipeline_type, chunk.positions, chunk.colors, chunk.vertex_count);
+        }
+    }
+
+    void DebugDrawFrameData::reset()
+    {
+        for (DebugDrawChunkList& chunk_list : chunk_lists)
+        {
+            chunk_list.reset();
+        }
+        for (std::vector<DebugDrawShapeInstance>& instances : shape_instances)
+        {
+            instances.clear();
+        }
+        timed_group.clear();
+    }
+
+    namespace
+    {
+        // 取两个与axis正交的单位向量，与axis一起组成右手坐标系(axis_x, axis, axis_z)
+        void getOrthonormalBasis(const Vector3& axis, Vector3& axis_x, Vector3& axis_z)
+        {
+            Vector3 reference = std::fabs(axis.x) < 0.9f ? Vector3(1.f, 0.f, 0.f) : Vector3(0.f, 0.f, 1.f);
+            axis_z = reference.crossProduct(axis).normalisedCopy();
+            axis_x = axis.crossProduct(axis_z);
+        }
+    } // namespace
+
+    double DebugDrawContext::getCurrentTime()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    DebugDrawPipelineType DebugDrawContext::getPipelineType(DebugDrawPipelineType depth_test_type, bool no_depth_test)
+    {
+        // 枚举中no_depth_test的变体与对应的深度测试变体相差3
+        return no_depth_test ? (DebugDrawPipelineType)(depth_test_type + _debug_draw_pipeline_type_point_no_depth_test) : depth_test_type;
+    }
+
+    void DebugDrawContext::appendVertices(DebugDrawPipelineType pipeline_type, const Vector3* positions, uint32_t vertex_count, const DebugDrawColor& color, float duration)
+    {
+        uint32_t packed_color = color.pack();
+        double expire_time = duration > 0.f ? getCurrentTime() + duration : 0.0;
+
+        // 与acquireFrameData配对：先标记正在写入再读取帧序号（都是seq_cst），
+        // 渲染线程要么看到写入标记并等待，要么本次写入读到的是已经递增后的帧序号
+        m_is_writing.store(true, std::memory_order_seq_cst);
+        DebugDrawFrameData& frame_data = m_frame_data[m_frame_epoch->load(std::memory_order_seq_cst) & 1];
+        if (duration > 0.f)
+        {
+            frame_data.timed_group.append(pipeline_type, positions, vertex_count, packed_color, expire_time);
+        }
+        else
+        {
+            frame_data.chunk_lists[pipeline_type].append(positions, vertex_count, packed_color);
+        }
+        m_is_writing.store(false, std::memory_order_release);
+    }
+
+    void DebugDrawContext::appendShape(DebugDrawShapeType shape_type, const Vector3& axis_x, const Vector3& axis_y, const Vector3& axis_z, const Vector3& origin,
+        float cap_offset, const DebugDrawColor& color, bool no_depth_test, float duration)
+    {
+        // 行主序的3x4矩阵，每一列依次是三个局部坐标轴和原点
+        DebugDrawShapeInstance instance;
+        const Vector3* columns[4] = { &axis_x, &axis_y, &axis_z, &origin };
+        for (uint32_t column = 0; column < 4; ++column)
+        {
+            instance.transform_rows[0][column] = columns[column]->x;
+            instance.transform_rows[1][column] = columns[column]->y;
+            instance.transform_rows[2][column] = columns[column]->z;
+        }
+        instance.cap_offset = cap_offset;
+        instance.color = color.pack();
+        uint32_t shape_batch = getDebugDrawShapeBatch(shape_type, no_depth_test);
+        double expire_time = duration > 0.f ? getCurrentTime() + duration : 0.0;
+
+        m_is_writing.store(true, std::memory_order_seq_cst);
+        DebugDrawFrameData& frame_data = m_frame_data[m_frame_epoch->load(std::memory_order_seq_cst) & 1];
+        if (duration > 0.f)
+        {
+            frame_data.timed_group.appendInstance(shape_batch, instance, expire_time);
+        }
+        else
+        {
+            frame_data.shape_instances[shape_batch].push_back(instance);
+        }
+        m_is_writing.store(false, std::memory_order_release);
+    }
+
+    DebugDrawFrameData& DebugDrawContext::acquireFrameData(uint32_t previous_epoch)
+    {
+        // 写入只是几次memcpy，等待时间很短
+        while (m_is_writing.load(std::memory_order_seq_cst))
+        {
+            std::this_thread::yield();
+        }
+        return m_frame_data[previous_epoch & 1];
+    }
+
+    void DebugDrawContext::addPoint(const Vector3& position, const DebugDrawColor& color, bool no_depth_test, float duration)
+    {
+        appendVertices(getPipelineType(_debug_draw_pipeline_type_point, no_depth_test), &position, 1, color, duration);
+    }
+
+    void DebugDrawContext::addLine(const Vector3& from, const Vector3& to, const DebugDrawColor& color, bool no_depth_test, float duration)
+    {
+        Vector3 points[2] = { from, to };
+        appendVertices(getPipelineType(_debug_draw_pipeline_type_line, no_depth_test), points, 2, color, duration);
+    }
+
+    void DebugDrawContext::addLines(const Vector3* points, uint32_t point_count, const DebugDrawColor& color, bool no_depth_test, float duration)
+    {
+        // 不成对的最后一个点被忽略
+        appendVertices(getPipelineType(_debug_draw_pipeline_type_line, no_depth_test), points, point_count & ~1u, color, duration);
+    }
+
+    void DebugDrawContext::addTriangle(const Vector3& point0, const Vector3& point1, const Vector3& point2, const DebugDrawColor& color, bool no_depth_test, float duration)
+    {
+        Vector3 points[3] = { point0, point1, point2 };
+        appendVertices(getPipelineType(_debug_draw_pipeline_type_triangle, no_depth_test), points, 3, color, duration);
+    }
+
+    void DebugDrawContext::addBox(const Vector3& center, const Vector3& half_extents, const DebugDrawColor& color, bool no_depth_test, float duration)
+    {
+        appendShape(_debug_draw_shape_type_box, Vector3(half_extents.x, 0.f, 0.f), Vector3(0.f, half_extents.y, 0.f), Vector3(0.f, 0.f, half_extents.z),
+            center, 0.f, color, no_depth_test, duration);
+    }
+
+    void DebugDrawContext::addSphere(const Vector3& center, float radius, const DebugDrawColor& color, bool no_depth_test, float duration)
+    {
+        appendShape(_debug_draw_shape_type_sphere, Vector3(radius, 0.f, 0.f), Vector3(0.f, radius, 0.f), Vector3(0.f, 0.f, radius),
+            center, 0.f, color, no_depth_test, duration);
+    }
+
+    void DebugDrawContext::addCapsule(const Vector3& point0, const Vector3& point1, float radius, const DebugDrawColor& color, bool no_depth_test, float duration)
+    {
+        if (radius <= 0.f)
+        {
+            return;
+        }
+        Vector3 axis = point1 - point0;
+        float half_length = axis.length() * 0.5f;
+        Vector3 axis_y = half_length > 0.f ? axis * (0.5f / half_length) : Vector3(0.f, 1.f, 0.f);
+        Vector3 axis_x, axis_z;
+        getOrthonormalBasis(axis_y, axis_x, axis_z);
+
+        // 单位网格半径为1，整体按radius缩放，因此半球的偏移也要换算到局部单位
+        appendShape(_debug_draw_shape_type_capsule, axis_x * radius, axis_y * radius, axis_z * radius,
+            (point0 + point1) * 0.5f, half_length / radius, color, no_depth_test, duration);
+    }
+
+    void DebugDrawContext::addArrow(const Vector3& from, const Vector3& to, const DebugDrawColor& color, bool no_depth_test, float duration)
+    {
+        Vector3 axis = to - from;
+        float length = axis.length();
+        if (length <= 0.f)
+        {
+            return;
+        }
+        Vector3 axis_x, axis_z;
+        getOrthonormalBasis(axis * (1.f / length), axis_x, axis_z);
+        appendShape(_debug_draw_shape_type_arrow, axis_x * length, axis, axis_z * length, from, 0.f, color, no_depth_test, duration);
+    }
+
+    void DebugDrawContext::addFrustum(const Vector3 corners[8], const DebugDrawColor& color, bool no_depth_test, float duration)
+    {
+        Vector3 points[24];
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            uint32_t next = (i + 1) % 4;
+            // 近平面、远平面的边以及连接两者的侧棱
+            points[i * 6 + 0] = corners[i];
+            points[i * 6 + 1] = corners[next];
+            points[i * 6 + 2] = corners[i + 4];
+            points[i * 6 + 3] = corners[next + 4];
+            points[i * 6 + 4] = corners[i];
+            points[i * 6 + 5] = corners[i + 4];
+        }
+        addLines(points, 24, color, no_depth_test, duration);
+    }
+} // namespace Mercury
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "runtime/function/render/debugdraw/debug_draw_group.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Mercury
+{
+    // 固定容量的顶点块，写满后追加新块，已有数据不会因为扩容被搬移
+    struct DebugDrawVertexChunk
+    {
+        static constexpr uint32_t k_capacity = 4096;
+
+        uint32_t vertex_count{ 0 };
+        Vector3 positions[k_capacity];
+        uint32_t colors[k_capacity];
+    };
+
+    class DebugDrawChunkList
+    {
+    public:
+        void append(const Vector3* positions, uint32_t vertex_count, uint32_t color);
+        // 只清零计数，已分配的块留给下一次使用
+        void reset();
+        void appendTo(DebugDrawPipelineType pipeline_type, DebugDrawGroup& group) const;
+
+    private:
+        std::vector<std::unique_ptr<DebugDrawVertexChunk>> m_chunks;
+        uint32_t m_used_chunk_count{ 0 };
+    };
+
+    // 一个生产者在一帧内提交的全部图元
+    struct DebugDrawFrameData
+    {
+        DebugDrawChunkList chunk_lists[k_debug_draw_vertex_stream_count];
+        std::vector<DebugDrawShapeInstance> shape_instances[k_debug_draw_shape_batch_count];
+        DebugDrawTimedGroup timed_group;
+
+        void reset();
+    };
+
+    /*
+    * 每个提交debug图元的线程拥有一个DebugDrawContext（通过DebugDrawManager::getDebugDrawContext获取），
+    * 图元写入本线程的块链表，热路径上没有锁。
+    * 上下文内有两份帧数据，按帧序号的奇偶交替写入：渲染线程在帧边界递增帧序号，
+    * 等待生产者完成正在进行的那一次写入后，读取并重置上一帧的那一份。
+    * duration大于0的图元会持续绘制duration秒。
+    */
+    class DebugDrawContext
+    {
+    public:
+        explicit DebugDrawContext(const std::atomic<uint32_t>* frame_epoch) : m_frame_epoch(frame_epoch) {}
+
+        void addPoint(const Vector3& position, const DebugDrawColor& color, bool no_depth_test = false, float duration = 0.f);
+        void addLine(const Vector3& from, const Vector3& to, const DebugDrawColor& color, bool no_depth_test = false, float duration = 0.f);
+        // points中每两个点组成一条线段，用于批量提交大量线段
+        void addLines(const Vector3* points, uint32_t point_count, const DebugDrawColor& color, bool no_depth_test = false, float duration = 0.f);
+        void addTriangle(const Vector3& point0, const Vector3& point1, const Vector3& point2, const DebugDrawColor& color, bool no_depth_test = false, float duration = 0.f);
+        // 下面的形状只记录一个实例（变换+颜色），由GPU上的单位网格实例化绘制
+        // 轴对齐包围盒的线框
+        void addBox(const Vector3& center, const Vector3& half_extents, const DebugDrawColor& color, bool no_depth_test = false, float duration = 0.f);
+        // 用三个互相垂直的圆表示球体
+        void addSphere(const Vector3& center, float radius, const DebugDrawColor& color, bool no_depth_test = false, float duration = 0.f);
+        // 以point0、point1为两端半球球心的胶囊体
+        void addCapsule(const Vector3& point0, const Vector3& point1, float radius, const DebugDrawColor& color, bool no_depth_test = false, float duration = 0.f);
+        // 从from指向to的箭头，箭头大小与长度成比例
+        void addArrow(const Vector3& from, const Vector3& to, const DebugDrawColor& color, bool no_depth_test = false, float duration = 0.f);
+        // corners的前4个点为近平面，后4个点为远平面，两组都按相同的绕序排列
+        void addFrustum(const Vector3 corners[8], const DebugDrawColor& color, bool no_depth_test = false, float duration = 0.f);
+
+        // 由渲染线程在递增帧序号之后调用，返回previous_epoch对应的帧数据
+        DebugDrawFrameData& acquireFrameData(uint32_t previous_epoch);
+
+        // 生命周期使用的时钟，单位为秒
+        static double getCurrentTime();
+
+    private:
+        static DebugDrawPipelineType getPipelineType(DebugDrawPipelineType depth_test_type, bool no_depth_test);
+        void appendVertices(DebugDrawPipelineType pipeline_type, const Vector3* positions, uint32_t vertex_count, const DebugDrawColor& color, float duration);
+        // axis_x/y/z为单位网格局部坐标轴在世界空间中的方向（已包含缩放），origin为局部原点
+        void appendShape(DebugDrawShapeType shape_type, const Vector3& axis_x, const Vector3& axis_y, const Vector3& axis_z, const Vector3& origin,
+            float cap_offset, const DebugDrawColor& color, bool no_depth_test, float duration);
+
+        const std::atomic<uint32_t>* m_frame_epoch{ nullptr };
+        std::atomic<bool> m_is_writing{ false };
+        DebugDrawFrameData m_frame_data[2];
+    };
+} // namespace Mercury
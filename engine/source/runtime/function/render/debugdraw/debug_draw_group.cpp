@@ -0,0 +1,194 @@
+#include "runtime/function/render/debugdraw/debug_draw_group.h"
+
+namespace Mercury
+{
+    void DebugDrawGroup::append(DebugDrawPipelineType pipeline_type, const Vector3* positions, const uint32_t* colors, uint32_t vertex_count)
+    {
+        DebugDrawVertexStream& stream = m_vertex_streams[pipeline_type];
+        stream.positions.insert(stream.positions.end(), positions, positions + vertex_count);
+        stream.colors.insert(stream.colors.end(), colors, colors + vertex_count);
+    }
+
+    void DebugDrawGroup::appendInstances(uint32_t shape_batch, const DebugDrawShapeInstance* instances, uint32_t instance_count)
+    {
+        m_instances[shape_batch].insert(m_instances[shape_batch].end(), instances, instances + instance_count);
+    }
+
+    void DebugDrawGroup::clear()
+    {
+        for (DebugDrawVertexStream& stream : m_vertex_streams)
+        {
+            stream.clear();
+        }
+        for (std::vector<DebugDrawShapeInstance>& instances : m_instances)
+        {
+            instances.clear();
+        }
+    }
+
+    const DebugDrawVertexStream& DebugDrawGroup::getVertexStream(DebugDrawPipelineType pipeline_type) const
+    {
+        return m_vertex_streams[pipeline_type];
+    }
+
+    uint32_t DebugDrawGroup::getVertexCount() const
+    {
+        uint32_t vertex_count = 0;
+        for (const DebugDrawVertexStream& stream : m_vertex_streams)
+        {
+            vertex_count += stream.getVertexCount();
+        }
+        return vertex_count;
+    }
+
+    const std::vector<DebugDrawShapeInstance>& DebugDrawGroup::getInstances(uint32_t shape_batch) const
+    {
+        return m_instances[shape_batch];
+    }
+
+    uint32_t DebugDrawGroup::getInstanceCount() const
+    {
+        uint32_t instance_count = 0;
+        for (const std::vector<DebugDrawShapeInstance>& instances : m_instances)
+        {
+            instance_count += static_cast<uint32_t>(instances.size());
+        }
+        return instance_count;
+    }
+
+    void DebugDrawTimedGroup::append(DebugDrawPipelineType pipeline_type, const Vector3* positions, uint32_t vertex_count, uint32_t color, double expire_time)
+    {
+        DebugDrawVertexStream& stream = m_vertex_streams[pipeline_type];
+        stream.positions.insert(stream.positions.end(), positions, positions + vertex_count);
+        stream.colors.insert(stream.colors.end(), vertex_count, color);
+        m_expire_times[pipeline_type].insert(m_expire_times[pipeline_type].end(), vertex_count, expire_time);
+    }
+
+    void DebugDrawTimedGroup::appendInstance(uint32_t shape_batch, const DebugDrawShapeInstance& instance, double expire_time)
+    {
+        m_instances[shape_batch].push_back(instance);
+        m_instance_expire_times[shape_batch].push_back(expire_time);
+    }
+
+    void DebugDrawTimedGroup::merge(DebugDrawTimedGroup& other)
+    {
+        for (uint32_t i = 0; i < k_debug_draw_vertex_stream_count; ++i)
+        {
+            DebugDrawVertexStream& stream = m_vertex_streams[i];
+            DebugDrawVertexStream& other_stream = other.m_vertex_streams[i];
+            stream.positions.insert(stream.positions.end(), other_stream.positions.begin(), other_stream.positions.end());
+            stream.colors.insert(stream.colors.end(), other_stream.colors.begin(), other_stream.colors.end());
+            m_expire_times[i].insert(m_expire_times[i].end(), other.m_expire_times[i].begin(), other.m_expire_times[i].end());
+        }
+        for (uint32_t i = 0; i < k_debug_draw_shape_batch_count; ++i)
+        {
+            m_instances[i].insert(m_instances[i].end(), other.m_instances[i].begin(), other.m_instances[i].end());
+            m_instance_expire_times[i].insert(m_instance_expire_times[i].end(), other.m_instance_expire_times[i].begin(), other.m_instance_expire_times[i].end());
+        }
+        other.clear();
+    }
+
+    void DebugDrawTimedGroup::removeExpired(double current_time)
+    {
+        for (uint32_t i = 0; i < k_debug_draw_vertex_stream_count; ++i)
+        {
+            DebugDrawVertexStream& stream = m_vertex_streams[i];
+            std::vector<double>& expire_times = m_expire_times[i];
+
+            // 同一个图元的顶点过期时间相同，按顶点压缩不会拆散图元
+            size_t write_index = 0;
+            for (size_t read_index = 0; read_index < expire_times.size(); ++read_index)
+            {
+                if (expire_times[read_index] <= current_time)
+                {
+                    continue;
+                }
+                if (write_index != read_index)
+                {
+                    stream.positions[write_index] = stream.positions[read_index];
+                    stream.colors[write_index] = stream.colors[read_index];
+                    expire_times[write_index] = expire_times[read_index];
+                }
+                ++write_index;
+            }
+            stream.positions.resize(write_index);
+            stream.colors.resize(write_index);
+            expire_times.resize(write_index);
+        }
+
+        for (uint32_t i = 0; i < k_debug_draw_shape_batch_count; ++i)
+        {
+            std::vector<DebugDrawShapeInstance>& instances = m_instances[i];
+            std::vector<double>& expire_times = m_instance_expire_times[i];
+
+            size_t write_index = 0;
+            for (size_t read_index = 0; read_index < expire_times.size(); ++read_index)
+            {
+                if (expire_times[read_index] <= current_time)
+                {
+                    continue;
+                }
+                if (write_index != read_index)
+                {
+                    instances[write_index] = instances[read_index];
+                    expire_times[write_index] = expire_times[read_index];
+                }
+                ++write_index;
+            }
+            instances.resize(write_index);
+            expire_times.resize(write_index);
+        }
+    }
+
+    void DebugDrawTimedGroup::appendTo(DebugDrawGroup& group) const
+    {
+        for (uint32_t i = 0; i < k_debug_draw_vertex_stream_count; ++i)
+        {
+            const DebugDrawVertexStream& stream = m_vertex_streams[i];
+            if (stream.getVertexCount() > 0)
+            {
+                group.append((DebugDrawPipelineType)i, stream.positions.data(), stream.colors.data(), stream.getVertexCount());
+            }
+        }
+        for (uint32_t i = 0; i < k_debug_draw_shape_batch_count; ++i)
+        {
+            if (!m_instances[i].empty())
+            {
+                group.appendInstances(i, m_instances[i].data(), static_cast<uint32_t>(m_instances[i].size()));
+            }
+        }
+    }
+
+    void DebugDrawTimedGroup::clear()
+    {
+        for (uint32_t i = 0; i < k_debug_draw_vertex_stream_count; ++i)
+        {
+            m_vertex_streams[i].clear();
+            m_expire_times[i].clear();
+        }
+        for (uint32_t i = 0; i < k_debug_draw_shape_batch_count; ++i)
+        {
+            m_instances[i].clear();
+            m_instance_expire_times[i].clear();
+        }
+    }
+
+    bool DebugDrawTimedGroup::empty() const
+    {
+        for (const std::vector<double>& expire_times : m_expire_times)
+        {
+            if (!expire_times.empty())
+            {
+                return false;
+            }
+        }
+        for (const std::vector<double>& expire_times : m_instance_expire_times)
+        {
+            if (!expire_times.empty())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace Mercury
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "runtime/function/render/debugdraw/debug_draw_pipeline.h"
+#include "runtime/function/render/debugdraw/debug_draw_primitive.h"
+#include "runtime/function/render/debugdraw/debug_draw_shape.h"
+
+#include <vector>
+
+namespace Mercury
+{
+    // 一种pipeline类型对应的顶点流，positions和colors一一对应
+    struct DebugDrawVertexStream
+    {
+        std::vector<Vector3> positions;
+        std::vector<uint32_t> colors;
+
+        uint32_t getVertexCount() const { return static_cast<uint32_t>(positions.size()); }
+        void clear()
+        {
+            // clear不释放容量，下一帧可以直接复用
+            positions.clear();
+            colors.clear();
+        }
+    };
+
+    /*
+    * 渲染侧汇总一帧所有debug图元的容器，按pipeline类型分成连续的顶点流，上传时每种类型只需要一次memcpy。
+    * 形状（box、sphere等）不展开成顶点，而是按批次记录实例，每批一次instanced draw call。
+    * 只在渲染线程上访问，不加锁；各线程的图元通过DebugDrawContext提交。
+    */
+    class DebugDrawGroup
+    {
+    public:
+        void append(DebugDrawPipelineType pipeline_type, const Vector3* positions, const uint32_t* colors, uint32_t vertex_count);
+        void clear();
+
+        void appendInstances(uint32_t shape_batch, const DebugDrawShapeInstance* instances, uint32_t instance_count);
+
+        const DebugDrawVertexStream& getVertexStream(DebugDrawPipelineType pipeline_type) const;
+        uint32_t getVertexCount() const;
+        const std::vector<DebugDrawShapeInstance>& getInstances(uint32_t shape_batch) const;
+        uint32_t getInstanceCount() const;
+
+    private:
+        DebugDrawVertexStream m_vertex_streams[k_debug_draw_vertex_stream_count];
+        std::vector<DebugDrawShapeInstance> m_instances[k_debug_draw_shape_batch_count];
+    };
+
+    /*
+    * 带生命周期的图元（持续绘制N秒），每个顶点/形状实例记录过期时间。
+    * 过期时对每个顶点流做一次线性压缩整体移除，而不是逐个图元删除。
+    */
+    class DebugDrawTimedGroup
+    {
+    public:
+        void append(DebugDrawPipelineType pipeline_type, const Vector3* positions, uint32_t vertex_count, uint32_t color, double expire_time);
+        void appendInstance(uint32_t shape_batch, const DebugDrawShapeInstance& instance, double expire_time);
+        // 把other中的全部图元移入本group，other被清空
+        void merge(DebugDrawTimedGroup& other);
+        void removeExpired(double current_time);
+        void appendTo(DebugDrawGroup& group) const;
+        void clear();
+        bool empty() const;
+
+    private:
+        DebugDrawVertexStream m_vertex_streams[k_debug_draw_vertex_stream_count];
+        std::vector<double> m_expire_times[k_debug_draw_vertex_stream_count];
+        std::vector<DebugDrawShapeInstance> m_instances[k_debug_draw_shape_batch_count];
+        std::vector<double> m_instance_expire_times[k_debug_draw_shape_batch_count];
+    };
+} // namespace Mercury
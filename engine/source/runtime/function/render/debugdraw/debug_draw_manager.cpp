@@ -1,99 +1,367 @@
 #include "runtime/function/render/debugdraw/debug_draw_manager.h"
 #include "runtime/function/global/global_context.h"
+#include "runtime/core/base/profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 
 namespace Mercury
 {
+    DebugDrawManager::DebugDrawManager()
+    {
+        static std::atomic<uint64_t> s_next_instance_id{ 1 };
+        m_instance_id = s_next_instance_id.fetch_add(1);
+    }
+
+    DebugDrawManager::~DebugDrawManager()
+    {
+        // 网格、render pass和framebuffer可能仍被在途的命令缓冲区引用
+        if (m_rhi != nullptr)
+        {
+            m_rhi->waitDeviceIdle();
+            m_shape_meshes.clear();
+            if (m_debug_draw_pipeline != nullptr)
+            {
+                m_debug_draw_pipeline->clear();
+                delete m_debug_draw_pipeline;
+                m_debug_draw_pipeline = nullptr;
+            }
+        }
+    }
+
     void DebugDrawManager::initialize() {
         m_rhi = g_runtime_global_context.m_render_system->getRHI();
         setupPipelines();
+        m_shape_meshes.initialize(m_rhi);
     }
 
     void DebugDrawManager::setupPipelines() {
-        for (uint8_t i = 0; i < DebugDrawPipelineType::_debug_draw_pipeline_type_count; i++)
+        // 所有变体的编译通过PipelineBuildService在任务系统的线程上进行，第一次绘制前再等待
+        // ! 点图元会检查着色器中是否包含point size，因此只需要加上即可
+        m_debug_draw_pipeline = new DebugDrawPipeline();
+        m_debug_draw_pipeline->initilialize();
+        m_is_pipelines_ready = false;
+    }
+
+    void DebugDrawManager::waitForPipelines()
+    {
+        if (m_is_pipelines_ready)
         {
-            // ! 当i==0时，会检查着色器中是否包含point size，因此只需要加上即可
-            m_debug_draw_pipeline[i] = new DebugDrawPipeline((DebugDrawPipelineType)i);
-            m_debug_draw_pipeline[i]->initilialize();
+            return;
         }
-
+        m_debug_draw_pipeline->waitForPipelines();
+        m_is_pipelines_ready = true;
     }
 
     void DebugDrawManager::preparePassData(std::shared_ptr<RenderResourceBase> render_resource)
     {
-        const RenderResource* resource = static_cast<const RenderResource*>(render_resource.get());
-        // todo 
-        // m_proj_view_matrix = resource->m_mesh_perframe_storage_buffer_object.proj_view_matrix;
+        // 顶点在draw时才写入环形缓冲区：此时当前帧槽位已经等待完毕，对应的分段可以安全覆盖
+        m_render_resource = std::static_pointer_cast<RenderResource>(render_resource);
+    }
 
+    void DebugDrawManager::setProjViewMatrix(const float proj_view_matrix[16])
+    {
+        std::copy(proj_view_matrix, proj_view_matrix + 16, m_proj_view_matrix);
     }
 
-    void DebugDrawManager::draw(uint32_t current_swapchain_image_index)
+    void DebugDrawManager::draw(RHICommandBuffer* command_buffer, uint32_t current_swapchain_image_index, RHIImageView* depth_image_view)
     {
+        MERCURY_PROFILE_SCOPE("DebugDrawManager::draw");
+        waitForPipelines();
+
+        // 深度图在render graph compile之后才存在，framebuffer在第一次绘制时创建（此时没有旧的framebuffer需要销毁）
+        if (m_debug_draw_pipeline->getFramebuffer().framebuffers.empty())
+        {
+            m_debug_draw_pipeline->setupFramebuffer(depth_image_view);
+        }
 
-        static uint32_t once = 1;
         swapDataToRender();
-        once = 0;
 
         float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
 
         //  m_rhi 
-        m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "DebugDrawManager", color);
-        m_rhi->cmdSetViewportPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, m_rhi->getSwapchainInfo().viewport);
-        m_rhi->cmdSetScissorPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, m_rhi->getSwapchainInfo().scissor);
+        m_rhi->pushEvent(command_buffer, "DebugDrawManager", color);
+        const RHISwapChainDesc& swapchain_info = m_rhi->getSwapchainInfo();
+        m_rhi->cmdSetViewportPFN(command_buffer, 0, 1, swapchain_info.viewport);
+        m_rhi->cmdSetScissorPFN(command_buffer, 0, 1, swapchain_info.scissor);
 
-        drawDebugObject(current_swapchain_image_index);
+        drawDebugObject(command_buffer, current_swapchain_image_index);
 
-        m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
+        m_rhi->popEvent(command_buffer);
 
         // std::cout << "debug draw manager::draw" << std::endl;
     }
 
-    // todo
-    void DebugDrawManager::swapDataToRender() {}
+    DebugDrawContext* DebugDrawManager::getDebugDrawContext()
+    {
+        // 缓存中记录manager的实例id，manager重建后不会再使用已经销毁的context
+        struct ThreadContextCache
+        {
+            uint64_t manager_instance_id{ 0 };
+            DebugDrawContext* context{ nullptr };
+        };
+        thread_local ThreadContextCache cache;
+        if (cache.manager_instance_id == m_instance_id)
+        {
+            return cache.context;
+        }
 
-    void DebugDrawManager::drawDebugObject(uint32_t current_swapchain_image_index) {
-        debugSimpleTriangle(current_swapchain_image_index);
+        std::lock_guard<std::mutex> lock(m_context_mutex);
+        m_contexts.push_back(std::make_unique<DebugDrawContext>(&m_frame_epoch));
+        cache.manager_instance_id = m_instance_id;
+        cache.context = m_contexts.back().get();
+        return cache.context;
+    }
 
-        // todo
-        // prepareDrawBuffer();
-        // drawPointLineTriangleBox(current_swapchain_image_index);
-        // drawWireFrameObject(current_swapchain_image_index);
+    // 帧边界：递增帧序号让生产者切换到另一份帧数据，再把各context上一帧的图元汇总到渲染侧
+    void DebugDrawManager::swapDataToRender() {
+        MERCURY_PROFILE_SCOPE("DebugDrawManager::swapDataToRender");
+        m_render_group.clear();
+
+        uint32_t previous_epoch = m_frame_epoch.fetch_add(1, std::memory_order_seq_cst);
+        {
+            std::lock_guard<std::mutex> lock(m_context_mutex);
+            m_context_snapshot.clear();
+            for (const std::unique_ptr<DebugDrawContext>& context : m_contexts)
+            {
+                m_context_snapshot.push_back(context.get());
+            }
+        }
+
+        for (DebugDrawContext* context : m_context_snapshot)
+        {
+            DebugDrawFrameData& frame_data = context->acquireFrameData(previous_epoch);
+            for (uint8_t i = 0; i < k_debug_draw_vertex_stream_count; i++)
+            {
+                frame_data.chunk_lists[i].appendTo((DebugDrawPipelineType)i, m_render_group);
+            }
+            for (uint32_t i = 0; i < k_debug_draw_shape_batch_count; i++)
+            {
+                const std::vector<DebugDrawShapeInstance>& instances = frame_data.shape_instances[i];
+                m_render_group.appendInstances(i, instances.data(), static_cast<uint32_t>(instances.size()));
+            }
+            m_timed_group.merge(frame_data.timed_group);
+            frame_data.reset();
+        }
+
+        // 过期的图元在这里整体移除，剩下的每帧都参与绘制
+        m_timed_group.removeExpired(DebugDrawContext::getCurrentTime());
+        m_timed_group.appendTo(m_render_group);
     }
 
-    void DebugDrawManager::debugSimpleTriangle(uint32_t current_swapchain_image_index) {
+    void DebugDrawManager::drawDebugObject(RHICommandBuffer* command_buffer, uint32_t current_swapchain_image_index) {
+        prepareDrawBuffer();
+        prepareInstanceBuffer();
+
         // Starting a render pass:https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Command_buffers#page_Starting-a-render-pass
+        // 即使没有图元也要执行render pass，用于清除颜色和深度缓冲区
         RHIRenderPassBeginInfo renderPassInfo{};
         renderPassInfo.sType = RHI_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderPassInfo.renderPass = m_debug_draw_pipeline[DebugDrawPipelineType::_debug_draw_pipeline_type_triangle]->getFramebuffer().render_pass;
-        renderPassInfo.framebuffer = m_debug_draw_pipeline[DebugDrawPipelineType::_debug_draw_pipeline_type_triangle]->getFramebuffer().framebuffers[current_swapchain_image_index];
+        renderPassInfo.renderPass = m_debug_draw_pipeline->getFramebuffer().render_pass;
+        renderPassInfo.framebuffer = m_debug_draw_pipeline->getFramebuffer().framebuffers[current_swapchain_image_index];
         renderPassInfo.renderArea.offset = { 0, 0 };
         renderPassInfo.renderArea.extent = m_rhi->getSwapchainInfo().extent;
 
-        RHIClearValue clearColor = { {{0.0f, 0.0f, 0.0f, 1.0f}} };
-        renderPassInfo.clearValueCount = 1;
-        renderPassInfo.pClearValues = &clearColor;
+        RHIClearValue clear_values[2];
+        clear_values[0].color = { {0.0f, 0.0f, 0.0f, 1.0f} };
+        clear_values[1].depthStencil = { 1.0f, 0 };
+        renderPassInfo.clearValueCount = 2;
+        renderPassInfo.pClearValues = clear_values;
 
-        m_rhi->cmdBeginRenderPassPFN(m_rhi->getCurrentCommandBuffer(), &renderPassInfo, RHI_SUBPASS_CONTENTS_INLINE);
+        m_rhi->cmdBeginRenderPassPFN(command_buffer, &renderPassInfo, RHI_SUBPASS_CONTENTS_INLINE);
 
-        // Basic drawing commands:https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Command_buffers#page_Basic-drawing-commands
-        m_rhi->cmdBindPipelinePFN(m_rhi->getCurrentCommandBuffer(), RHI_PIPELINE_BIND_POINT_GRAPHICS, m_debug_draw_pipeline[DebugDrawPipelineType::_debug_draw_pipeline_type_triangle]->getPipeline().pipeline);
-        /*  
-        -------vkCmdDraw参数解释--------
-        - 顶点计数（vertexCount）：尽管我们没有顶点缓冲区，但从技术上讲，我们仍有 3 个顶点需要绘制。
-        - instanceCount（实例计数）：用于实例渲染，如果不进行实例渲染，则使用 1。
-        - firstVertex（第一个顶点）：用作顶点缓冲区的偏移量，定义 gl_VertexIndex 的最小值。
-        - firstInstance（第一个实例）：用作实例渲染的偏移量，定义 gl_InstanceIndex 的最小值。 */
-        m_rhi->cmdDraw(m_rhi->getCurrentCommandBuffer(), 3, 1, 0, 0);
+        drawPointLineTriangleBox(command_buffer);
+        drawShapes(command_buffer);
+        if (m_command_benchmark_count != 0)
+        {
+            recordCommandBenchmark(command_buffer);
+            m_command_benchmark_count = 0;
+        }
+        // todo
+        // drawWireFrameObject(current_swapchain_image_index);
 
-        m_rhi->cmdEndRenderPassPFN(m_rhi->getCurrentCommandBuffer());
+        m_rhi->cmdEndRenderPassPFN(command_buffer);
     }
 
+    // 把所有顶点流一次性写入当前帧的上传环形缓冲区：先是全部位置，再是全部颜色
+    void DebugDrawManager::prepareDrawBuffer() {
+        MERCURY_PROFILE_SCOPE("DebugDrawManager::prepareDrawBuffer");
+        uint32_t total_vertex_count = 0;
+        for (uint8_t i = 0; i < k_debug_draw_vertex_stream_count; i++)
+        {
+            const DebugDrawVertexStream& stream = m_render_group.getVertexStream((DebugDrawPipelineType)i);
+            m_first_vertex[i] = total_vertex_count;
+            m_vertex_count[i] = std::min(stream.getVertexCount(), k_max_vertex_count_per_frame - total_vertex_count);
+            total_vertex_count += m_vertex_count[i];
+        }
+        const bool is_vertex_overflowing = total_vertex_count < m_render_group.getVertexCount();
+        if (is_vertex_overflowing && !m_is_vertex_overflowing)
+        {
+            std::cout << "debug draw vertex count exceeds " << k_max_vertex_count_per_frame << ", the rest are dropped until it drops below the limit" << std::endl;
+        }
+        m_is_vertex_overflowing = is_vertex_overflowing;
 
-    void DebugDrawManager::updateAfterRecreateSwapchain()
-    {
-        for (uint8_t i = 0; i < DebugDrawPipelineType::_debug_draw_pipeline_type_count; i++)
+        m_vertex_buffer = nullptr;
+        if (total_vertex_count == 0 || m_render_resource == nullptr)
+        {
+            return;
+        }
+
+        RingBufferAllocation position_allocation = m_render_resource->allocate(total_vertex_count * sizeof(Vector3), sizeof(float) * 4);
+        RingBufferAllocation color_allocation = m_render_resource->allocate(total_vertex_count * sizeof(uint32_t), sizeof(uint32_t));
+        Vector3* positions = static_cast<Vector3*>(position_allocation.mapped_data);
+        uint32_t* colors = static_cast<uint32_t*>(color_allocation.mapped_data);
+        for (uint8_t i = 0; i < k_debug_draw_vertex_stream_count; i++)
+        {
+            if (m_vertex_count[i] == 0)
+            {
+                continue;
+            }
+            const DebugDrawVertexStream& stream = m_render_group.getVertexStream((DebugDrawPipelineType)i);
+            std::memcpy(positions + m_first_vertex[i], stream.positions.data(), m_vertex_count[i] * sizeof(Vector3));
+            std::memcpy(colors + m_first_vertex[i], stream.colors.data(), m_vertex_count[i] * sizeof(uint32_t));
+        }
+
+        m_vertex_buffer = position_allocation.buffer;
+        m_position_offset = position_allocation.offset;
+        m_color_offset = color_allocation.offset;
+    }
+
+    // 所有批次的实例写入同一段环形缓冲区，每批在其中占一段连续区间，绘制时用firstInstance定位
+    void DebugDrawManager::prepareInstanceBuffer() {
+        MERCURY_PROFILE_SCOPE("DebugDrawManager::prepareInstanceBuffer");
+        uint32_t total_instance_count = 0;
+        for (uint32_t i = 0; i < k_debug_draw_shape_batch_count; i++)
+        {
+            m_first_instance[i] = total_instance_count;
+            m_instance_count[i] = std::min(static_cast<uint32_t>(m_render_group.getInstances(i).size()), k_max_shape_instance_count_per_frame - total_instance_count);
+            total_instance_count += m_instance_count[i];
+        }
+        const bool is_instance_overflowing = total_instance_count < m_render_group.getInstanceCount();
+        if (is_instance_overflowing && !m_is_instance_overflowing)
+        {
+            std::cout << "debug draw shape count exceeds " << k_max_shape_instance_count_per_frame << ", the rest are dropped until it drops below the limit" << std::endl;
+        }
+        m_is_instance_overflowing = is_instance_overflowing;
+
+        m_instance_buffer = nullptr;
+        if (total_instance_count == 0 || m_render_resource == nullptr)
+        {
+            return;
+        }
+
+        RingBufferAllocation instance_allocation = m_render_resource->allocate(total_instance_count * sizeof(DebugDrawShapeInstance), sizeof(float) * 4);
+        DebugDrawShapeInstance* instances = static_cast<DebugDrawShapeInstance*>(instance_allocation.mapped_data);
+        for (uint32_t i = 0; i < k_debug_draw_shape_batch_count; i++)
         {
-            // 每条管线都重新设置framebuffer
-            m_debug_draw_pipeline[i]->recreateAfterSwapchain();
+            if (m_instance_count[i] > 0)
+            {
+                std::memcpy(instances + m_first_instance[i], m_render_group.getInstances(i).data(), m_instance_count[i] * sizeof(DebugDrawShapeInstance));
+            }
         }
+
+        m_instance_buffer = instance_allocation.buffer;
+        m_instance_offset = instance_allocation.offset;
+    }
+
+    // 每种pipeline类型只绑定一次pipeline、发出一次draw call
+    void DebugDrawManager::drawPointLineTriangleBox(RHICommandBuffer* command_buffer) {
+        if (m_vertex_buffer == nullptr)
+        {
+            return;
+        }
+
+        RHIBuffer* vertex_buffers[2] = { m_vertex_buffer, m_vertex_buffer };
+        RHIDeviceSize offsets[2] = { m_position_offset, m_color_offset };
+        m_rhi->cmdBindVertexBuffersPFN(command_buffer, DebugDrawVertex::k_position_binding, 2, vertex_buffers, offsets);
+
+        // 所有变体共用同一个pipeline layout，push constant只需要设置一次
+        const DebugDrawPipelineBase& base_pipeline = m_debug_draw_pipeline->getPipeline(_debug_draw_pipeline_type_triangle);
+        m_rhi->cmdPushConstants(command_buffer, base_pipeline.layout, RHI_SHADER_STAGE_VERTEX_BIT, 0, sizeof(m_proj_view_matrix), m_proj_view_matrix);
+
+        for (uint8_t i = 0; i < k_debug_draw_vertex_stream_count; i++)
+        {
+            if (m_vertex_count[i] == 0)
+            {
+                continue;
+            }
+            // Basic drawing commands:https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Command_buffers#page_Basic-drawing-commands
+            m_rhi->cmdBindPipelinePFN(command_buffer, RHI_PIPELINE_BIND_POINT_GRAPHICS, m_debug_draw_pipeline->getPipeline((DebugDrawPipelineType)i).pipeline);
+            /*  
+            -------vkCmdDraw参数解释--------
+            - vertexCount：本类型的顶点数。
+            - instanceCount（实例计数）：用于实例渲染，如果不进行实例渲染，则使用 1。
+            - firstVertex（第一个顶点）：用作顶点缓冲区的偏移量，定义 gl_VertexIndex 的最小值。
+            - firstInstance（第一个实例）：用作实例渲染的偏移量，定义 gl_InstanceIndex 的最小值。 */
+            m_rhi->cmdDraw(command_buffer, m_vertex_count[i], 1, m_first_vertex[i], 0);
+        }
+    }
+
+    // 每种形状一次instanced indexed draw call，索引和网格顶点来自常驻的单位网格
+    void DebugDrawManager::drawShapes(RHICommandBuffer* command_buffer) {
+        if (m_instance_buffer == nullptr)
+        {
+            return;
+        }
+
+        RHIBuffer* vertex_buffers[2] = { m_shape_meshes.getBuffer(), m_instance_buffer };
+        RHIDeviceSize offsets[2] = { 0, m_instance_offset };
+        m_rhi->cmdBindVertexBuffersPFN(command_buffer, DebugDrawShapeInstance::k_mesh_binding, 2, vertex_buffers, offsets);
+        m_rhi->cmdBindIndexBufferPFN(command_buffer, m_shape_meshes.getBuffer(), m_shape_meshes.getIndexOffset(), RHI_INDEX_TYPE_UINT16);
+
+        // 没有顶点流图元时drawPointLineTriangleBox不会设置push constant，这里再设置一次
+        const DebugDrawPipelineBase& base_pipeline = m_debug_draw_pipeline->getPipeline(_debug_draw_pipeline_type_triangle);
+        m_rhi->cmdPushConstants(command_buffer, base_pipeline.layout, RHI_SHADER_STAGE_VERTEX_BIT, 0, sizeof(m_proj_view_matrix), m_proj_view_matrix);
+
+        RHIPipeline* bound_pipeline = nullptr;
+        for (uint32_t i = 0; i < k_debug_draw_shape_batch_count; i++)
+        {
+            if (m_instance_count[i] == 0)
+            {
+                continue;
+            }
+            DebugDrawPipelineType pipeline_type = i < _debug_draw_shape_type_count ? _debug_draw_pipeline_type_shape : _debug_draw_pipeline_type_shape_no_depth_test;
+            RHIPipeline* pipeline = m_debug_draw_pipeline->getPipeline(pipeline_type).pipeline;
+            if (pipeline != bound_pipeline)
+            {
+                m_rhi->cmdBindPipelinePFN(command_buffer, RHI_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                bound_pipeline = pipeline;
+            }
+            // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkCmdDrawIndexed.html
+            const DebugDrawShapeMesh& mesh = m_shape_meshes.getMesh((DebugDrawShapeType)(i % _debug_draw_shape_type_count));
+            m_rhi->cmdDrawIndexed(command_buffer, mesh.index_count, m_instance_count[i], mesh.first_index, mesh.vertex_offset, m_first_instance[i]);
+        }
+    }
+
+    // 录制m_command_benchmark_count组viewport/scissor/draw：draw的顶点数为0，GPU上没有工作，只衡量CPU侧的录制开销
+    void DebugDrawManager::recordCommandBenchmark(RHICommandBuffer* command_buffer) {
+        MERCURY_PROFILE_SCOPE("DebugDrawManager::recordCommandBenchmark");
+        // 两个顶点绑定都指向常驻的网格缓冲区，保证draw时pipeline需要的绑定状态有效
+        RHIBuffer* vertex_buffers[2] = { m_shape_meshes.getBuffer(), m_shape_meshes.getBuffer() };
+        RHIDeviceSize offsets[2] = { 0, 0 };
+        m_rhi->cmdBindVertexBuffersPFN(command_buffer, DebugDrawVertex::k_position_binding, 2, vertex_buffers, offsets);
+        const DebugDrawPipelineBase& pipeline = m_debug_draw_pipeline->getPipeline(_debug_draw_pipeline_type_triangle);
+        m_rhi->cmdBindPipelinePFN(command_buffer, RHI_PIPELINE_BIND_POINT_GRAPHICS, pipeline.pipeline);
+        m_rhi->cmdPushConstants(command_buffer, pipeline.layout, RHI_SHADER_STAGE_VERTEX_BIT, 0, sizeof(m_proj_view_matrix), m_proj_view_matrix);
+
+        const RHISwapChainDesc& swapchain_info = m_rhi->getSwapchainInfo();
+        const std::chrono::steady_clock::time_point begin_time = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < m_command_benchmark_count; i++)
+        {
+            m_rhi->cmdSetViewportPFN(command_buffer, 0, 1, swapchain_info.viewport);
+            m_rhi->cmdSetScissorPFN(command_buffer, 0, 1, swapchain_info.scissor);
+            m_rhi->cmdDraw(command_buffer, 0, 1, 0, 0);
+        }
+        const double elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin_time).count();
+
+        std::cout << "command recording benchmark: " << m_command_benchmark_count << " x (viewport, scissor, draw), "
+            << elapsed_ns / (3.0 * m_command_benchmark_count) << " ns per command" << std::endl;
+    }
+
+    void DebugDrawManager::updateAfterRecreateSwapchain(RHIImageView* depth_image_view)
+    {
+        // 所有变体共用同一组framebuffer，只需要重建一次
+        m_debug_draw_pipeline->recreateAfterSwapchain(depth_image_view);
     }
 } // namespace Mercury
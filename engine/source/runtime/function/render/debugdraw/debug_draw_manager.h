@@ -1,29 +1,92 @@
 #pragma once
 
 #include "runtime/function/render/interface/rhi.h"
+#include "runtime/function/render/debugdraw/debug_draw_context.h"
+#include "runtime/function/render/debugdraw/debug_draw_group.h"
 #include "runtime/function/render/debugdraw/debug_draw_pipeline.h"
+#include "runtime/function/render/debugdraw/debug_draw_shape.h"
 #include "runtime/function/render/render_resource.h"
 
+#include <atomic>
 #include <iostream>
+#include <mutex>
 
 namespace Mercury
 {
     class DebugDrawManager {
     public:
-        DebugDrawManager() {}
+        // 单帧最多上传的debug顶点数，超出部分被丢弃（位置12字节+颜色4字节，共4MB）
+        static constexpr uint32_t k_max_vertex_count_per_frame = 256 * 1024;
+        // 单帧最多上传的形状实例数（每个实例56字节，共1.75MB）
+        static constexpr uint32_t k_max_shape_instance_count_per_frame = 32 * 1024;
+
+        DebugDrawManager();
+        ~DebugDrawManager();
         void initialize();
         void setupPipelines();
+        void waitForPipelines();
         void preparePassData(std::shared_ptr<RenderResourceBase> render_resource);
 
-        void draw(uint32_t current_swapchain_image_index);
-        void updateAfterRecreateSwapchain();
+        // 录制到render graph传入的命令缓冲区中，深度缓冲是render graph创建的image
+        void draw(RHICommandBuffer* command_buffer, uint32_t current_swapchain_image_index, RHIImageView* depth_image_view);
+        // 由RHI在重建swapchain、等待之前的帧完成之后回调，framebuffer只在这里重建
+        void updateAfterRecreateSwapchain(RHIImageView* depth_image_view);
+
+        // 逻辑侧提交图元的入口：返回调用线程自己的context，任意线程都可以调用
+        DebugDrawContext* getDebugDrawContext();
+        // 列主序的4x4矩阵，与GLSL的mat4一致
+        void setProjViewMatrix(const float proj_view_matrix[16]);
+        // 非0时在下一次draw中额外录制count组viewport/scissor/draw，输出每条命令的平均录制耗时，用于衡量RHI包装函数的开销
+        void setCommandBenchmarkCount(uint32_t count) { m_command_benchmark_count = count; }
 
     private:
         std::shared_ptr<RHI> m_rhi = nullptr;
-        DebugDrawPipeline* m_debug_draw_pipeline[DebugDrawPipelineType::_debug_draw_pipeline_type_count] = {};
+        std::shared_ptr<RenderResource> m_render_resource = nullptr;
+        DebugDrawPipeline* m_debug_draw_pipeline = nullptr;
+        bool m_is_pipelines_ready{ false };
+
+        // 各线程的context只在第一次获取时加锁注册，之后通过thread_local缓存直接访问
+        uint64_t m_instance_id{ 0 };
+        std::atomic<uint32_t> m_frame_epoch{ 0 };
+        std::mutex m_context_mutex;
+        std::vector<std::unique_ptr<DebugDrawContext>> m_contexts;
+        std::vector<DebugDrawContext*> m_context_snapshot;
+
+        // 渲染侧：本帧要绘制的全部图元，以及尚未过期的带生命周期的图元
+        DebugDrawGroup m_render_group;
+        DebugDrawTimedGroup m_timed_group;
+        float m_proj_view_matrix[16] = {
+            1.f, 0.f, 0.f, 0.f,
+            0.f, 1.f, 0.f, 0.f,
+            0.f, 0.f, 1.f, 0.f,
+            0.f, 0.f, 0.f, 1.f,
+        };
+
+        // 本帧上传到环形缓冲区中的顶点：各pipeline类型的顶点连续存放
+        RHIBuffer* m_vertex_buffer{ nullptr };
+        RHIDeviceSize m_position_offset{ 0 };
+        RHIDeviceSize m_color_offset{ 0 };
+        uint32_t m_first_vertex[k_debug_draw_vertex_stream_count] = {};
+        uint32_t m_vertex_count[k_debug_draw_vertex_stream_count] = {};
+        // 超出上限时只在开始超出的那一帧打印一次，恢复到上限以内后再次超出才重新打印
+        bool m_is_vertex_overflowing{ false };
+
+        // 形状的单位网格常驻GPU，每帧只上传实例：各批次的实例连续存放
+        DebugDrawShapeMeshes m_shape_meshes;
+        RHIBuffer* m_instance_buffer{ nullptr };
+        RHIDeviceSize m_instance_offset{ 0 };
+        uint32_t m_first_instance[k_debug_draw_shape_batch_count] = {};
+        uint32_t m_instance_count[k_debug_draw_shape_batch_count] = {};
+        bool m_is_instance_overflowing{ false };
+
+        uint32_t m_command_benchmark_count{ 0 };
 
         void swapDataToRender();
-        void drawDebugObject(uint32_t current_swapchain_image_index);
-        void debugSimpleTriangle(uint32_t current_swapchain_image_index);
+        void prepareDrawBuffer();
+        void prepareInstanceBuffer();
+        void drawDebugObject(RHICommandBuffer* command_buffer, uint32_t current_swapchain_image_index);
+        void drawPointLineTriangleBox(RHICommandBuffer* command_buffer);
+        void drawShapes(RHICommandBuffer* command_buffer);
+        void recordCommandBenchmark(RHICommandBuffer* command_buffer);
     };
 } // namespace Mercury
@@ -1,9 +1,12 @@
 #include "runtime/function/render/debugdraw/debug_draw_pipeline.h"
+#include "runtime/function/render/debugdraw/debug_draw_primitive.h"
+#include "runtime/function/render/debugdraw/debug_draw_shape.h"
 #include "runtime/function/global/global_context.h"
 // #include "shader/generated/cpp/debugdraw_vert.h"
 // #include "shader/generated/cpp/debugdraw_frag.h"
 #include <debugdraw_vert.h> // 通过库文件的形式来引入着色器文件
 #include <debugdraw_frag.h>
+#include <debugdraw_instance_vert.h>
 #include <stdexcept>
 namespace Mercury
 {
@@ -11,11 +14,68 @@ namespace Mercury
         m_rhi = g_runtime_global_context.m_render_system->getRHI();
         setupAttachments();
         setupRenderPass();
-        setupFramebuffer();
-        setupDescriptorLayout();
+        // render pass已经创建完毕，pipeline的编译交给后台线程，主线程可以继续初始化其他资源
         setupPipelines();
     }
 
+    void DebugDrawPipeline::waitForPipelines()
+    {
+        if (m_pipeline_futures.empty())
+        {
+            return;
+        }
+        for (std::shared_future<void>& future : m_pipeline_futures)
+        {
+            future.wait();
+        }
+        // 所有变体都编译完成后shader module就不再需要了
+        m_rhi->destroyShaderModule(m_vert_shader_module);
+        m_rhi->destroyShaderModule(m_frag_shader_module);
+        m_rhi->destroyShaderModule(m_shape_vert_shader_module);
+        m_vert_shader_module = nullptr;
+        m_frag_shader_module = nullptr;
+        m_shape_vert_shader_module = nullptr;
+
+        std::vector<std::shared_future<void>> pipeline_futures = std::move(m_pipeline_futures);
+        m_pipeline_futures.clear();
+        for (std::shared_future<void>& future : pipeline_futures)
+        {
+            future.get();
+        }
+    }
+
+    void DebugDrawPipeline::clear()
+    {
+        // 后台编译引用了shader module和render pass，先等编译结束；退出时不再抛出编译失败的异常
+        for (std::shared_future<void>& future : m_pipeline_futures)
+        {
+            future.wait();
+        }
+        m_pipeline_futures.clear();
+        if (m_vert_shader_module != nullptr)
+        {
+            m_rhi->destroyShaderModule(m_vert_shader_module);
+            m_rhi->destroyShaderModule(m_frag_shader_module);
+            m_rhi->destroyShaderModule(m_shape_vert_shader_module);
+            m_vert_shader_module = nullptr;
+            m_frag_shader_module = nullptr;
+            m_shape_vert_shader_module = nullptr;
+        }
+
+        for (RHIFramebuffer* framebuffer : m_framebuffer.framebuffers)
+        {
+            m_rhi->destroyFramebuffer(framebuffer);
+        }
+        m_framebuffer.framebuffers.clear();
+        if (m_framebuffer.render_pass != nullptr)
+        {
+            m_rhi->destroyRenderPass(m_framebuffer.render_pass);
+            m_framebuffer.render_pass = nullptr;
+        }
+    }
+
+    // debug draw绘制到swapchain image和render graph创建的深度缓冲上，不需要额外的attachment；
+    // 需要中间render target的pass通过render graph的createImage声明，由RenderTargetPool按生命周期复用
     void DebugDrawPipeline::setupAttachments() {}
 
     // https://vulkan-tutorial.com/Drawing_a_triangle/Graphics_pipeline_basics/Render_passes
@@ -40,8 +100,9 @@ namespace Mercury
         color_attachment_description.stencilStoreOp = RHI_ATTACHMENT_STORE_OP_DONT_CARE; // 渲染操作后，帧缓冲区的内容将未定义
         // Vulkan 中的纹理和帧缓冲由具有特定像素格式的 VkImage 对象表示，但是内存中像素的布局可能会根据您尝试对图像执行的操作而更改。
         // 也就是说，图像需要过渡到适合他们接下来将要参与的操作的特定布局。
-        color_attachment_description.initialLayout = RHI_IMAGE_LAYOUT_UNDEFINED; // InitialLayout 指定在开始呈现传递之前图像将具有哪种布局。
-        color_attachment_description.finalLayout = RHI_IMAGE_LAYOUT_PRESENT_SRC_KHR; // FinalLayout 指定在呈现传递完成时自动转换到的布局
+        // 与swapchain之间的layout转换（UNDEFINED -> COLOR_ATTACHMENT -> PRESENT_SRC）由render graph的barrier完成
+        color_attachment_description.initialLayout = RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL; // InitialLayout 指定在开始呈现传递之前图像将具有哪种布局。
+        color_attachment_description.finalLayout = RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL; // FinalLayout 指定在呈现传递完成时自动转换到的布局
 
         // 每个子通道都引用我们在前面部分中使用结构描述的一个或多个附件
         RHIAttachmentReference color_attachment_reference{};
@@ -52,8 +113,8 @@ namespace Mercury
         RHIAttachmentDescription depth_attachment_description{};
         depth_attachment_description.format = m_rhi->getDepthImageInfo().depth_image_format;
         depth_attachment_description.samples = RHI_SAMPLE_COUNT_1_BIT;
-        depth_attachment_description.loadOp = RHI_ATTACHMENT_LOAD_OP_LOAD;
-        depth_attachment_description.storeOp = RHI_ATTACHMENT_STORE_OP_STORE;
+        depth_attachment_description.loadOp = RHI_ATTACHMENT_LOAD_OP_CLEAR; // 深度缓冲区在这一帧之前的内容未定义，需要先清除为1.0再做深度测试
+        depth_attachment_description.storeOp = RHI_ATTACHMENT_STORE_OP_DONT_CARE; // 之后没有pass读取深度，内容不需要写回内存（transient attachment）
         depth_attachment_description.stencilLoadOp = RHI_ATTACHMENT_LOAD_OP_DONT_CARE;
         depth_attachment_description.stencilStoreOp = RHI_ATTACHMENT_STORE_OP_DONT_CARE;
         depth_attachment_description.initialLayout = RHI_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
@@ -102,12 +163,13 @@ namespace Mercury
     }
 
     // 帧缓冲器对象引用所有 VkImageView 对象来表示附件Attachment。
-    void DebugDrawPipeline::setupFramebuffer() {
-        const std::vector<RHIImageView*>&& imageViews = m_rhi->getSwapchainInfo().imageViews;
+    void DebugDrawPipeline::setupFramebuffer(RHIImageView* depth_image_view) {
+        const RHISwapChainDesc& swapchain_info = m_rhi->getSwapchainInfo();
+        const std::vector<RHIImageView*>& imageViews = swapchain_info.imageViews;
         m_framebuffer.framebuffers.resize(imageViews.size());
         for (size_t i = 0; i < m_framebuffer.framebuffers.size(); i++)
         {
-            RHIImageView* attachments[2] = { imageViews[i],m_rhi->getDepthImageInfo().depth_image_view };
+            RHIImageView* attachments[2] = { imageViews[i], depth_image_view };
 
             // https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Framebuffers
             RHIFramebufferCreateInfo framebufferInfo{};
@@ -115,8 +177,8 @@ namespace Mercury
             framebufferInfo.renderPass = m_framebuffer.render_pass;
             framebufferInfo.attachmentCount = sizeof(attachments) / sizeof(attachments[0]);
             framebufferInfo.pAttachments = attachments;
-            framebufferInfo.width = m_rhi->getSwapchainInfo().extent.width;
-            framebufferInfo.height = m_rhi->getSwapchainInfo().extent.height;
+            framebufferInfo.width = swapchain_info.extent.width;
+            framebufferInfo.height = swapchain_info.extent.height;
             framebufferInfo.layers = 1;
 
             if (m_rhi->createFrameBuffer(&framebufferInfo, m_framebuffer.framebuffers[i]) != RHI_SUCCESS) {
@@ -126,24 +188,101 @@ namespace Mercury
 
     }
 
-    // todo
-    void DebugDrawPipeline::setupDescriptorLayout() {}
-
     void DebugDrawPipeline::setupPipelines() {
-        // RHI Shader Module
-        RHIShader* vert_shader_module = m_rhi->createShaderModule(DEBUGDRAW_VERT);
-        RHIShader* frag_shader_module = m_rhi->createShaderModule(DEBUGDRAW_FRAG);
+        // RHI Shader Module，所有变体共用同一组shader，等全部pipeline编译完成后再销毁
+        m_vert_shader_module = m_rhi->createShaderModule(DEBUGDRAW_VERT);
+        m_frag_shader_module = m_rhi->createShaderModule(DEBUGDRAW_FRAG);
+        // 实例化形状的顶点着色器额外读取每个实例的变换，片段着色器与其他变体相同
+        m_shape_vert_shader_module = m_rhi->createShaderModule(DEBUGDRAW_INSTANCE_VERT);
 
+        // 需要在管道创建期间通过创建VkPipelineLayout对象来指定uniform的值。
+        // uniform是类似于动态状态变量的全局变量，可以在绘制时更改这些变量，以更改着色器的行为，而无需重新创建它们。 它们通常用于将变换矩阵传递到顶点着色器，或在片段着色器中创建纹理采样器。
+        RHIPipelineLayoutCreateInfo pipeline_layout_create_info{};
+        pipeline_layout_create_info.sType = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        // debug draw的着色器不使用描述符，顶点着色器中的proj_view_matrix通过push constant传入
+        pipeline_layout_create_info.setLayoutCount = 0;
+        RHIPushConstantRange push_constant_range{};
+        push_constant_range.stageFlags = RHI_SHADER_STAGE_VERTEX_BIT;
+        push_constant_range.offset = 0;
+        push_constant_range.size = sizeof(float) * 16;
+        pipeline_layout_create_info.pushConstantRangeCount = 1;
+        pipeline_layout_create_info.pPushConstantRanges = &push_constant_range;
+        RHIPipelineLayout* pipeline_layout = nullptr;
+        if (m_rhi->createPipelineLayout(&pipeline_layout_create_info, pipeline_layout) != RHI_SUCCESS)
+        {
+            throw std::runtime_error("create debug draw pipeline layout");
+        }
+
+        m_render_pipelines.resize(_debug_draw_pipeline_type_count);
+        for (DebugDrawPipelineBase& render_pipeline : m_render_pipelines)
+        {
+            render_pipeline.layout = pipeline_layout;
+        }
+
+        // 各个变体只有图元拓扑和深度测试不同：先编译带ALLOW_DERIVATIVES的基础pipeline，
+        // 其余变体作为它的派生pipeline，驱动可以复用基础pipeline的编译结果
+        // https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#pipelines-pipeline-derivatives
+        // 派生pipeline的任务在基础pipeline编译完成后才由基础任务提交，工作线程从不阻塞等待其他任务，
+        // 任务数量多于工作线程时也不会占满所有线程而死锁。派生任务的结果通过预先创建的promise交给waitForPipelines
+        std::shared_ptr<PipelineBuildService> build_service = g_runtime_global_context.m_render_system->getPipelineBuildService();
+        std::vector<DebugDrawPipelineType> derivative_pipeline_types;
+        for (uint8_t i = 0; i < _debug_draw_pipeline_type_count; i++)
+        {
+            if ((DebugDrawPipelineType)i != k_base_pipeline_type)
+            {
+                derivative_pipeline_types.push_back((DebugDrawPipelineType)i);
+            }
+        }
+        auto derivative_promises = std::make_shared<std::vector<std::promise<void>>>(derivative_pipeline_types.size());
+        for (std::promise<void>& promise : *derivative_promises)
+        {
+            m_pipeline_futures.push_back(promise.get_future().share());
+        }
+
+        m_pipeline_futures.push_back(build_service->submit([this, build_service, derivative_pipeline_types, derivative_promises]() {
+            try
+            {
+                createPipeline(k_base_pipeline_type);
+            }
+            catch (...)
+            {
+                // 基础pipeline失败时派生pipeline也无法创建，把同一个异常交给所有等待者
+                for (std::promise<void>& promise : *derivative_promises)
+                {
+                    promise.set_exception(std::current_exception());
+                }
+                throw;
+            }
+
+            for (size_t i = 0; i < derivative_pipeline_types.size(); ++i)
+            {
+                DebugDrawPipelineType pipeline_type = derivative_pipeline_types[i];
+                build_service->submit([this, pipeline_type, derivative_promises, i]() {
+                    try
+                    {
+                        createPipeline(pipeline_type);
+                        (*derivative_promises)[i].set_value();
+                    }
+                    catch (...)
+                    {
+                        (*derivative_promises)[i].set_exception(std::current_exception());
+                    }
+                });
+            }
+        }).share());
+    }
+
+    void DebugDrawPipeline::createPipeline(DebugDrawPipelineType pipeline_type) {
         RHIPipelineShaderStageCreateInfo vert_pipeline_shader_stage_create_info{};
         vert_pipeline_shader_stage_create_info.sType = RHI_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         vert_pipeline_shader_stage_create_info.stage = RHI_SHADER_STAGE_VERTEX_BIT;
-        vert_pipeline_shader_stage_create_info.module = vert_shader_module;
+        vert_pipeline_shader_stage_create_info.module = m_vert_shader_module;
         vert_pipeline_shader_stage_create_info.pName = "main";
 
         RHIPipelineShaderStageCreateInfo frag_pipeline_shader_stage_create_info{};
         frag_pipeline_shader_stage_create_info.sType = RHI_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         frag_pipeline_shader_stage_create_info.stage = RHI_SHADER_STAGE_FRAGMENT_BIT;
-        frag_pipeline_shader_stage_create_info.module = frag_shader_module;
+        frag_pipeline_shader_stage_create_info.module = m_frag_shader_module;
         frag_pipeline_shader_stage_create_info.pName = "main";
 
         RHIPipelineShaderStageCreateInfo shader_stages[] = { vert_pipeline_shader_stage_create_info,
@@ -155,10 +294,15 @@ namespace Mercury
         // 它大致用两种方式描述: Bindings: 数据之间的间距以及数据是每个顶点还是每个实例(参见实例)。Attribute description: 传递给顶点着色器的属性的类型，从哪个绑定来加载它们以及在哪个偏移量
         RHIPipelineVertexInputStateCreateInfo vertexInputInfo{};
         vertexInputInfo.sType = RHI_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputInfo.vertexBindingDescriptionCount = 0;
-        vertexInputInfo.pVertexBindingDescriptions = nullptr; // todo DebugDrawVertex::getBindingDescriptions();
-        vertexInputInfo.vertexAttributeDescriptionCount = 0;
-        vertexInputInfo.pVertexAttributeDescriptions = nullptr; // todo DebugDrawVertex::getAttributeDescriptions();
+        std::array<RHIVertexInputBindingDescription, 2> vertex_binding_descriptions = DebugDrawVertex::getBindingDescriptions();
+        std::array<RHIVertexInputAttributeDescription, 2> vertex_attribute_descriptions = DebugDrawVertex::getAttributeDescriptions();
+        vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(vertex_binding_descriptions.size());
+        vertexInputInfo.pVertexBindingDescriptions = vertex_binding_descriptions.data();
+        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertex_attribute_descriptions.size());
+        vertexInputInfo.pVertexAttributeDescriptions = vertex_attribute_descriptions.data();
+        // 实例化形状：binding 0是单位网格的顶点，binding 1是逐实例的变换和颜色
+        std::array<RHIVertexInputBindingDescription, 2> shape_binding_descriptions = DebugDrawShapeInstance::getBindingDescriptions();
+        std::array<RHIVertexInputAttributeDescription, 6> shape_attribute_descriptions = DebugDrawShapeInstance::getAttributeDescriptions();
 
         // VkPipelineInputAssemblyStateCreateInfo描述了两件事: 从顶点绘制什么样的几何图形，以及是否应该启用原语重启
         RHIPipelineInputAssemblyStateCreateInfo inputAssembly{};
@@ -171,9 +315,9 @@ namespace Mercury
         RHIPipelineViewportStateCreateInfo viewportState{};
         viewportState.sType = RHI_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
         viewportState.viewportCount = 1;
-        viewportState.pViewports = m_rhi->getSwapchainInfo().viewport;
+        viewportState.pViewports = nullptr; // viewport和scissor是动态状态，这里的值会被忽略，由绘制时的cmdSetViewport/cmdSetScissor指定
         viewportState.scissorCount = 1;
-        viewportState.pScissors = m_rhi->getSwapchainInfo().scissor;
+        viewportState.pScissors = nullptr;
 
         // 光栅化器从顶点着色器获取顶点形成的几何图形，并将其转换为片段，由片段着色器着色。
         // 它还可以执行深度测试、面部剔除和剪刀测试，并且可以配置为输出填充整个多边形或只填充边缘的片段(线框渲染)。
@@ -185,7 +329,7 @@ namespace Mercury
         rasterizer.rasterizerDiscardEnable = RHI_FALSE; //TURE时，几何图形将永远不会通过光栅化阶段。这基本上禁用了对 framebuffer 的任何输出。
         rasterizer.polygonMode = RHI_POLYGON_MODE_FILL; // 确定如何为几何生成片段(填充、线框、顶点)
         rasterizer.lineWidth = 1.0f;
-        rasterizer.cullMode = RHI_CULL_MODE_BACK_BIT; // 确定面剔除类型（不剔除、正、背、二者均剔除）
+        rasterizer.cullMode = RHI_CULL_MODE_NONE; // 确定面剔除类型（不剔除、正、背、二者均剔除）。debug三角形的绕序不确定，不做剔除
         rasterizer.frontFace = RHI_FRONT_FACE_CLOCKWISE; // 指定了面的顶点顺序，这些面可以是正面的，也可以是顺时针或逆时针方向的。
         rasterizer.depthBiasEnable = RHI_FALSE; // 光栅化器可以通过增加一个常数值或者根据碎片的斜率来改变深度值。这有时用于阴影映射
         rasterizer.depthBiasConstantFactor = 0.0f;
@@ -247,18 +391,45 @@ namespace Mercury
         dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
         dynamicState.pDynamicStates = dynamicStates.data();
 
-        // 需要在管道创建期间通过创建VkPipelineLayout对象来指定uniform的值。
-        // uniform是类似于动态状态变量的全局变量，可以在绘制时更改这些变量，以更改着色器的行为，而无需重新创建它们。 它们通常用于将变换矩阵传递到顶点着色器，或在片段着色器中创建纹理采样器。
-        RHIPipelineLayoutCreateInfo pipeline_layout_create_info{};
-        pipeline_layout_create_info.sType = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipeline_layout_create_info.setLayoutCount = 0;
-        // pipeline_layout_create_info.pSetLayouts = &m_descriptor_layout; // todo set layout descriptor
-        pipeline_layout_create_info.pushConstantRangeCount = 0;
-        pipeline_layout_create_info.pPushConstantRanges = nullptr;
-        m_render_pipelines.resize(1);
-        if (m_rhi->createPipelineLayout(&pipeline_layout_create_info, m_render_pipelines[0].layout) != RHI_SUCCESS)
+
+        switch (pipeline_type)
         {
-            throw std::runtime_error("create mesh inefficient pick pipeline layout");
+        case _debug_draw_pipeline_type_point:
+            inputAssembly.topology = RHI_PRIMITIVE_TOPOLOGY_POINT_LIST;
+            break;
+        case _debug_draw_pipeline_type_line:
+            inputAssembly.topology = RHI_PRIMITIVE_TOPOLOGY_LINE_LIST;
+            break;
+        case _debug_draw_pipeline_type_triangle:
+            inputAssembly.topology = RHI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+            break;
+        case _debug_draw_pipeline_type_point_no_depth_test:
+            inputAssembly.topology = RHI_PRIMITIVE_TOPOLOGY_POINT_LIST;
+            depth_stencil_create_info.depthTestEnable = RHI_FALSE;
+            break;
+        case _debug_draw_pipeline_type_line_no_depth_test:
+            inputAssembly.topology = RHI_PRIMITIVE_TOPOLOGY_LINE_LIST;
+            depth_stencil_create_info.depthTestEnable = RHI_FALSE;
+            break;
+        case _debug_draw_pipeline_type_triangle_no_depth_test:
+            inputAssembly.topology = RHI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+            depth_stencil_create_info.depthTestEnable = RHI_FALSE;
+            break;
+        case _debug_draw_pipeline_type_shape:
+        case _debug_draw_pipeline_type_shape_no_depth_test:
+            inputAssembly.topology = RHI_PRIMITIVE_TOPOLOGY_LINE_LIST;
+            if (pipeline_type == _debug_draw_pipeline_type_shape_no_depth_test)
+            {
+                depth_stencil_create_info.depthTestEnable = RHI_FALSE;
+            }
+            shader_stages[0].module = m_shape_vert_shader_module;
+            vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(shape_binding_descriptions.size());
+            vertexInputInfo.pVertexBindingDescriptions = shape_binding_descriptions.data();
+            vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(shape_attribute_descriptions.size());
+            vertexInputInfo.pVertexAttributeDescriptions = shape_attribute_descriptions.data();
+            break;
+        default:
+            break;
         }
 
         // graphics pipeline create 
@@ -273,65 +444,40 @@ namespace Mercury
         pipelineInfo.pMultisampleState = &multisampling;
         pipelineInfo.pColorBlendState = &colorBlending;
         pipelineInfo.pDepthStencilState = &depth_stencil_create_info;
-        pipelineInfo.layout = m_render_pipelines[0].layout;
+        pipelineInfo.layout = m_render_pipelines[pipeline_type].layout;
         pipelineInfo.renderPass = m_framebuffer.render_pass;
         pipelineInfo.subpass = 0;
-        pipelineInfo.basePipelineHandle = RHI_NULL_HANDLE;
         pipelineInfo.pDynamicState = &dynamicState;
-
-        switch (m_pipeline_type)
+        if (pipeline_type == k_base_pipeline_type)
         {
-        case _debug_draw_pipeline_type_point:
-            inputAssembly.topology = RHI_PRIMITIVE_TOPOLOGY_POINT_LIST;
-            break;
-        case _debug_draw_pipeline_type_line:
-        {
-            inputAssembly.topology = RHI_PRIMITIVE_TOPOLOGY_LINE_LIST;
-        }
-        case _debug_draw_pipeline_type_triangle:
-        {
-            inputAssembly.topology = RHI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-        }
-        case _debug_draw_pipeline_type_point_no_depth_test:
-        {
-            inputAssembly.topology = RHI_PRIMITIVE_TOPOLOGY_POINT_LIST;
-            depth_stencil_create_info.depthTestEnable = RHI_FALSE;
+            pipelineInfo.flags = RHI_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT;
+            pipelineInfo.basePipelineHandle = RHI_NULL_HANDLE;
         }
-        case _debug_draw_pipeline_type_line_no_depth_test:
+        else
         {
-            inputAssembly.topology = RHI_PRIMITIVE_TOPOLOGY_LINE_LIST;
-            depth_stencil_create_info.depthTestEnable = RHI_FALSE;
-        }
-        case _debug_draw_pipeline_type_triangle_no_depth_test:
-        {
-            inputAssembly.topology = RHI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-            depth_stencil_create_info.depthTestEnable = RHI_FALSE;
-        }
-        default:
-            break;
+            pipelineInfo.flags = RHI_PIPELINE_CREATE_DERIVATIVE_BIT;
+            pipelineInfo.basePipelineHandle = m_render_pipelines[k_base_pipeline_type].pipeline;
         }
+        pipelineInfo.basePipelineIndex = -1;
 
         if (m_rhi->createGraphicsPipelines(
-            RHI_NULL_HANDLE,
+            m_rhi->getPipelineCache(),
             1,
             &pipelineInfo,
-            m_render_pipelines[0].pipeline
+            m_render_pipelines[pipeline_type].pipeline
         ) != RHI_SUCCESS) {
             throw std::runtime_error("create debug draw graphics pipeline");
         }
-
-        m_rhi->destroyShaderModule(vert_shader_module);
-        m_rhi->destroyShaderModule(frag_shader_module);
     }
 
-    void DebugDrawPipeline::recreateAfterSwapchain()
+    void DebugDrawPipeline::recreateAfterSwapchain(RHIImageView* depth_image_view)
     {
         for (auto framebuffer : m_framebuffer.framebuffers)
         {
             m_rhi->destroyFramebuffer(framebuffer);
         }
 
-        setupFramebuffer();
+        setupFramebuffer(depth_image_view);
     }
 
     const DebugDrawFramebuffer& DebugDrawPipeline::getFramebuffer() const
@@ -339,8 +485,8 @@ namespace Mercury
         return m_framebuffer;
     }
 
-    const DebugDrawPipelineBase& DebugDrawPipeline::getPipeline() const
+    const DebugDrawPipelineBase& DebugDrawPipeline::getPipeline(DebugDrawPipelineType pipeline_type) const
     {
-        return m_render_pipelines[0];
+        return m_render_pipelines[pipeline_type];
     }
 } // namespace Mercury
@@ -3,6 +3,8 @@
 #include "runtime/function/render/interface/rhi.h"
 #include "runtime/function/render/interface/rhi_struct.h"
 
+#include <future>
+
 namespace Mercury
 {
     // 枚举debug的类型
@@ -14,9 +16,15 @@ namespace Mercury
         _debug_draw_pipeline_type_point_no_depth_test,
         _debug_draw_pipeline_type_line_no_depth_test,
         _debug_draw_pipeline_type_triangle_no_depth_test,
+        // 实例化绘制的线框形状（box、sphere、capsule、arrow），顶点来自单位网格，见DebugDrawShapeMeshes
+        _debug_draw_pipeline_type_shape,
+        _debug_draw_pipeline_type_shape_no_depth_test,
         _debug_draw_pipeline_type_count,
     };
 
+    // 前面这些pipeline类型的顶点由CPU逐帧生成，以顶点流的形式上传
+    static constexpr uint8_t k_debug_draw_vertex_stream_count = _debug_draw_pipeline_type_shape;
+
     // debug draw pipeline的基本结构体
     struct DebugDrawPipelineBase
     {
@@ -27,7 +35,7 @@ namespace Mercury
     struct DebugDrawFrameBufferAttachment
     {
         RHIImage* image = nullptr;
-        RHIDeviceMemory* mem = nullptr;
+        RHIAllocation* allocation = nullptr;
         RHIImageView* view = nullptr;
         RHIFormat format;
     };
@@ -40,25 +48,35 @@ namespace Mercury
         std::vector <DebugDrawFrameBufferAttachment> attachments;
     };
 
+    // 所有debug draw变体共用一个render pass、framebuffer和pipeline layout，
+    // 每种图元拓扑/深度测试组合对应一个pipeline，其中非基础变体是基础pipeline的派生pipeline
     class DebugDrawPipeline {
     public:
-        DebugDrawPipelineType m_pipeline_type;
-        DebugDrawPipeline(DebugDrawPipelineType pipelineType) { m_pipeline_type = pipelineType; }
         void initilialize();
+        // 释放render pass、framebuffer和还没销毁的shader module；pipeline和layout由RHI持有。需要在设备空闲时调用
+        void clear();
+        // 等待后台线程上的pipeline编译完成，编译中抛出的异常会在这里重新抛出
+        void waitForPipelines();
         void setupAttachments();
         void setupRenderPass();
-        void setupFramebuffer();
-        void setupDescriptorLayout();
-        void recreateAfterSwapchain();
+        // 颜色attachment为swapchain image，深度attachment由调用者（render graph）提供
+        void setupFramebuffer(RHIImageView* depth_image_view);
+        void recreateAfterSwapchain(RHIImageView* depth_image_view);
         const DebugDrawFramebuffer &getFramebuffer() const;
-        const DebugDrawPipelineBase &getPipeline() const;
+        const DebugDrawPipelineBase &getPipeline(DebugDrawPipelineType pipeline_type) const;
 
     private:
+        static constexpr DebugDrawPipelineType k_base_pipeline_type = _debug_draw_pipeline_type_triangle;
+
         void setupPipelines();
+        void createPipeline(DebugDrawPipelineType pipeline_type);
         std::shared_ptr<RHI> m_rhi;
-        RHIDescriptorSetLayout* m_descriptor_layout;
         std::vector<DebugDrawPipelineBase> m_render_pipelines;
         DebugDrawFramebuffer m_framebuffer;
+        RHIShader* m_vert_shader_module = nullptr;
+        RHIShader* m_frag_shader_module = nullptr;
+        RHIShader* m_shape_vert_shader_module = nullptr;
+        std::vector<std::shared_future<void>> m_pipeline_futures;
 
         //todo math 
         // Matrix4x4 m_proj_view_matrix;
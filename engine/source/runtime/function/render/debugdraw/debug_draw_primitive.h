@@ -0,0 +1,64 @@
+#pragma once
+
+#include "runtime/core/math/vector3.h"
+#include "runtime/function/render/interface/rhi_struct.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace Mercury
+{
+    struct DebugDrawColor
+    {
+        float r{ 1.f };
+        float g{ 1.f };
+        float b{ 1.f };
+        float a{ 1.f };
+
+        // 打包为R8G8B8A8_UNORM，每个顶点的颜色只占4字节
+        uint32_t pack() const
+        {
+            auto to_unorm8 = [](float value) { return static_cast<uint32_t>(std::clamp(value, 0.f, 1.f) * 255.f + 0.5f); };
+            return to_unorm8(r) | (to_unorm8(g) << 8) | (to_unorm8(b) << 16) | (to_unorm8(a) << 24);
+        }
+    };
+
+    /*
+    * debug draw的顶点按SoA存储和上传：位置和颜色分别是两个连续的数组，对应两个vertex binding，
+    * 每帧只需要两次memcpy就能把所有图元写入流式顶点缓冲区。
+    */
+    struct DebugDrawVertex
+    {
+        static constexpr uint32_t k_position_binding = 0;
+        static constexpr uint32_t k_color_binding = 1;
+
+        static std::array<RHIVertexInputBindingDescription, 2> getBindingDescriptions()
+        {
+            std::array<RHIVertexInputBindingDescription, 2> binding_descriptions{};
+            binding_descriptions[0].binding = k_position_binding;
+            binding_descriptions[0].stride = sizeof(Vector3);
+            binding_descriptions[0].inputRate = RHI_VERTEX_INPUT_RATE_VERTEX;
+            binding_descriptions[1].binding = k_color_binding;
+            binding_descriptions[1].stride = sizeof(uint32_t);
+            binding_descriptions[1].inputRate = RHI_VERTEX_INPUT_RATE_VERTEX;
+            return binding_descriptions;
+        }
+
+        static std::array<RHIVertexInputAttributeDescription, 2> getAttributeDescriptions()
+        {
+            std::array<RHIVertexInputAttributeDescription, 2> attribute_descriptions{};
+            // layout(location = 0) in vec3 inPosition
+            attribute_descriptions[0].location = 0;
+            attribute_descriptions[0].binding = k_position_binding;
+            attribute_descriptions[0].format = RHI_FORMAT_R32G32B32_SFLOAT;
+            attribute_descriptions[0].offset = 0;
+            // layout(location = 1) in vec4 inColor
+            attribute_descriptions[1].location = 1;
+            attribute_descriptions[1].binding = k_color_binding;
+            attribute_descriptions[1].format = RHI_FORMAT_R8G8B8A8_UNORM;
+            attribute_descriptions[1].offset = 0;
+            return attribute_descriptions;
+        }
+    };
+} // namespace Mercury
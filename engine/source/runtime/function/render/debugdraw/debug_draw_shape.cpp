@@ -0,0 +1,179 @@
+#include "runtime/function/render/debugdraw/debug_draw_shape.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace Mercury
+{
+    namespace
+    {
+        constexpr uint32_t k_circle_segment_count = 32;
+        constexpr float k_pi = 3.14159265358979f;
+
+        // 构建单位网格时使用的临时数据，顶点为(x, y, z, cap_sign)
+        struct ShapeMeshBuilder
+        {
+            std::vector<float> vertices;
+            std::vector<uint16_t> indices;
+            uint32_t mesh_first_vertex{ 0 };
+
+            uint16_t addVertex(float x, float y, float z, float cap_sign = 0.f)
+            {
+                uint32_t index = static_cast<uint32_t>(vertices.size() / 4) - mesh_first_vertex;
+                vertices.insert(vertices.end(), { x, y, z, cap_sign });
+                return static_cast<uint16_t>(index);
+            }
+
+            void addLine(uint16_t index0, uint16_t index1)
+            {
+                indices.push_back(index0);
+                indices.push_back(index1);
+            }
+
+            // 沿[begin_angle, end_angle]的圆弧，point(angle)返回圆弧上的点
+            template<typename PointFunc>
+            void addArc(float begin_angle, float end_angle, uint32_t segment_count, float cap_sign, PointFunc point)
+            {
+                uint16_t previous = 0;
+                for (uint32_t i = 0; i <= segment_count; ++i)
+                {
+                    Vector3 p = point(begin_angle + (end_angle - begin_angle) * i / segment_count);
+                    uint16_t current = addVertex(p.x, p.y, p.z, cap_sign);
+                    if (i > 0)
+                    {
+                        addLine(previous, current);
+                    }
+                    previous = current;
+                }
+            }
+
+            DebugDrawShapeMesh beginMesh()
+            {
+                mesh_first_vertex = static_cast<uint32_t>(vertices.size() / 4);
+                DebugDrawShapeMesh mesh;
+                mesh.first_index = static_cast<uint32_t>(indices.size());
+                mesh.vertex_offset = static_cast<int32_t>(mesh_first_vertex);
+                return mesh;
+            }
+
+            void endMesh(DebugDrawShapeMesh& mesh) const
+            {
+                mesh.index_count = static_cast<uint32_t>(indices.size()) - mesh.first_index;
+            }
+        };
+
+        void buildBox(ShapeMeshBuilder& builder)
+        {
+            for (uint32_t i = 0; i < 8; ++i)
+            {
+                builder.addVertex((i & 1) ? 1.f : -1.f, (i & 2) ? 1.f : -1.f, (i & 4) ? 1.f : -1.f);
+            }
+            // 12条棱：沿x、y、z方向各4条
+            static constexpr uint16_t k_box_edges[24] = {
+                0, 1, 2, 3, 4, 5, 6, 7,
+                0, 2, 1, 3, 4, 6, 5, 7,
+                0, 4, 1, 5, 2, 6, 3, 7,
+            };
+            builder.indices.insert(builder.indices.end(), std::begin(k_box_edges), std::end(k_box_edges));
+        }
+
+        void buildSphere(ShapeMeshBuilder& builder)
+        {
+            // XY、YZ、XZ三个平面上的圆
+            builder.addArc(0.f, 2.f * k_pi, k_circle_segment_count, 0.f, [](float a) { return Vector3(std::cos(a), std::sin(a), 0.f); });
+            builder.addArc(0.f, 2.f * k_pi, k_circle_segment_count, 0.f, [](float a) { return Vector3(0.f, std::cos(a), std::sin(a)); });
+            builder.addArc(0.f, 2.f * k_pi, k_circle_segment_count, 0.f, [](float a) { return Vector3(std::cos(a), 0.f, std::sin(a)); });
+        }
+
+        void buildCapsule(ShapeMeshBuilder& builder)
+        {
+            for (float cap_sign : { 1.f, -1.f })
+            {
+                // 半球与圆柱相接处的圆，以及XY、YZ平面上的两条半圆弧
+                builder.addArc(0.f, 2.f * k_pi, k_circle_segment_count, cap_sign, [](float a) { return Vector3(std::cos(a), 0.f, std::sin(a)); });
+                builder.addArc(0.f, k_pi, k_circle_segment_count / 2, cap_sign, [cap_sign](float a) { return Vector3(std::cos(a), cap_sign * std::sin(a), 0.f); });
+                builder.addArc(0.f, k_pi, k_circle_segment_count / 2, cap_sign, [cap_sign](float a) { return Vector3(0.f, cap_sign * std::sin(a), std::cos(a)); });
+            }
+            // 圆柱侧面的4条母线
+            static constexpr float k_side_points[4][2] = { { 1.f, 0.f }, { -1.f, 0.f }, { 0.f, 1.f }, { 0.f, -1.f } };
+            for (const float* side_point : k_side_points)
+            {
+                uint16_t top = builder.addVertex(side_point[0], 0.f, side_point[1], 1.f);
+                uint16_t bottom = builder.addVertex(side_point[0], 0.f, side_point[1], -1.f);
+                builder.addLine(top, bottom);
+            }
+        }
+
+        void buildArrow(ShapeMeshBuilder& builder)
+        {
+            constexpr float k_head_length = 0.2f;
+            constexpr float k_head_radius = 0.08f;
+
+            uint16_t origin = builder.addVertex(0.f, 0.f, 0.f);
+            uint16_t tip = builder.addVertex(0.f, 1.f, 0.f);
+            builder.addLine(origin, tip);
+
+            // 箭头是一个四棱锥：4条从尖端出发的斜边和底面的正方形
+            uint16_t head_base[4] = {
+                builder.addVertex(k_head_radius, 1.f - k_head_length, 0.f),
+                builder.addVertex(0.f, 1.f - k_head_length, k_head_radius),
+                builder.addVertex(-k_head_radius, 1.f - k_head_length, 0.f),
+                builder.addVertex(0.f, 1.f - k_head_length, -k_head_radius),
+            };
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                builder.addLine(tip, head_base[i]);
+                builder.addLine(head_base[i], head_base[(i + 1) % 4]);
+            }
+        }
+    } // namespace
+
+    void DebugDrawShapeMeshes::initialize(std::shared_ptr<RHI> rhi)
+    {
+        m_rhi = rhi;
+
+        ShapeMeshBuilder builder;
+        using BuildFunc = void (*)(ShapeMeshBuilder&);
+        static constexpr BuildFunc k_build_funcs[_debug_draw_shape_type_count] = { buildBox, buildSphere, buildCapsule, buildArrow };
+        for (uint8_t i = 0; i < _debug_draw_shape_type_count; i++)
+        {
+            m_meshes[i] = builder.beginMesh();
+            k_build_funcs[i](builder);
+            builder.endMesh(m_meshes[i]);
+        }
+
+        RHIDeviceSize vertex_size = builder.vertices.size() * sizeof(float);
+        RHIDeviceSize index_size = builder.indices.size() * sizeof(uint16_t);
+        m_index_offset = vertex_size;
+
+        // 网格只写一次、每帧都要读，放在device local内存里，由上传管理器经传输队列写入；
+        // 第一次使用它的那一帧的图形提交会等待这次上传完成
+        RHIBufferCreateInfo buffer_create_info{};
+        buffer_create_info.sType = RHI_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_create_info.size = vertex_size + index_size;
+        buffer_create_info.usage = RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT | RHI_BUFFER_USAGE_INDEX_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT;
+        buffer_create_info.sharingMode = RHI_SHARING_MODE_EXCLUSIVE;
+
+        RHIAllocationCreateInfo allocation_create_info{};
+        allocation_create_info.usage = RHI_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+        if (!m_rhi->createBuffer(&buffer_create_info, &allocation_create_info, m_buffer, m_allocation, nullptr))
+        {
+            throw std::runtime_error("create debug draw shape mesh buffer");
+        }
+
+        m_rhi->uploadBuffer(m_buffer, 0, builder.vertices.data(), vertex_size);
+        m_rhi->uploadBuffer(m_buffer, m_index_offset, builder.indices.data(), index_size);
+    }
+
+    void DebugDrawShapeMeshes::clear()
+    {
+        if (m_buffer != nullptr)
+        {
+            m_rhi->destroyBuffer(m_buffer, m_allocation);
+            m_buffer = nullptr;
+            m_allocation = nullptr;
+        }
+    }
+} // namespace Mercury
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "runtime/function/render/interface/rhi.h"
+#include "runtime/function/render/debugdraw/debug_draw_primitive.h"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+
+namespace Mercury
+{
+    // 用实例化绘制的debug形状，每种形状在GPU上只有一份单位网格
+    enum DebugDrawShapeType : uint8_t
+    {
+        _debug_draw_shape_type_box = 0,
+        _debug_draw_shape_type_sphere,
+        _debug_draw_shape_type_capsule,
+        _debug_draw_shape_type_arrow,
+        _debug_draw_shape_type_count,
+    };
+
+    // 实例按(是否关闭深度测试, 形状)分批，每批对应一次instanced draw call
+    static constexpr uint32_t k_debug_draw_shape_batch_count = _debug_draw_shape_type_count * 2;
+
+    inline uint32_t getDebugDrawShapeBatch(DebugDrawShapeType shape_type, bool no_depth_test)
+    {
+        return (no_depth_test ? _debug_draw_shape_type_count : 0) + shape_type;
+    }
+
+    /*
+    * 每个实例的数据：3x4的仿射变换（按行存放，单位网格 -> 世界空间）、胶囊体两端半球沿局部y轴的偏移以及颜色。
+    * 单位网格顶点的w分量为+1/-1/0，着色器中把w * cap_offset加到局部y上，一份胶囊网格就能表示任意长度。
+    */
+    struct DebugDrawShapeInstance
+    {
+        static constexpr uint32_t k_mesh_binding = 0;
+        static constexpr uint32_t k_instance_binding = 1;
+
+        float transform_rows[3][4];
+        float cap_offset{ 0.f };
+        uint32_t color{ 0 };
+
+        static std::array<RHIVertexInputBindingDescription, 2> getBindingDescriptions()
+        {
+            std::array<RHIVertexInputBindingDescription, 2> binding_descriptions{};
+            binding_descriptions[0].binding = k_mesh_binding;
+            binding_descriptions[0].stride = sizeof(float) * 4;
+            binding_descriptions[0].inputRate = RHI_VERTEX_INPUT_RATE_VERTEX;
+            // https://vulkan-tutorial.com/Vertex_buffers/Vertex_input_description#page_Binding-descriptions
+            // INSTANCE表示每绘制一个实例才前进到下一个元素
+            binding_descriptions[1].binding = k_instance_binding;
+            binding_descriptions[1].stride = sizeof(DebugDrawShapeInstance);
+            binding_descriptions[1].inputRate = RHI_VERTEX_INPUT_RATE_INSTANCE;
+            return binding_descriptions;
+        }
+
+        static std::array<RHIVertexInputAttributeDescription, 6> getAttributeDescriptions()
+        {
+            std::array<RHIVertexInputAttributeDescription, 6> attribute_descriptions{};
+            // layout(location = 0) in vec4 inPosition
+            attribute_descriptions[0].location = 0;
+            attribute_descriptions[0].binding = k_mesh_binding;
+            attribute_descriptions[0].format = RHI_FORMAT_R32G32B32A32_SFLOAT;
+            attribute_descriptions[0].offset = 0;
+            // layout(location = 1~3) in vec4 inTransformRow0~2
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                attribute_descriptions[1 + i].location = 1 + i;
+                attribute_descriptions[1 + i].binding = k_instance_binding;
+                attribute_descriptions[1 + i].format = RHI_FORMAT_R32G32B32A32_SFLOAT;
+                attribute_descriptions[1 + i].offset = sizeof(float) * 4 * i;
+            }
+            // layout(location = 4) in float inCapOffset
+            attribute_descriptions[4].location = 4;
+            attribute_descriptions[4].binding = k_instance_binding;
+            attribute_descriptions[4].format = RHI_FORMAT_R32_SFLOAT;
+            attribute_descriptions[4].offset = offsetof(DebugDrawShapeInstance, cap_offset);
+            // layout(location = 5) in vec4 inColor
+            attribute_descriptions[5].location = 5;
+            attribute_descriptions[5].binding = k_instance_binding;
+            attribute_descriptions[5].format = RHI_FORMAT_R8G8B8A8_UNORM;
+            attribute_descriptions[5].offset = offsetof(DebugDrawShapeInstance, color);
+            return attribute_descriptions;
+        }
+    };
+    static_assert(sizeof(DebugDrawShapeInstance) == 56, "DebugDrawShapeInstance must match the instance vertex binding stride");
+
+    // 单位网格在共享缓冲区中的位置
+    struct DebugDrawShapeMesh
+    {
+        uint32_t first_index{ 0 };
+        uint32_t index_count{ 0 };
+        int32_t vertex_offset{ 0 };
+    };
+
+    /*
+    * 所有形状的单位网格（线框，LINE_LIST）放在同一个buffer里：前半部分是顶点，后半部分是16位索引。
+    * 网格只在初始化时写入一次，之后每帧只上传实例数据。
+    * box：[-1,1]^3的立方体；sphere：半径1的三个正交圆；capsule：半径1、沿y轴的胶囊体，两端半球由cap_offset撑开；
+    * arrow：从原点指向(0,1,0)的箭头。
+    */
+    class DebugDrawShapeMeshes
+    {
+    public:
+        void initialize(std::shared_ptr<RHI> rhi);
+        void clear();
+
+        const DebugDrawShapeMesh& getMesh(DebugDrawShapeType shape_type) const { return m_meshes[shape_type]; }
+        RHIBuffer* getBuffer() const { return m_buffer; }
+        RHIDeviceSize getIndexOffset() const { return m_index_offset; }
+
+    private:
+        std::shared_ptr<RHI> m_rhi;
+        RHIBuffer* m_buffer{ nullptr };
+        RHIAllocation* m_allocation{ nullptr };
+        RHIDeviceSize m_index_offset{ 0 };
+        DebugDrawShapeMesh m_meshes[_debug_draw_shape_type_count];
+    };
+} // namespace Mercury
@@ -2,6 +2,7 @@
 
 #define GLFW_INCLUDE_VULKAN
 
+#include <filesystem>
 #include <memory>
 #include <functional>
 #include "runtime/function/render/window_system.h"
@@ -11,6 +12,8 @@ namespace Mercury
     struct RHIInitInfo
     {
         std::shared_ptr<WindowSystem> window_system;
+        std::filesystem::path pipeline_cache_path; // 为空时不从磁盘加载/保存pipeline cache
+        uint32_t command_recording_worker_count{ 1 }; // 并行录制命令的线程数，每个线程每帧各有一个command pool
     };
 
     class RHI {
@@ -25,37 +28,127 @@ namespace Mercury
         virtual void createFramebufferImageAndView() = 0;
         virtual void createCommandPool() = 0;
         virtual RHIShader* createShaderModule(const std::vector<unsigned char>& shader_code) = 0;
+        // 描述符set layout和pipeline layout按内容缓存，内容相同时返回同一个对象，不同pipeline之间的描述符set因此保持兼容，
+        // 切换pipeline时不需要重新绑定。返回的对象由RHI持有，在destroyDevice时销毁
+        virtual bool createDescriptorSetLayout(const RHIDescriptorSetLayoutCreateInfo* pCreateInfo, RHIDescriptorSetLayout*& pSetLayout) = 0;
         virtual bool createPipelineLayout(const RHIPipelineLayoutCreateInfo* pCreateInfo, RHIPipelineLayout*& pPipelineLayout) = 0;
+        // sampler同样按内容缓存并由RHI持有，可以直接用作immutable sampler
+        virtual bool createSampler(const RHISamplerCreateInfo* pCreateInfo, RHISampler*& pSampler) = 0;
         virtual bool createRenderPass(const RHIRenderPassCreateInfo* pCreateInfo, RHIRenderPass*& pRenderPass) = 0;
         virtual bool createFrameBuffer(const RHIFramebufferCreateInfo* pCreateInfo, RHIFramebuffer*& pFramebuffer) = 0;
         virtual bool createGraphicsPipelines(RHIPipelineCache* pipelineCache, uint32_t createInfoCount, const RHIGraphicsPipelineCreateInfo* pCreateInfos, RHIPipeline*& pPipelines) = 0;
+        // 创建的pipeline由RHI持有，在destroyDevice时销毁
+        virtual bool createComputePipelines(RHIPipelineCache* pipelineCache, uint32_t createInfoCount, const RHIComputePipelineCreateInfo* pCreateInfos, RHIPipeline*& pPipelines) = 0;
+        virtual bool createBuffer(const RHIBufferCreateInfo* pCreateInfo, const RHIAllocationCreateInfo* pAllocationCreateInfo, RHIBuffer*& pBuffer, RHIAllocation*& pAllocation, RHIAllocationInfo* pAllocationInfo) = 0;
+        virtual bool createImage(const RHIImageCreateInfo* pCreateInfo, const RHIAllocationCreateInfo* pAllocationCreateInfo, RHIImage*& pImage, RHIAllocation*& pAllocation, RHIAllocationInfo* pAllocationInfo) = 0;
+        virtual bool createImageView(RHIImage* image, RHIFormat format, RHIImageAspectFlags image_aspect_flags, RHIImageViewType view_type, uint32_t layout_count, uint32_t miplevels, RHIImageView*& image_view) = 0;
         virtual void recreateSwapchain() = 0;
+        virtual bool savePipelineCache() = 0;
+        // 下一次present之后按新的模式重建swapchain；设备不支持时回退到FIFO（所有设备都支持）
+        virtual void setPresentMode(RHIPresentModeKHR present_mode) = 0;
+        // 同时处理的帧数，范围[1, k_max_frames_in_flight]；越少延迟越低，越多CPU与GPU越不容易互相等待。只能在两帧之间调用
+        virtual void setFramesInFlight(uint8_t frames_in_flight) = 0;
 
         // command and write
+        // 从worker_index对应线程在当前帧的command pool中分配secondary command buffer，下一次复用这一帧时随resetCommandPool一起回收
+        virtual RHICommandBuffer* allocateSecondaryCommandBuffer(uint32_t worker_index) = 0;
         virtual bool beginCommandBuffer(RHICommandBuffer* commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo) = 0;
+        virtual bool endCommandBuffer(RHICommandBuffer* commandBuffer) = 0;
+        virtual void cmdExecuteCommands(RHICommandBuffer* commandBuffer, uint32_t commandBufferCount, RHICommandBuffer* const* pCommandBuffers) = 0;
         virtual bool prepareBeforePass(std::function<void()> passUpdateAfterRecreateSwapchain) = 0;
         virtual void submitRendering(std::function<void()> passUpdateAfterRecreateSwapchain) = 0;
+        // name只保存指针（GPU计时在几帧之后才解析），需要是字面量或Profiler::internName返回的字符串
         virtual void pushEvent(RHICommandBuffer* commond_buffer, const char* name, const float* color) = 0;
         virtual void popEvent(RHICommandBuffer* commond_buffer) = 0;
         virtual void cmdSetViewportPFN(RHICommandBuffer* commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const RHIViewport* pViewports) = 0;
         virtual void cmdSetScissorPFN(RHICommandBuffer* commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const RHIRect2D* pScissors) = 0;
-        virtual void waitForFences() = 0;
+        // 等待当前帧槽位上一次提交的工作在GPU上完成，之后这一帧的command pool、ring buffer分段等资源可以复用
+        virtual void waitForFrameInFlight() = 0;
+        virtual void waitDeviceIdle() = 0;
         virtual void resetCommandPool() = 0;
         virtual void cmdBeginRenderPassPFN(RHICommandBuffer* commandBuffer, const RHIRenderPassBeginInfo* pRenderPassBegin, RHISubpassContents contents) = 0;
         virtual void cmdBindPipelinePFN(RHICommandBuffer* commandBuffer, RHIPipelineBindPoint pipelineBindPoint, RHIPipeline* pipeline) = 0;
         virtual void cmdEndRenderPassPFN(RHICommandBuffer* commandBuffer) = 0;
+        virtual void cmdBindVertexBuffersPFN(RHICommandBuffer* commandBuffer, uint32_t firstBinding, uint32_t bindingCount, RHIBuffer* const* pBuffers, const RHIDeviceSize* pOffsets) = 0;
+        virtual void cmdBindIndexBufferPFN(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, RHIIndexType indexType) = 0;
+        virtual void cmdBindDescriptorSetsPFN(RHICommandBuffer* commandBuffer, RHIPipelineBindPoint pipelineBindPoint, RHIPipelineLayout* layout, uint32_t firstSet, uint32_t descriptorSetCount, RHIDescriptorSet* const* pDescriptorSets, uint32_t dynamicOffsetCount, const uint32_t* pDynamicOffsets) = 0;
+        virtual void cmdPushConstants(RHICommandBuffer* commandBuffer, RHIPipelineLayout* layout, RHIShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* pValues) = 0;
         virtual void cmdDraw(RHICommandBuffer* commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) = 0;
+        virtual void cmdDrawIndexed(RHICommandBuffer* commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance) = 0;
+        virtual void cmdDispatch(RHICommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) = 0;
+        virtual void cmdDispatchIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset) = 0;
+        virtual void cmdPipelineBarrier(RHICommandBuffer* commandBuffer, RHIPipelineStageFlags srcStageMask, RHIPipelineStageFlags dstStageMask, RHIDependencyFlags dependencyFlags, uint32_t memoryBarrierCount, const RHIMemoryBarrier* pMemoryBarriers, uint32_t bufferMemoryBarrierCount, const RHIBufferMemoryBarrier* pBufferMemoryBarriers, uint32_t imageMemoryBarrierCount, const RHIImageMemoryBarrier* pImageMemoryBarriers) = 0;
+        // 从当前帧的描述符池链中分配一个set，只在这一帧内有效：下一次复用这一帧槽位时所有set随池一起重置，不能单独释放。可以在任意线程调用
+        virtual bool allocateFrameDescriptorSet(RHIDescriptorSetLayout* layout, RHIDescriptorSet*& pDescriptorSet) = 0;
+        virtual void updateDescriptorSets(uint32_t descriptorWriteCount, const RHIWriteDescriptorSet* pDescriptorWrites) = 0;
+        virtual bool mapMemory(RHIAllocation* allocation, void** ppData) = 0;
+        virtual void unmapMemory(RHIAllocation* allocation) = 0;
+        virtual void flushAllocation(RHIAllocation* allocation, RHIDeviceSize offset, RHIDeviceSize size) = 0;
+        // 仅headless模式：把最近一次提交的帧拷贝回CPU，像素为紧密排列的swapchain格式（B8G8R8A8），尺寸为swapchain extent。
+        // 会等待GPU完成这一帧，只用于测试与截帧，不要在计时区间内调用
+        virtual bool readbackPresentedImage(std::vector<uint8_t>& pixels) = 0;
+
+        // upload
+        // 把data拷贝到暂存环形缓冲区并录制拷贝命令，可以在任意线程调用；这一帧内的所有上传在下一次prepareBeforePass时合并为一次
+        // 传输队列提交，同一帧的渲染会等待它们完成。目标资源需要EXCLUSIVE共享模式和TRANSFER_DST用途，原有内容会被丢弃。
+        // 返回上传完成时上传时间线到达的值
+        virtual uint64_t uploadBuffer(RHIBuffer* dst_buffer, RHIDeviceSize dst_offset, const void* data, RHIDeviceSize size) = 0;
+        // 只上传第0层mip、第0个array layer的颜色数据（紧密排列），上传后图像处于final_layout
+        virtual uint64_t uploadImage(RHIImage* dst_image, uint32_t width, uint32_t height, const void* data, RHIDeviceSize size, RHIImageLayout final_layout) = 0;
+        virtual uint64_t getCompletedUploadTimelineValue() = 0;
+
+        // async compute
+        // 计算队列上的工作可以与同一帧的光栅化并行（例如GPU剔除、蒙皮、后处理）。队列之间只通过timeline semaphore交接：
+        // 计算队列可以等待帧时间线，图形提交可以等待计算时间线。两个队列族不同时，两边都要访问的资源应以CONCURRENT共享模式创建，
+        // 或者由调用者录制队列族所有权转移的屏障（队列族见getQueueFamilyIndices）。以下函数只能在渲染线程调用
+        // 从当前帧的计算命令池中分配并begin一个primary command buffer，复用这一帧时随resetCommandPool一起回收
+        virtual RHICommandBuffer* beginAsyncComputeCommandBuffer() = 0;
+        // end并提交到计算队列；wait_frame_timeline_value非0时先在计算着色器阶段等待帧时间线到达该值（可以是之后才提交的帧）。
+        // 返回计算时间线的值，这批工作完成时到达
+        virtual uint64_t submitAsyncCompute(RHICommandBuffer* command_buffer, uint64_t wait_frame_timeline_value) = 0;
+        // 当前帧的图形提交在wait_stage等待计算时间线到达value
+        virtual void waitForAsyncComputeInGraphics(uint64_t value, RHIPipelineStageFlags wait_stage) = 0;
+        virtual uint64_t getCompletedAsyncComputeTimelineValue() = 0;
+        virtual RHISemaphore* getAsyncComputeTimelineSemaphore() const = 0;
+        virtual const QueueFamilyIndices& getQueueFamilyIndices() const = 0;
+
+        // sync
+        // 帧时间线：一个单调递增的计数器（timeline semaphore），每次submitRendering提交时加一，GPU执行完这一帧后signal为该值。
+        // CPU等待、跨队列依赖和延迟释放都以这个值为准，可以只等待需要的那一帧而不是整个设备
+        // https://www.khronos.org/blog/vulkan-timeline-semaphores
+        virtual uint64_t getSubmittedFrameTimelineValue() const = 0; // 最近一次提交的帧的值，0表示还没有提交过
+        virtual uint64_t getCompletedFrameTimelineValue() = 0; // GPU已经执行完的帧的值
+        virtual void waitForFrameTimelineValue(uint64_t value) = 0;
+        // 其他队列提交时可以等待（或者signal给图形队列等待）的timeline semaphore
+        virtual RHISemaphore* getFrameTimelineSemaphore() const = 0;
+        // 在GPU执行完已经录制和提交的所有工作（即下一次提交的帧）后调用release，用于销毁可能仍被GPU使用的资源
+        virtual void deferRelease(std::function<void()> release) = 0;
 
         // query
-        virtual RHISwapChainDesc getSwapchainInfo() = 0;
+        virtual const RHISwapChainDesc& getSwapchainInfo() const = 0;
+        virtual uint64_t getSwapchainGeneration() const = 0;
         virtual RHIDepthImageDesc getDepthImageInfo() = 0;
+        virtual RHIPhysicalDeviceLimits getPhysicalDeviceLimits() = 0;
         virtual RHICommandBuffer* getCurrentCommandBuffer() const = 0;
+        virtual RHIPresentModeKHR getPresentMode() const = 0;
+        virtual uint8_t getFramesInFlight() const = 0;
+        // 没有surface和swapchain，"swapchain"图像是离屏图像，提交后不present
+        virtual bool isHeadless() const = 0;
+        virtual RHIPipelineCache* getPipelineCache() const = 0;
+        virtual std::vector<RHIMemoryHeapBudget> getMemoryHeapBudgets() = 0;
+        // 最近一次解析出的各个pushEvent/popEvent区间的GPU耗时（通常是frames in flight帧之前的那一帧），按push的顺序排列。
+        // 只统计在当前帧主命令缓冲区中录制的区间；设备不支持timestamp查询时为空
+        virtual const std::vector<RHIGpuTiming>& getGpuTimings() const = 0;
+        virtual bool isMemoryPropertySupported(RHIMemoryPropertyFlags property_flags) = 0;
 
         // destroy
         virtual void destroyDevice() = 0;
         virtual void destroyImageView(RHIImageView* imageView) = 0;
         virtual void destroyShaderModule(RHIShader* shaderModule) = 0;
         virtual void destroyFramebuffer(RHIFramebuffer* framebuffer) = 0;
+        virtual void destroyRenderPass(RHIRenderPass* renderPass) = 0;
+        virtual void destroyBuffer(RHIBuffer* buffer, RHIAllocation* allocation) = 0;
+        virtual void destroyImage(RHIImage* image, RHIAllocation* allocation) = 0;
     };
 
 } // namespace Mercury
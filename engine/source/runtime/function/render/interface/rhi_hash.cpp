@@ -0,0 +1,224 @@
+#include "runtime/function/render/interface/rhi_hash.h"
+
+#include <string_view>
+
+namespace Mercury
+{
+    static void appendAttachmentReferencesKey(std::string& key, uint32_t count, const RHIAttachmentReference* pReferences)
+    {
+        key_append(key, count, pReferences != nullptr);
+        if (pReferences == nullptr)
+        {
+            return;
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            // 兼容性只和引用的attachment有关，与引用时的layout无关
+            key_append(key, pReferences[i].attachment);
+        }
+    }
+
+    static void appendStencilOpStateKey(std::string& key, const RHIStencilOpState& state)
+    {
+        key_append(key, state.failOp, state.passOp, state.depthFailOp, state.compareOp, state.compareMask, state.writeMask, state.reference);
+    }
+
+    void appendRenderPassCompatibilityKey(std::string& key, const RHIRenderPassCreateInfo* pCreateInfo)
+    {
+        key_append(key, pCreateInfo->flags, pCreateInfo->attachmentCount, pCreateInfo->subpassCount, pCreateInfo->dependencyCount);
+
+        for (uint32_t i = 0; i < pCreateInfo->attachmentCount; ++i)
+        {
+            const RHIAttachmentDescription& attachment = pCreateInfo->pAttachments[i];
+            key_append(key, attachment.flags, attachment.format, attachment.samples);
+        }
+
+        for (uint32_t i = 0; i < pCreateInfo->subpassCount; ++i)
+        {
+            const RHISubpassDescription& subpass = pCreateInfo->pSubpasses[i];
+            key_append(key, subpass.flags, subpass.pipelineBindPoint);
+            appendAttachmentReferencesKey(key, subpass.inputAttachmentCount, subpass.pInputAttachments);
+            appendAttachmentReferencesKey(key, subpass.colorAttachmentCount, subpass.pColorAttachments);
+            appendAttachmentReferencesKey(key, subpass.colorAttachmentCount, subpass.pResolveAttachments);
+            appendAttachmentReferencesKey(key, 1, subpass.pDepthStencilAttachment);
+        }
+
+        for (uint32_t i = 0; i < pCreateInfo->dependencyCount; ++i)
+        {
+            const RHISubpassDependency& dependency = pCreateInfo->pDependencies[i];
+            key_append(key, dependency.srcSubpass, dependency.dstSubpass, dependency.srcStageMask, dependency.dstStageMask,
+                dependency.srcAccessMask, dependency.dstAccessMask, dependency.dependencyFlags);
+        }
+    }
+
+    void appendDescriptorSetLayoutKey(std::string& key, const RHIDescriptorSetLayoutCreateInfo* pCreateInfo)
+    {
+        key_append(key, pCreateInfo->flags, pCreateInfo->bindingCount);
+        for (uint32_t i = 0; i < pCreateInfo->bindingCount; ++i)
+        {
+            const RHIDescriptorSetLayoutBinding& binding = pCreateInfo->pBindings[i];
+            key_append(key, binding.binding, binding.descriptorType, binding.descriptorCount, binding.stageFlags, binding.pImmutableSamplers != nullptr);
+            if (binding.pImmutableSamplers != nullptr)
+            {
+                // sampler按内容缓存并持有到设备销毁，句柄相同即内容相同
+                key_append_bytes(key, binding.pImmutableSamplers, binding.descriptorCount * sizeof(RHISampler*));
+            }
+        }
+    }
+
+    void appendPipelineLayoutKey(std::string& key, const RHIPipelineLayoutCreateInfo* pCreateInfo)
+    {
+        key_append(key, pCreateInfo->flags, pCreateInfo->setLayoutCount, pCreateInfo->pushConstantRangeCount);
+        // set layout同样按内容缓存，句柄即可代表内容
+        key_append_bytes(key, pCreateInfo->pSetLayouts, pCreateInfo->setLayoutCount * sizeof(RHIDescriptorSetLayout*));
+        key_append(key, pCreateInfo->pPushConstantRanges != nullptr);
+        if (pCreateInfo->pPushConstantRanges != nullptr)
+        {
+            for (uint32_t i = 0; i < pCreateInfo->pushConstantRangeCount; ++i)
+            {
+                const RHIPushConstantRange& range = pCreateInfo->pPushConstantRanges[i];
+                key_append(key, range.stageFlags, range.offset, range.size);
+            }
+        }
+    }
+
+    void appendSamplerKey(std::string& key, const RHISamplerCreateInfo* pCreateInfo)
+    {
+        key_append(key, pCreateInfo->flags, pCreateInfo->magFilter, pCreateInfo->minFilter, pCreateInfo->mipmapMode,
+            pCreateInfo->addressModeU, pCreateInfo->addressModeV, pCreateInfo->addressModeW, pCreateInfo->mipLodBias,
+            pCreateInfo->anisotropyEnable, pCreateInfo->maxAnisotropy, pCreateInfo->compareEnable, pCreateInfo->compareOp,
+            pCreateInfo->minLod, pCreateInfo->maxLod, pCreateInfo->borderColor, pCreateInfo->unnormalizedCoordinates);
+    }
+
+    // 可选的子状态和数组先写入是否存在，为空与内容恰好为空的状态不会拼出相同的key
+    void appendGraphicsPipelineStateKey(std::string& key, const RHIGraphicsPipelineCreateInfo* pCreateInfo)
+    {
+        key_append(key, pCreateInfo->flags, pCreateInfo->stageCount, pCreateInfo->subpass, pCreateInfo->basePipelineIndex);
+
+        for (uint32_t i = 0; i < pCreateInfo->stageCount; ++i)
+        {
+            const RHIPipelineShaderStageCreateInfo& stage = pCreateInfo->pStages[i];
+            key_append(key, stage.flags, stage.stage, std::string_view(stage.pName != nullptr ? stage.pName : ""));
+            key_append(key, stage.pSpecializationInfo != nullptr);
+            if (stage.pSpecializationInfo != nullptr)
+            {
+                const RHISpecializationInfo& specialization = *stage.pSpecializationInfo;
+                key_append(key, specialization.mapEntryCount, specialization.dataSize);
+                for (uint32_t j = 0; j < specialization.mapEntryCount; ++j)
+                {
+                    const RHISpecializationMapEntry* entry = specialization.pMapEntries[j];
+                    key_append(key, entry->constantID, entry->offset, entry->size);
+                }
+                key_append_bytes(key, specialization.pData, specialization.dataSize);
+            }
+        }
+
+        key_append(key, pCreateInfo->pVertexInputState != nullptr);
+        if (const RHIPipelineVertexInputStateCreateInfo* vertex_input = pCreateInfo->pVertexInputState)
+        {
+            key_append(key, vertex_input->flags, vertex_input->vertexBindingDescriptionCount, vertex_input->vertexAttributeDescriptionCount);
+            for (uint32_t i = 0; i < vertex_input->vertexBindingDescriptionCount; ++i)
+            {
+                const RHIVertexInputBindingDescription& binding = vertex_input->pVertexBindingDescriptions[i];
+                key_append(key, binding.binding, binding.stride, binding.inputRate);
+            }
+            for (uint32_t i = 0; i < vertex_input->vertexAttributeDescriptionCount; ++i)
+            {
+                const RHIVertexInputAttributeDescription& attribute = vertex_input->pVertexAttributeDescriptions[i];
+                key_append(key, attribute.location, attribute.binding, attribute.format, attribute.offset);
+            }
+        }
+
+        key_append(key, pCreateInfo->pInputAssemblyState != nullptr);
+        if (const RHIPipelineInputAssemblyStateCreateInfo* input_assembly = pCreateInfo->pInputAssemblyState)
+        {
+            key_append(key, input_assembly->flags, input_assembly->topology, input_assembly->primitiveRestartEnable);
+        }
+
+        key_append(key, pCreateInfo->pTessellationState != nullptr);
+        if (const RHIPipelineTessellationStateCreateInfo* tessellation = pCreateInfo->pTessellationState)
+        {
+            key_append(key, tessellation->flags, tessellation->patchControlPoints);
+        }
+
+        key_append(key, pCreateInfo->pViewportState != nullptr);
+        if (const RHIPipelineViewportStateCreateInfo* viewport_state = pCreateInfo->pViewportState)
+        {
+            key_append(key, viewport_state->flags, viewport_state->viewportCount, viewport_state->scissorCount);
+            // viewport和scissor一般是动态状态，此时pViewports/pScissors为空
+            key_append(key, viewport_state->pViewports != nullptr);
+            if (viewport_state->pViewports != nullptr)
+            {
+                for (uint32_t i = 0; i < viewport_state->viewportCount; ++i)
+                {
+                    const RHIViewport& viewport = viewport_state->pViewports[i];
+                    key_append(key, viewport.x, viewport.y, viewport.width, viewport.height, viewport.minDepth, viewport.maxDepth);
+                }
+            }
+            key_append(key, viewport_state->pScissors != nullptr);
+            if (viewport_state->pScissors != nullptr)
+            {
+                for (uint32_t i = 0; i < viewport_state->scissorCount; ++i)
+                {
+                    const RHIRect2D& scissor = viewport_state->pScissors[i];
+                    key_append(key, scissor.offset.x, scissor.offset.y, scissor.extent.width, scissor.extent.height);
+                }
+            }
+        }
+
+        key_append(key, pCreateInfo->pRasterizationState != nullptr);
+        if (const RHIPipelineRasterizationStateCreateInfo* rasterization = pCreateInfo->pRasterizationState)
+        {
+            key_append(key, rasterization->flags, rasterization->depthClampEnable, rasterization->rasterizerDiscardEnable,
+                rasterization->polygonMode, rasterization->cullMode, rasterization->frontFace, rasterization->depthBiasEnable,
+                rasterization->depthBiasConstantFactor, rasterization->depthBiasClamp, rasterization->depthBiasSlopeFactor, rasterization->lineWidth);
+        }
+
+        key_append(key, pCreateInfo->pMultisampleState != nullptr);
+        if (const RHIPipelineMultisampleStateCreateInfo* multisample = pCreateInfo->pMultisampleState)
+        {
+            key_append(key, multisample->flags, multisample->rasterizationSamples, multisample->sampleShadingEnable,
+                multisample->minSampleShading, multisample->alphaToCoverageEnable, multisample->alphaToOneEnable);
+            key_append(key, multisample->pSampleMask != nullptr);
+            if (multisample->pSampleMask != nullptr)
+            {
+                // 与VulkanRHI的转换保持一致，pSampleMask按RHISampleMask数组解释，长度为ceil(rasterizationSamples / 32)
+                const RHISampleMask* sample_mask = (const RHISampleMask*)multisample->pSampleMask;
+                uint32_t sample_mask_count = ((uint32_t)multisample->rasterizationSamples + 31) / 32;
+                key_append_bytes(key, sample_mask, sample_mask_count * sizeof(RHISampleMask));
+            }
+        }
+
+        key_append(key, pCreateInfo->pDepthStencilState != nullptr);
+        if (const RHIPipelineDepthStencilStateCreateInfo* depth_stencil = pCreateInfo->pDepthStencilState)
+        {
+            key_append(key, depth_stencil->flags, depth_stencil->depthTestEnable, depth_stencil->depthWriteEnable, depth_stencil->depthCompareOp,
+                depth_stencil->depthBoundsTestEnable, depth_stencil->stencilTestEnable, depth_stencil->minDepthBounds, depth_stencil->maxDepthBounds);
+            appendStencilOpStateKey(key, depth_stencil->front);
+            appendStencilOpStateKey(key, depth_stencil->back);
+        }
+
+        key_append(key, pCreateInfo->pColorBlendState != nullptr);
+        if (const RHIPipelineColorBlendStateCreateInfo* color_blend = pCreateInfo->pColorBlendState)
+        {
+            key_append(key, color_blend->flags, color_blend->logicOpEnable, color_blend->logicOp, color_blend->attachmentCount,
+                color_blend->blendConstants[0], color_blend->blendConstants[1], color_blend->blendConstants[2], color_blend->blendConstants[3]);
+            for (uint32_t i = 0; i < color_blend->attachmentCount; ++i)
+            {
+                const RHIPipelineColorBlendAttachmentState& attachment = color_blend->pAttachments[i];
+                key_append(key, attachment.blendEnable, attachment.srcColorBlendFactor, attachment.dstColorBlendFactor, attachment.colorBlendOp,
+                    attachment.srcAlphaBlendFactor, attachment.dstAlphaBlendFactor, attachment.alphaBlendOp, attachment.colorWriteMask);
+            }
+        }
+
+        key_append(key, pCreateInfo->pDynamicState != nullptr);
+        if (const RHIPipelineDynamicStateCreateInfo* dynamic_state = pCreateInfo->pDynamicState)
+        {
+            key_append(key, dynamic_state->flags, dynamic_state->dynamicStateCount);
+            for (uint32_t i = 0; i < dynamic_state->dynamicStateCount; ++i)
+            {
+                key_append(key, dynamic_state->pDynamicStates[i]);
+            }
+        }
+    }
+} // namespace Mercury
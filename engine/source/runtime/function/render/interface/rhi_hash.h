@@ -0,0 +1,31 @@
+#pragma once
+
+#include "runtime/core/base/hash.h"
+#include "runtime/function/render/interface/rhi_struct.h"
+
+#include <string>
+
+namespace Mercury
+{
+    /*
+    * 对RHI create info结构体生成key，用于去重重复创建的对象（例如PSO）。
+    * 只使用结构体的内容，指针指向的数组会逐元素展开，pNext链不参与。
+    * append*Key把内容追加到key中，key作为缓存的键时按完整内容比较，不会因为hash冲突复用错误的对象。
+    */
+
+    // render pass兼容性key：只包含决定render pass是否兼容的内容，不包含load/store op和image layout
+    // https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#renderpass-compatibility
+    void appendRenderPassCompatibilityKey(std::string& key, const RHIRenderPassCreateInfo* pCreateInfo);
+
+    // immutable sampler按句柄参与，sampler由RHI按内容缓存
+    void appendDescriptorSetLayoutKey(std::string& key, const RHIDescriptorSetLayoutCreateInfo* pCreateInfo);
+
+    // set layout按句柄参与，set layout由RHI按内容缓存
+    void appendPipelineLayoutKey(std::string& key, const RHIPipelineLayoutCreateInfo* pCreateInfo);
+
+    void appendSamplerKey(std::string& key, const RHISamplerCreateInfo* pCreateInfo);
+
+    // graphics pipeline的固定功能状态和shader stage的描述，不包含shader module、layout、render pass等句柄，
+    // 这些对象的key由具体的RHI实现在创建时记录并追加进来
+    void appendGraphicsPipelineStateKey(std::string& key, const RHIGraphicsPipelineCreateInfo* pCreateInfo);
+} // namespace Mercury
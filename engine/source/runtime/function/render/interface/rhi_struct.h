@@ -3,14 +3,18 @@
 
 #include <vulkan/vulkan_core.h>
 #include <optional>
+#include <string>
 #include <vector>
 namespace Mercury
 {
     ///////////////////////class/////////////////
     class RHIQueue {};
+    class RHIBuffer {};
     class RHIImage {};
     class RHIImageView {};
+    class RHISampler {};
     class RHIDescriptorSetLayout {};
+    class RHIDescriptorSet {};
     class RHIShader {};
     class RHIPipeline {};
     class RHIPipelineLayout {};
@@ -22,6 +26,7 @@ namespace Mercury
     class RHICommandBuffer {};
     class RHISemaphore {};
     class RHIFence {};
+    class RHIAllocation {}; // 由RHI内存分配器（VMA）管理的一段子分配内存
 
     //////////////////////struct/////////////////
     struct RHIViewport
@@ -41,7 +46,8 @@ namespace Mercury
         // 通过has_value()查询是否包含值
         std::optional<uint32_t> graphics_family; // 支持图形命令队列
         std::optional<uint32_t> present_family; // 支持在我们创建的表面上进行表示的队列
-        std::optional<uint32_t> m_compute_family; // 支持计算命令队列
+        std::optional<uint32_t> m_compute_family; // 支持计算命令队列：优先选择不支持图形的队列族（async compute），没有时与图形队列族相同
+        std::optional<uint32_t> transfer_family; // 上传使用的队列：优先选择只支持传输的专用队列族，没有时与图形队列族相同
 
         bool isComplete() { return graphics_family.has_value() && present_family.has_value() && m_compute_family.has_value(); }
     };
@@ -69,6 +75,12 @@ namespace Mercury
         RHIExtent2D extent;
     };
 
+    struct RHIExtent3D {
+        uint32_t width;
+        uint32_t height;
+        uint32_t depth;
+    };
+
     struct RHISwapChainDesc
     {
         RHIExtent2D extent;
@@ -76,6 +88,18 @@ namespace Mercury
         RHIViewport* viewport;
         RHIRect2D* scissor;
         std::vector<RHIImageView*> imageViews;
+        std::vector<RHIImage*> images;
+        uint64_t generation{ 0 }; // 每次重建swapchain后递增，用于判断依赖swapchain的资源是否过期
+    };
+
+    // 物理设备限制中渲染层需要关心的部分
+    struct RHIPhysicalDeviceLimits
+    {
+        RHIDeviceSize minUniformBufferOffsetAlignment;
+        RHIDeviceSize minStorageBufferOffsetAlignment;
+        RHIDeviceSize nonCoherentAtomSize;
+        uint32_t maxUniformBufferRange;
+        uint32_t maxStorageBufferRange;
     };
 
     struct RHIDepthImageDesc
@@ -92,6 +116,25 @@ namespace Mercury
         uint32_t size;
     };
 
+    struct RHIDescriptorSetLayoutBinding
+    {
+        uint32_t binding;
+        RHIDescriptorType descriptorType;
+        uint32_t descriptorCount;
+        RHIShaderStageFlags stageFlags;
+        // 可为空；非空时为descriptorCount个固定在layout中的sampler（SAMPLER/COMBINED_IMAGE_SAMPLER），写描述符时不再需要提供
+        RHISampler* const* pImmutableSamplers;
+    };
+
+    struct RHIDescriptorSetLayoutCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIDescriptorSetLayoutCreateFlags flags;
+        uint32_t bindingCount;
+        const RHIDescriptorSetLayoutBinding* pBindings;
+    };
+
     struct RHIPipelineLayoutCreateInfo
     {
         RHIStructureType sType;
@@ -385,6 +428,17 @@ namespace Mercury
         int32_t basePipelineIndex;
     };
 
+    struct RHIComputePipelineCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIPipelineCreateFlags flags;
+        const RHIPipelineShaderStageCreateInfo* pStages; // 只有一个计算着色器阶段
+        RHIPipelineLayout* layout;
+        RHIPipeline* basePipelineHandle;
+        int32_t basePipelineIndex;
+    };
+
     struct RHIClearDepthStencilValue {
         float depth;
         uint32_t stencil;
@@ -410,5 +464,168 @@ namespace Mercury
         uint32_t clearValueCount;
         const RHIClearValue* pClearValues;
     };
-} // namespace Mercury
 
+    struct RHIBufferCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIBufferCreateFlags flags;
+        RHIDeviceSize size;
+        RHIBufferUsageFlags usage;
+        RHISharingMode sharingMode;
+        uint32_t queueFamilyIndexCount;
+        const uint32_t* pQueueFamilyIndices;
+    };
+
+    struct RHIImageSubresourceRange
+    {
+        RHIImageAspectFlags aspectMask;
+        uint32_t baseMipLevel;
+        uint32_t levelCount;
+        uint32_t baseArrayLayer;
+        uint32_t layerCount;
+    };
+
+    struct RHIMemoryBarrier
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIAccessFlags srcAccessMask;
+        RHIAccessFlags dstAccessMask;
+    };
+
+    struct RHIDescriptorBufferInfo
+    {
+        RHIBuffer* buffer;
+        RHIDeviceSize offset;
+        RHIDeviceSize range;
+    };
+
+    // sampler只用于SAMPLER/COMBINED_IMAGE_SAMPLER，其他图像描述符（sampled/storage image、input attachment）或使用immutable sampler时为空
+    struct RHIDescriptorImageInfo
+    {
+        RHISampler* sampler;
+        RHIImageView* imageView;
+        RHIImageLayout imageLayout;
+    };
+
+    struct RHISamplerCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHISamplerCreateFlags flags;
+        RHIFilter magFilter;
+        RHIFilter minFilter;
+        RHISamplerMipmapMode mipmapMode;
+        RHISamplerAddressMode addressModeU;
+        RHISamplerAddressMode addressModeV;
+        RHISamplerAddressMode addressModeW;
+        float mipLodBias;
+        RHIBool32 anisotropyEnable;
+        float maxAnisotropy;
+        RHIBool32 compareEnable;
+        RHICompareOp compareOp;
+        float minLod;
+        float maxLod;
+        RHIBorderColor borderColor;
+        RHIBool32 unnormalizedCoordinates;
+    };
+
+    struct RHIWriteDescriptorSet
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIDescriptorSet* dstSet;
+        uint32_t dstBinding;
+        uint32_t dstArrayElement;
+        uint32_t descriptorCount;
+        RHIDescriptorType descriptorType;
+        const RHIDescriptorImageInfo* pImageInfo; // 按descriptorType只使用其中一个
+        const RHIDescriptorBufferInfo* pBufferInfo;
+    };
+
+    struct RHIBufferMemoryBarrier
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIAccessFlags srcAccessMask;
+        RHIAccessFlags dstAccessMask;
+        uint32_t srcQueueFamilyIndex;
+        uint32_t dstQueueFamilyIndex;
+        RHIBuffer* buffer;
+        RHIDeviceSize offset;
+        RHIDeviceSize size;
+    };
+
+    struct RHIImageMemoryBarrier
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIAccessFlags srcAccessMask;
+        RHIAccessFlags dstAccessMask;
+        RHIImageLayout oldLayout;
+        RHIImageLayout newLayout;
+        uint32_t srcQueueFamilyIndex;
+        uint32_t dstQueueFamilyIndex;
+        RHIImage* image;
+        RHIImageSubresourceRange subresourceRange;
+    };
+
+    struct RHIImageCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        RHIImageCreateFlags flags;
+        RHIImageType imageType;
+        RHIFormat format;
+        RHIExtent3D extent;
+        uint32_t mipLevels;
+        uint32_t arrayLayers;
+        RHISampleCountFlagBits samples;
+        RHIImageTiling tiling;
+        RHIImageUsageFlags usage;
+        RHISharingMode sharingMode;
+        uint32_t queueFamilyIndexCount;
+        const uint32_t* pQueueFamilyIndices;
+        RHIImageLayout initialLayout;
+    };
+
+    // 仿照VmaAllocationCreateInfo，描述一次子分配对内存的要求
+    struct RHIAllocationCreateInfo
+    {
+        RHIAllocationCreateFlags flags;
+        RHIMemoryUsage usage;
+        RHIMemoryPropertyFlags requiredFlags;
+        RHIMemoryPropertyFlags preferredFlags;
+    };
+
+    // 子分配的结果：所在内存类型、在内存块中的偏移与大小，以及持久映射时的CPU地址
+    struct RHIAllocationInfo
+    {
+        uint32_t memoryType;
+        RHIDeviceSize offset;
+        RHIDeviceSize size;
+        void* pMappedData;
+    };
+
+    // 每个内存堆（memory heap）的预算与使用情况，用于观察显存压力
+    struct RHIMemoryHeapBudget
+    {
+        uint32_t heap_index;
+        RHIMemoryHeapFlags heap_flags;
+        uint32_t block_count;       // 向驱动申请的VkDeviceMemory块数量
+        uint32_t allocation_count;  // 从这些块中子分配出去的数量
+        RHIDeviceSize block_bytes;
+        RHIDeviceSize allocation_bytes;
+        RHIDeviceSize usage;        // 整个进程在该堆上的使用量（VK_EXT_memory_budget可用时由驱动提供）
+        RHIDeviceSize budget;       // 该堆上可安全使用的预算
+    };
+
+    // 一个pushEvent/popEvent区间在GPU上的耗时，由几帧之前写入的timestamp查询解析得到
+    struct RHIGpuTiming
+    {
+        const char* name;       // pushEvent传入的名字
+        uint32_t depth;         // 嵌套层级，0为最外层
+        float gpu_milliseconds;
+    };
+} // namespace Mercury
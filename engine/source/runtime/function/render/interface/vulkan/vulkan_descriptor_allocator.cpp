@@ -0,0 +1,169 @@
+#include "runtime/function/render/interface/vulkan/vulkan_descriptor_allocator.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace Mercury
+{
+    namespace
+    {
+        // 每个set平均需要的各类描述符数量，池的容量按set数量等比例放大
+        struct DescriptorPoolRatio
+        {
+            VkDescriptorType type;
+            float ratio;
+        };
+
+        constexpr DescriptorPoolRatio k_descriptor_pool_ratios[] = {
+            { VK_DESCRIPTOR_TYPE_SAMPLER, 0.5f },
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.f },
+            { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 2.f },
+            { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.f },
+            { VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 0.5f },
+            { VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 0.5f },
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.f },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.f },
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.f },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1.f },
+            { VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 0.5f },
+        };
+    } // namespace
+
+    void VulkanDescriptorAllocator::initialize(VkDevice device, uint32_t frame_count)
+    {
+        m_device = device;
+        m_frames.resize(frame_count);
+        m_next_sets_per_pool = k_initial_sets_per_pool;
+        std::cout << "create descriptor allocator success!" << std::endl;
+    }
+
+    void VulkanDescriptorAllocator::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // 池销毁时其中的set一起释放
+        for (VkDescriptorPool pool : m_all_pools)
+        {
+            vkDestroyDescriptorPool(m_device, pool, nullptr);
+        }
+        m_all_pools.clear();
+        m_free_pools.clear();
+        for (FramePools& frame : m_frames)
+        {
+            for (VulkanDescriptorSet* descriptor_set : frame.descriptor_sets)
+            {
+                delete descriptor_set;
+            }
+        }
+        m_frames.clear();
+    }
+
+    RHIDescriptorSet* VulkanDescriptorAllocator::allocate(uint32_t frame_index, VkDescriptorSetLayout layout)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        FramePools& frame = m_frames[frame_index];
+        if (frame.pools.empty())
+        {
+            frame.pools.push_back(acquirePool());
+        }
+
+        VkDescriptorSet vk_descriptor_set;
+        if (!tryAllocate(frame.pools.back(), layout, vk_descriptor_set))
+        {
+            // 当前池用完了，先换一个空闲池再试；空闲池可能是更早创建的小池，仍然放不下时再新建一个当前最大容量的池。
+            // 新建的池中仍然放不下说明这个layout超过了单个池的容量
+            frame.pools.push_back(acquirePool());
+            if (!tryAllocate(frame.pools.back(), layout, vk_descriptor_set))
+            {
+                frame.pools.push_back(createPool());
+                if (!tryAllocate(frame.pools.back(), layout, vk_descriptor_set))
+                {
+                    throw std::runtime_error("failed to allocate descriptor set!");
+                }
+            }
+        }
+
+        if (frame.used_descriptor_set_count == frame.descriptor_sets.size())
+        {
+            frame.descriptor_sets.push_back(new VulkanDescriptorSet());
+        }
+        VulkanDescriptorSet* descriptor_set = frame.descriptor_sets[frame.used_descriptor_set_count++];
+        descriptor_set->setResource(vk_descriptor_set);
+        return descriptor_set;
+    }
+
+    void VulkanDescriptorAllocator::resetFrame(uint32_t frame_index)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        FramePools& frame = m_frames[frame_index];
+        for (VkDescriptorPool pool : frame.pools)
+        {
+            if (vkResetDescriptorPool(m_device, pool, 0) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to reset descriptor pool!");
+            }
+            m_free_pools.push_back(pool);
+        }
+        frame.pools.clear();
+        frame.used_descriptor_set_count = 0;
+    }
+
+    VkDescriptorPool VulkanDescriptorAllocator::acquirePool()
+    {
+        if (!m_free_pools.empty())
+        {
+            VkDescriptorPool pool = m_free_pools.back();
+            m_free_pools.pop_back();
+            return pool;
+        }
+        return createPool();
+    }
+
+    VkDescriptorPool VulkanDescriptorAllocator::createPool()
+    {
+        const uint32_t max_sets = m_next_sets_per_pool;
+        m_next_sets_per_pool = std::min(m_next_sets_per_pool * 2, k_max_sets_per_pool);
+
+        std::vector<VkDescriptorPoolSize> pool_sizes;
+        pool_sizes.reserve(std::size(k_descriptor_pool_ratios));
+        for (const DescriptorPoolRatio& pool_ratio : k_descriptor_pool_ratios)
+        {
+            pool_sizes.push_back({ pool_ratio.type, static_cast<uint32_t>(pool_ratio.ratio * max_sets) });
+        }
+
+        VkDescriptorPoolCreateInfo pool_create_info{};
+        pool_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_create_info.flags = 0; // 不允许单独释放set，只整体重置
+        pool_create_info.maxSets = max_sets;
+        pool_create_info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
+        pool_create_info.pPoolSizes = pool_sizes.data();
+
+        VkDescriptorPool pool;
+        if (vkCreateDescriptorPool(m_device, &pool_create_info, nullptr, &pool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create descriptor pool!");
+        }
+        m_all_pools.push_back(pool);
+        return pool;
+    }
+
+    bool VulkanDescriptorAllocator::tryAllocate(VkDescriptorPool pool, VkDescriptorSetLayout layout, VkDescriptorSet& descriptor_set)
+    {
+        VkDescriptorSetAllocateInfo allocate_info{};
+        allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.descriptorPool = pool;
+        allocate_info.descriptorSetCount = 1;
+        allocate_info.pSetLayouts = &layout;
+
+        VkResult result = vkAllocateDescriptorSets(m_device, &allocate_info, &descriptor_set);
+        if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+        {
+            return false;
+        }
+        if (result != VK_SUCCESS)
+        {
+            throw std::runtime_error("vkAllocateDescriptorSets failed!");
+        }
+        return true;
+    }
+} // namespace Mercury
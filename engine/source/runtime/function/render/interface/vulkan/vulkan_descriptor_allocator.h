@@ -0,0 +1,56 @@
+#pragma once
+
+#include "runtime/function/render/interface/rhi.h"
+#include "runtime/function/render/interface/vulkan/vulkan_rhi_resource.h"
+
+#include <vulkan/vulkan.h>
+
+#include <mutex>
+#include <vector>
+
+namespace Mercury
+{
+    /*
+    * 每帧的描述符分配器：每个frame in flight槽位有一条描述符池链，set只在分配它的那一帧内有效。
+    * • 当前池用完（VK_ERROR_OUT_OF_POOL_MEMORY/VK_ERROR_FRAGMENTED_POOL）时从空闲池中取一个或新建一个接到链上，新建的池容量翻倍直到上限
+    * • 不支持单独释放set（池不带FREE_DESCRIPTOR_SET标志）：复用帧槽位时用vkResetDescriptorPool整体重置，池放回空闲列表，
+    *   没有碎片，也没有逐个set释放的CPU开销
+    * https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#descriptorsets-allocation
+    */
+    class VulkanDescriptorAllocator
+    {
+    public:
+        static constexpr uint32_t k_initial_sets_per_pool{ 128 };
+        static constexpr uint32_t k_max_sets_per_pool{ 4096 };
+
+        void initialize(VkDevice device, uint32_t frame_count);
+        void clear();
+
+        // 可以在任意线程调用；返回的set对象由分配器持有，在这一帧槽位下一次重置后失效
+        RHIDescriptorSet* allocate(uint32_t frame_index, VkDescriptorSetLayout layout);
+        // 只能在这一帧槽位的GPU工作全部完成后调用
+        void resetFrame(uint32_t frame_index);
+
+    private:
+        struct FramePools
+        {
+            std::vector<VkDescriptorPool> pools; // back()是当前分配的池
+            std::vector<VulkanDescriptorSet*> descriptor_sets; // set对象按帧复用
+            uint32_t used_descriptor_set_count{ 0 };
+        };
+
+        // 以下函数需要持有m_mutex
+        // 优先复用空闲池，没有时新建
+        VkDescriptorPool acquirePool();
+        // 总是新建，容量为m_next_sets_per_pool，之后容量翻倍直到上限
+        VkDescriptorPool createPool();
+        bool tryAllocate(VkDescriptorPool pool, VkDescriptorSetLayout layout, VkDescriptorSet& descriptor_set);
+
+        VkDevice m_device{ VK_NULL_HANDLE };
+        std::mutex m_mutex;
+        std::vector<FramePools> m_frames;
+        std::vector<VkDescriptorPool> m_free_pools; // 已经重置、可以直接使用的池
+        std::vector<VkDescriptorPool> m_all_pools;
+        uint32_t m_next_sets_per_pool{ k_initial_sets_per_pool };
+    };
+} // namespace Mercury
@@ -1,15 +1,57 @@
+// vk_mem_alloc.h是单头文件库，需要且只能在一个编译单元中定义VMA_IMPLEMENTATION来生成实现
+#define VMA_IMPLEMENTATION
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
+#include "runtime/function/render/interface/rhi_hash.h"
+#include "runtime/core/base/profiler.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <set>
 
 namespace Mercury
 {
+    // cmd*录制路径中的RHI结构体与Vulkan结构体内存布局一致，可以直接reinterpret_cast传给驱动，避免每次调用都做逐元素转换和堆分配
+    static_assert(sizeof(RHIViewport) == sizeof(VkViewport), "RHIViewport must be layout compatible with VkViewport");
+    static_assert(offsetof(RHIViewport, x) == offsetof(VkViewport, x), "RHIViewport::x offset mismatch");
+    static_assert(offsetof(RHIViewport, y) == offsetof(VkViewport, y), "RHIViewport::y offset mismatch");
+    static_assert(offsetof(RHIViewport, width) == offsetof(VkViewport, width), "RHIViewport::width offset mismatch");
+    static_assert(offsetof(RHIViewport, height) == offsetof(VkViewport, height), "RHIViewport::height offset mismatch");
+    static_assert(offsetof(RHIViewport, minDepth) == offsetof(VkViewport, minDepth), "RHIViewport::minDepth offset mismatch");
+    static_assert(offsetof(RHIViewport, maxDepth) == offsetof(VkViewport, maxDepth), "RHIViewport::maxDepth offset mismatch");
+
+    static_assert(sizeof(RHIRect2D) == sizeof(VkRect2D), "RHIRect2D must be layout compatible with VkRect2D");
+    static_assert(offsetof(RHIRect2D, offset) == offsetof(VkRect2D, offset), "RHIRect2D::offset offset mismatch");
+    static_assert(offsetof(RHIRect2D, extent) == offsetof(VkRect2D, extent), "RHIRect2D::extent offset mismatch");
+    static_assert(offsetof(RHIOffset2D, y) == offsetof(VkOffset2D, y), "RHIOffset2D::y offset mismatch");
+    static_assert(offsetof(RHIExtent2D, height) == offsetof(VkExtent2D, height), "RHIExtent2D::height offset mismatch");
+
+    static_assert(sizeof(RHIClearValue) == sizeof(VkClearValue), "RHIClearValue must be layout compatible with VkClearValue");
+    static_assert(sizeof(RHIClearColorValue) == sizeof(VkClearColorValue), "RHIClearColorValue must be layout compatible with VkClearColorValue");
+    static_assert(offsetof(RHIClearDepthStencilValue, stencil) == offsetof(VkClearDepthStencilValue, stencil), "RHIClearDepthStencilValue::stencil offset mismatch");
+
+    static_assert(sizeof(RHIPushConstantRange) == sizeof(VkPushConstantRange), "RHIPushConstantRange must be layout compatible with VkPushConstantRange");
+    static_assert(offsetof(RHIPushConstantRange, size) == offsetof(VkPushConstantRange, size), "RHIPushConstantRange::size offset mismatch");
+
+    static_assert(sizeof(RHIMemoryBarrier) == sizeof(VkMemoryBarrier), "RHIMemoryBarrier must be layout compatible with VkMemoryBarrier");
+    static_assert(offsetof(RHIMemoryBarrier, dstAccessMask) == offsetof(VkMemoryBarrier, dstAccessMask), "RHIMemoryBarrier::dstAccessMask offset mismatch");
+
+    static_assert(sizeof(RHIDeviceSize) == sizeof(VkDeviceSize), "RHIDeviceSize must match VkDeviceSize");
+
     void VulkanRHI::initialize(RHIInitInfo init_info) {
         // Vulkan窗口对象初始化
         m_window = init_info.window_system->getWindow();
+        m_is_headless = init_info.window_system->isHeadless();
+        if (m_is_headless)
+        {
+            // 不present就不需要VK_KHR_swapchain，没有窗口系统的软件实现（如lavapipe）也能运行
+            m_device_extensions.clear();
+        }
+        m_pipeline_cache_path = init_info.pipeline_cache_path;
+        m_command_recording_worker_count = std::max(init_info.command_recording_worker_count, 1u);
         std::array<int, 2> window_size = init_info.window_system->getWindowSize();
 
         // 视口初始化
@@ -32,8 +74,11 @@ namespace Mercury
         // 初始化调试信息
         initializeDebugMessenger();
 
-        // Surface是要渲染到的窗口上的跨平台抽象，一般利用glfw实现
-        createWindowSurface();
+        // Surface是要渲染到的窗口上的跨平台抽象，一般利用glfw实现；headless没有窗口
+        if (!m_is_headless)
+        {
+            createWindowSurface();
+        }
 
         // 初始化物理设备
         initializePhysicalDevice();
@@ -41,6 +86,12 @@ namespace Mercury
         // 创建逻辑设备
         createLogicalDevice();
 
+        // 创建资源分配器（VMA），之后所有buffer/image都从它子分配内存，深度缓冲也不例外
+        createAssetAllocator();
+
+        // 创建pipeline cache，优先使用上次运行保存到磁盘的数据，避免每次启动都完整编译所有pipeline
+        createPipelineCache();
+
         // 创建描述符池（https://registry.khronos.org/vulkan/specs/1.3-extensions/html/chap14.html）
         // 描述符是表示着色器资源的不透明数据结构，例如缓冲区、缓冲区视图、图像视图、采样器或组合图像采样器。
         createDescriptorPool();
@@ -48,10 +99,27 @@ namespace Mercury
         // 创建同步图元
         createSyncPrimitives();
 
+        // 上传管理器：暂存环形缓冲区、传输队列的command pool和上传时间线
+        m_upload_manager.initialize(this);
+
+        // 计算队列每帧的command pool和计算时间线
+        createAsyncComputeResources();
+
+        // 每帧一个timestamp查询池，用于统计各个pushEvent/popEvent区间的GPU耗时
+        createGpuTimestampQueryPools();
+
         // 创建交换链（https://vulkan-tutorial.com/Drawing_a_triangle/Presentation/Swap_chain）
         // 交换链是渲染目标的集合。它的基本目的是确保我们当前渲染的图像与屏幕上的图像不同。
         // 交换链本质上是一个等待显示到屏幕上的图像队列
-        createSwapchain();
+        // headless时用离屏图像代替，之后的image view、render graph和各个pass都不需要区分两种模式
+        if (m_is_headless)
+        {
+            createOffscreenImages();
+        }
+        else
+        {
+            createSwapchain();
+        }
 
         // 创建一个VkImageView对象，是对图像的一个视图，用于呈现渲染管线中的任何图像（包括swapchain中的）
         // https://vulkan-tutorial.com/Drawing_a_triangle/Presentation/Image_views
@@ -64,9 +132,6 @@ namespace Mercury
         createCommandPool(); // 命令池：管理命令缓冲，命令缓冲将会在命令池中分配
         createCommandBuffers(); // 命令缓冲：Vulkan 命令存储的位置
 
-        // 创建资源分配器
-        createAssetAllocator();
-
         std::cout << "initialize success!" << std::endl;
     }
 
@@ -149,6 +214,68 @@ namespace Mercury
         std::cout << "create swapchain success!" << std::endl;
     }
 
+    void VulkanRHI::createOffscreenImages()
+    {
+        // 分辨率取窗口系统记录的大小（initialize中写入m_scissor），格式与窗口模式优先选择的格式一致，截帧结果与屏幕上相同
+        m_swapchain_images_format = RHI_FORMAT_B8G8R8A8_UNORM;
+        m_swapchain_extend = m_scissor.extent;
+
+        RHIImageCreateInfo image_create_info{};
+        image_create_info.sType = RHI_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        image_create_info.imageType = RHI_IMAGE_TYPE_2D;
+        image_create_info.format = m_swapchain_images_format;
+        image_create_info.extent = { m_swapchain_extend.width, m_swapchain_extend.height, 1 };
+        image_create_info.mipLevels = 1;
+        image_create_info.arrayLayers = 1;
+        image_create_info.samples = RHI_SAMPLE_COUNT_1_BIT;
+        image_create_info.tiling = RHI_IMAGE_TILING_OPTIMAL;
+        image_create_info.usage = RHI_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | RHI_IMAGE_USAGE_TRANSFER_SRC_BIT; // 回读时作为拷贝源
+        image_create_info.sharingMode = RHI_SHARING_MODE_EXCLUSIVE;
+        image_create_info.initialLayout = RHI_IMAGE_LAYOUT_UNDEFINED;
+
+        RHIAllocationCreateInfo allocation_create_info{};
+        allocation_create_info.usage = RHI_MEMORY_USAGE_GPU_ONLY;
+        allocation_create_info.requiredFlags = RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+        m_offscreen_images.resize(k_max_frames_in_flight);
+        m_offscreen_image_allocations.resize(k_max_frames_in_flight);
+        m_swapchain_images.resize(k_max_frames_in_flight);
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            createImage(&image_create_info, &allocation_create_info, m_offscreen_images[i], m_offscreen_image_allocations[i], nullptr);
+            m_swapchain_images[i] = ((VulkanImage*)m_offscreen_images[i])->getResource();
+        }
+
+        std::cout << "create offscreen images success!" << std::endl;
+    }
+
+    void VulkanRHI::destroySwapchainImages()
+    {
+        for (auto imageview : m_swapchain_imageviews)
+        {
+            vkDestroyImageView(m_logical_device, ((VulkanImageView*)imageview)->getResource(), NULL);
+            delete imageview;
+        }
+        m_swapchain_imageviews.clear();
+
+        if (m_is_headless)
+        {
+            for (uint32_t i = 0; i < m_offscreen_images.size(); ++i)
+            {
+                destroyImage(m_offscreen_images[i], m_offscreen_image_allocations[i]);
+            }
+            m_offscreen_images.clear();
+            m_offscreen_image_allocations.clear();
+        }
+        else
+        {
+            // swapchain的图像由swapchain持有，随之一起销毁
+            vkDestroySwapchainKHR(m_logical_device, m_swapchain, NULL);
+            m_swapchain = VK_NULL_HANDLE;
+        }
+        m_swapchain_images.clear();
+    }
+
     // 指定颜色通道和类型
     VkSurfaceFormatKHR VulkanRHI::chooseSwapChainSurfaceFormatFromDetails(const std::vector<VkSurfaceFormatKHR>& available_surface_formats) {
         for (const auto& surface_format : available_surface_formats)
@@ -166,15 +293,20 @@ namespace Mercury
 
     // 显示模式可以说是交换链中最重要的设置，因为它代表了向屏幕显示图像的实际条件。
     // https://vulkan-tutorial.com/Drawing_a_triangle/Presentation/Swap_chain#page_Surface-format
+    // https://vulkan-tutorial.com/Drawing_a_triangle/Presentation/Swap_chain#page_Presentation-mode
+    // FIFO：垂直同步，交换链是一个队列，显示器刷新时从队列前端取一幅图像，队列满时程序必须等待，功耗最低。
+    // MAILBOX：三重缓冲，队列满时用新图像替换已排队的图像，不撕裂且延迟较低，但GPU会持续满负荷渲染。
+    // IMMEDIATE：立即显示，延迟最低但可能撕裂。
     VkPresentModeKHR VulkanRHI::chooseSwapchainPresentModeFromDetails(const std::vector<VkPresentModeKHR>& available_present_modes) {
+        VkPresentModeKHR chosen_present_mode = VK_PRESENT_MODE_FIFO_KHR; // 规范要求所有设备都支持FIFO
         for (VkPresentModeKHR present_mode : available_present_modes) {
-            if (VK_PRESENT_MODE_MAILBOX_KHR == present_mode) {
-                return VK_PRESENT_MODE_MAILBOX_KHR; // 垂直同步，交换链是一个队列，当显示器刷新时，显示器从队列前端获取一幅图像，程序在队列后端插入渲染后的图像。如果队列已满，那么程序必须等待。
+            if ((VkPresentModeKHR)m_requested_present_mode == present_mode) {
+                chosen_present_mode = present_mode;
+                break;
             }
-
         }
-        //三重缓冲：当队列已满时，不会阻塞应用程序，而是简单地用新的映像替换已经排队的映像。这种模式可以用来尽可能快地呈现帧，同时还可以避免撕裂，从而比标准的垂直同步减少延迟问题。
-        return VK_PRESENT_MODE_FIFO_KHR;
+        m_present_mode = (RHIPresentModeKHR)chosen_present_mode;
+        return chosen_present_mode;
     }
 
     // 交换范围是交换链图像的分辨率，它几乎总是完全等于我们正在绘制的窗口的分辨率(以像素为单位)。可能的分辨率范围在 VkSurfaceCapabilitiesKHR 结构中定义
@@ -223,27 +355,57 @@ namespace Mercury
 
         }
 
+        updateSwapchainDesc();
+
         std::cout << "createSwapchainImageViews success!" << std::endl;
 
     }
 
+    void VulkanRHI::updateSwapchainDesc()
+    {
+        m_swapchain_desc.imageFormat = m_swapchain_images_format;
+        m_swapchain_desc.extent = m_swapchain_extend;
+        m_swapchain_desc.scissor = &m_scissor;
+        m_swapchain_desc.viewport = &m_viewport;
+        m_swapchain_desc.imageViews = m_swapchain_imageviews;
+
+        // swapchain的VkImage由驱动持有，这里只包装成RHIImage供barrier等使用
+        for (auto image : m_swapchain_desc.images)
+        {
+            delete image;
+        }
+        m_swapchain_desc.images.resize(m_swapchain_images.size());
+        for (size_t i = 0; i < m_swapchain_images.size(); i++)
+        {
+            m_swapchain_desc.images[i] = new VulkanImage();
+            ((VulkanImage*)m_swapchain_desc.images[i])->setResource(m_swapchain_images[i]);
+        }
+        ++m_swapchain_desc.generation;
+    }
+
     // create color buffer and depth buffer
     void VulkanRHI::createFramebufferImageAndView()
     {
-        VulkanUtil::createImage(m_physical_device,
-            m_logical_device,
-            m_swapchain_extend.width,
-            m_swapchain_extend.height,
-            (VkFormat)m_depth_image_format,
-            VK_IMAGE_TILING_OPTIMAL,
-            VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            ((VulkanImage*)m_depth_image)->getResource(),
-            m_depth_image_memory,
-            0,
-            1,
-            1
-        );
+        // 深度缓冲通过VMA从设备本地内存块中子分配，而不是单独调用一次vkAllocateMemory
+        RHIImageCreateInfo image_create_info{};
+        image_create_info.sType = RHI_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        image_create_info.imageType = RHI_IMAGE_TYPE_2D;
+        image_create_info.format = m_depth_image_format;
+        image_create_info.extent = { m_swapchain_extend.width, m_swapchain_extend.height, 1 };
+        image_create_info.mipLevels = 1;
+        image_create_info.arrayLayers = 1;
+        image_create_info.samples = RHI_SAMPLE_COUNT_1_BIT;
+        image_create_info.tiling = RHI_IMAGE_TILING_OPTIMAL;
+        image_create_info.usage = RHI_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | RHI_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | RHI_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        image_create_info.sharingMode = RHI_SHARING_MODE_EXCLUSIVE;
+        image_create_info.initialLayout = RHI_IMAGE_LAYOUT_UNDEFINED;
+
+        RHIAllocationCreateInfo allocation_create_info{};
+        allocation_create_info.usage = RHI_MEMORY_USAGE_GPU_ONLY;
+        allocation_create_info.requiredFlags = RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+        createImage(&image_create_info, &allocation_create_info, m_depth_image, m_depth_image_allocation, nullptr);
+
         ((VulkanImageView*)m_depth_image_view)->setResource(
             VulkanUtil::createImageView(
                 m_logical_device,
@@ -281,7 +443,8 @@ namespace Mercury
 
     void VulkanRHI::createInstance() {
 
-        m_vulkan_api_version = VK_API_VERSION_1_0;
+        // timeline semaphore从1.2开始是核心功能
+        m_vulkan_api_version = VK_API_VERSION_1_2;
 
         // app info
         VkApplicationInfo appInfo{};
@@ -342,6 +505,17 @@ namespace Mercury
         }
     }
 
+    void VulkanRHI::destroyDebugUtilsMessengerEXT(VkInstance instance,
+        VkDebugUtilsMessengerEXT debugMessenger,
+        const VkAllocationCallbacks* pAllocator) {
+        auto func =
+            (PFN_vkDestroyDebugUtilsMessengerEXT)vkGetInstanceProcAddr(instance, "vkDestroyDebugUtilsMessengerEXT");
+        if (func != nullptr)
+        {
+            func(instance, debugMessenger, pAllocator);
+        }
+    }
+
     // 启动验证层从而在debug版本中发现可能存在的错误
     void VulkanRHI::initializeDebugMessenger()
     {
@@ -426,6 +600,7 @@ namespace Mercury
                 {
                     std::runtime_error("failed to find suitable physical device");
                 }
+                vkGetPhysicalDeviceProperties(m_physical_device, &m_physical_device_properties);
 
                 std::cout << "m_physical_device: " << m_physical_device << std::endl;
             }
@@ -441,8 +616,8 @@ namespace Mercury
 
         // 交换链与物理设备设备的兼容性检查
         bool is_extensions_supported = checkDeviceExtensionSupport(physical_device);
-        bool is_swapchain_adequate = false;
-        if (is_extensions_supported)
+        bool is_swapchain_adequate = m_is_headless; // headless不需要swapchain
+        if (is_extensions_supported && !m_is_headless)
         {
             // 仅仅检查交换链是否可用是不够的，需要与窗口表面兼容等，因此需要查询更多的详细信息
             SwapChainSupportDetails swapchain_support_details = querySwapChainSupport(physical_device);
@@ -453,7 +628,23 @@ namespace Mercury
         VkPhysicalDeviceFeatures physicalm_device_features;
         vkGetPhysicalDeviceFeatures(physical_device, &physicalm_device_features);
 
-        if (!queue_indices.isComplete() || !is_swapchain_adequate || !physicalm_device_features.samplerAnisotropy)
+        // 帧同步依赖timeline semaphore：设备需要支持Vulkan 1.2并开启timelineSemaphore功能
+        VkPhysicalDeviceProperties physical_device_properties;
+        vkGetPhysicalDeviceProperties(physical_device, &physical_device_properties);
+        bool is_timeline_semaphore_supported = false;
+        if (physical_device_properties.apiVersion >= VK_API_VERSION_1_2)
+        {
+            VkPhysicalDeviceVulkan12Features vulkan12_features{};
+            vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+            VkPhysicalDeviceFeatures2 physical_device_features2{};
+            physical_device_features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            physical_device_features2.pNext = &vulkan12_features;
+            vkGetPhysicalDeviceFeatures2(physical_device, &physical_device_features2);
+            is_timeline_semaphore_supported = vulkan12_features.timelineSemaphore == VK_TRUE;
+        }
+
+        if (!queue_indices.isComplete() || !is_swapchain_adequate || !physicalm_device_features.samplerAnisotropy ||
+            !is_timeline_semaphore_supported)
         {
             return false;
         }
@@ -471,6 +662,28 @@ namespace Mercury
         std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
         vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, queue_families.data());
 
+        // 支持计算但不支持图形的队列族用于async compute，计算工作可以与光栅化并行
+        for (uint32_t family_index = 0; family_index < queue_family_count; ++family_index)
+        {
+            const VkQueueFlags queue_flags = queue_families[family_index].queueFlags;
+            if ((queue_flags & VK_QUEUE_COMPUTE_BIT) && !(queue_flags & VK_QUEUE_GRAPHICS_BIT))
+            {
+                indices.m_compute_family = family_index;
+                break;
+            }
+        }
+
+        // 只支持传输（不支持图形和计算）的队列族通常对应独立的DMA引擎，上传可以与渲染并行
+        for (uint32_t family_index = 0; family_index < queue_family_count; ++family_index)
+        {
+            const VkQueueFlags queue_flags = queue_families[family_index].queueFlags;
+            if ((queue_flags & VK_QUEUE_TRANSFER_BIT) && !(queue_flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+            {
+                indices.transfer_family = family_index;
+                break;
+            }
+        }
+
         int i = 0;
         for (const auto& queue_family : queue_families)
         {
@@ -479,20 +692,28 @@ namespace Mercury
                 indices.graphics_family = i;
             }
 
-            if (queue_family.queueFlags & VK_QUEUE_COMPUTE_BIT) // if support compute command queue
+            if ((queue_family.queueFlags & VK_QUEUE_COMPUTE_BIT) && !indices.m_compute_family.has_value()) // if support compute command queue
             {
                 indices.m_compute_family = i;
             }
 
 
-            VkBool32 is_present_support = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(physical_device,
-                i,
-                m_surface,
-                &is_present_support); // if support surface presentation
-            if (is_present_support)
+            if (m_is_headless)
+            {
+                // 没有surface也就没有present队列，用图形队列族占位，后面按队列族创建队列的逻辑不需要改动
+                indices.present_family = indices.graphics_family;
+            }
+            else
             {
-                indices.present_family = i;
+                VkBool32 is_present_support = false;
+                vkGetPhysicalDeviceSurfaceSupportKHR(physical_device,
+                    i,
+                    m_surface,
+                    &is_present_support); // if support surface presentation
+                if (is_present_support)
+                {
+                    indices.present_family = i;
+                }
             }
 
             // 各个需要的队列家族都拥有对应索引后退出
@@ -502,6 +723,11 @@ namespace Mercury
             }
             i++;
         }
+        if (!indices.transfer_family.has_value())
+        {
+            // 图形队列族一定支持传输
+            indices.transfer_family = indices.graphics_family;
+        }
         return indices;
     }
 
@@ -524,6 +750,42 @@ namespace Mercury
         return required_extensions.empty();
     }
 
+    bool VulkanRHI::isInstanceExtensionSupported(const char* extension_name)
+    {
+        uint32_t extension_count;
+        vkEnumerateInstanceExtensionProperties(nullptr, &extension_count, nullptr);
+
+        std::vector<VkExtensionProperties> available_extensions(extension_count);
+        vkEnumerateInstanceExtensionProperties(nullptr, &extension_count, available_extensions.data());
+
+        for (const auto& extension : available_extensions)
+        {
+            if (strcmp(extension.extensionName, extension_name) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool VulkanRHI::isDeviceExtensionSupported(VkPhysicalDevice physical_device, const char* extension_name)
+    {
+        uint32_t extension_count;
+        vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, nullptr);
+
+        std::vector<VkExtensionProperties> available_extensions(extension_count);
+        vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, available_extensions.data());
+
+        for (const auto& extension : available_extensions)
+        {
+            if (strcmp(extension.extensionName, extension_name) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
     Mercury::SwapChainSupportDetails VulkanRHI::querySwapChainSupport(VkPhysicalDevice physical_device) {
         SwapChainSupportDetails details;
 
@@ -558,7 +820,8 @@ namespace Mercury
         float queue_priority = 1.0f;
         std::set<uint32_t> queue_families = { m_queue_indices.graphics_family.value(), // m_queue_indices在isDeviceSuitable()中获得
                 m_queue_indices.present_family.value(),
-                m_queue_indices.m_compute_family.value() };
+                m_queue_indices.m_compute_family.value(),
+                m_queue_indices.transfer_family.value() };
         for (uint32_t queue_family : queue_families) { // for every queue family
             // queue create info
             VkDeviceQueueCreateInfo queue_create_info{};
@@ -575,6 +838,10 @@ namespace Mercury
         physical_device_features.samplerAnisotropy = VK_TRUE; // 指定是否支持各向异性过滤
         physical_device_features.fragmentStoresAndAtomics = VK_TRUE;  // 指定存储缓冲区和图像是否支持片段着色器阶段中的存储和原子操作。      
         physical_device_features.independentBlend = VK_TRUE; // 指定是否对每个附件独立地控制 VkPipelineColorBlendAttachmentState 设置。
+        // 1.2的功能通过pNext链开启
+        VkPhysicalDeviceVulkan12Features vulkan12_features{};
+        vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        vulkan12_features.timelineSemaphore = VK_TRUE;
 
         // 创建逻辑设备
         VkDeviceCreateInfo device_create_info{};
@@ -582,8 +849,17 @@ namespace Mercury
         device_create_info.pQueueCreateInfos = queue_create_infos.data(); // 指针
         device_create_info.queueCreateInfoCount = static_cast<uint32_t>(queue_create_infos.size());
         device_create_info.pEnabledFeatures = &physical_device_features;
-        device_create_info.enabledExtensionCount = static_cast<uint32_t>(m_device_extensions.size());
-        device_create_info.ppEnabledExtensionNames = m_device_extensions.data();
+        device_create_info.pNext = &vulkan12_features;
+        // 可选扩展：VK_EXT_memory_budget让VMA拿到驱动报告的真实显存预算与使用量
+        std::vector<char const*> enabled_device_extensions = m_device_extensions;
+        m_enable_memory_budget = m_enable_memory_budget &&
+            isDeviceExtensionSupported(m_physical_device, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        if (m_enable_memory_budget)
+        {
+            enabled_device_extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+        device_create_info.enabledExtensionCount = static_cast<uint32_t>(enabled_device_extensions.size());
+        device_create_info.ppEnabledExtensionNames = enabled_device_extensions.data();
         if (m_enable_validation_layers) {
             device_create_info.enabledLayerCount = static_cast<uint32_t>(m_validation_layers.size());
             device_create_info.ppEnabledLayerNames = m_validation_layers.data();
@@ -606,10 +882,15 @@ namespace Mercury
         vkGetDeviceQueue(m_logical_device, m_queue_indices.present_family.value(), 0, &m_present_queue);
 
         VkQueue vk_compute_queue;
-        vkGetDeviceQueue(m_logical_device, m_queue_indices.graphics_family.value(), 0, &vk_compute_queue);
+        vkGetDeviceQueue(m_logical_device, m_queue_indices.m_compute_family.value(), 0, &vk_compute_queue);
         m_compute_queue = new VulkanQueue(); // 指向子类对象
         ((VulkanQueue*)m_compute_queue)->setResource(vk_compute_queue);
 
+        VkQueue vk_transfer_queue;
+        vkGetDeviceQueue(m_logical_device, m_queue_indices.transfer_family.value(), 0, &vk_transfer_queue);
+        m_transfer_queue = new VulkanQueue();
+        ((VulkanQueue*)m_transfer_queue)->setResource(vk_transfer_queue);
+
         // more efficient pointer
         // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkGetDeviceProcAddr.html
         // 通过为任何使用设备或设备子对象作为可调度对象的命令获取特定于设备的函数指针，可以避免 VkDevice 对象内部调度的开销。
@@ -622,13 +903,16 @@ namespace Mercury
         _vkCmdBindPipeline = (PFN_vkCmdBindPipeline)vkGetDeviceProcAddr(m_logical_device, "vkCmdBindPipeline");
         _vkCmdSetViewport = (PFN_vkCmdSetViewport)vkGetDeviceProcAddr(m_logical_device, "vkCmdSetViewport");
         _vkCmdSetScissor = (PFN_vkCmdSetScissor)vkGetDeviceProcAddr(m_logical_device, "vkCmdSetScissor");
-        _vkWaitForFences = (PFN_vkWaitForFences)vkGetDeviceProcAddr(m_logical_device, "vkWaitForFences");
-        _vkResetFences = (PFN_vkResetFences)vkGetDeviceProcAddr(m_logical_device, "vkResetFences");
+        _vkWaitSemaphores = (PFN_vkWaitSemaphores)vkGetDeviceProcAddr(m_logical_device, "vkWaitSemaphores");
+        _vkGetSemaphoreCounterValue = (PFN_vkGetSemaphoreCounterValue)vkGetDeviceProcAddr(m_logical_device, "vkGetSemaphoreCounterValue");
         _vkCmdDrawIndexed = (PFN_vkCmdDrawIndexed)vkGetDeviceProcAddr(m_logical_device, "vkCmdDrawIndexed");
         _vkCmdBindVertexBuffers = (PFN_vkCmdBindVertexBuffers)vkGetDeviceProcAddr(m_logical_device, "vkCmdBindVertexBuffers");
         _vkCmdBindIndexBuffer = (PFN_vkCmdBindIndexBuffer)vkGetDeviceProcAddr(m_logical_device, "vkCmdBindIndexBuffer");
         _vkCmdBindDescriptorSets = (PFN_vkCmdBindDescriptorSets)vkGetDeviceProcAddr(m_logical_device, "vkCmdBindDescriptorSets");
         _vkCmdClearAttachments = (PFN_vkCmdClearAttachments)vkGetDeviceProcAddr(m_logical_device, "vkCmdClearAttachments");
+        _vkCmdExecuteCommands = (PFN_vkCmdExecuteCommands)vkGetDeviceProcAddr(m_logical_device, "vkCmdExecuteCommands");
+        _vkCmdWriteTimestamp = (PFN_vkCmdWriteTimestamp)vkGetDeviceProcAddr(m_logical_device, "vkCmdWriteTimestamp");
+        _vkCmdResetQueryPool = (PFN_vkCmdResetQueryPool)vkGetDeviceProcAddr(m_logical_device, "vkCmdResetQueryPool");
 
         // 找到支持的深度缓冲格式: https://vulkan-tutorial.com/Depth_buffering
         // 应该具有与颜色附件相同的分辨率(由交换链范围定义) ，适用于深度附件、最佳拼接和设备本地内存的图像使用
@@ -710,6 +994,26 @@ namespace Mercury
             }
         }
 
+        // 录制线程各自的command pool，与上面的每帧command pool一样在帧开始时整体重置
+        {
+            VkCommandPoolCreateInfo command_pool_create_info{};
+            command_pool_create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            command_pool_create_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            command_pool_create_info.queueFamilyIndex = m_queue_indices.graphics_family.value();
+
+            for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+            {
+                m_worker_command_pools[i].resize(m_command_recording_worker_count);
+                for (WorkerCommandPool& worker_command_pool : m_worker_command_pools[i])
+                {
+                    if (vkCreateCommandPool(m_logical_device, &command_pool_create_info, nullptr, &worker_command_pool.command_pool) != VK_SUCCESS)
+                    {
+                        throw std::runtime_error("failed to create worker command pool!");
+                    }
+                }
+            }
+        }
+
         std::cout << "create command pool success!" << std::endl;
     }
 
@@ -741,63 +1045,43 @@ namespace Mercury
 
     bool VulkanRHI::prepareBeforePass(std::function<void()> passUpdateAfterRecreateSwapchain)
     {
-        // https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Rendering_and_presentation#page_Acquiring-an-image-from-the-swap-chain
-        VkResult acquire_image_result =
-            vkAcquireNextImageKHR(m_logical_device,
-                m_swapchain,
-                UINT64_MAX,
-                m_image_available_for_render_semaphores[m_current_frame_index],
-                VK_NULL_HANDLE,
-                &m_current_swapchain_image_index);
-
-        // https://vulkan-tutorial.com/Drawing_a_triangle/Swap_chain_recreation#page_Suboptimal-or-out-of-date-swap-chain
-        if (VK_ERROR_OUT_OF_DATE_KHR == acquire_image_result) // 交换链已与表面不兼容，不能再用于呈现。通常发生在调整窗口大小之后。
+        MERCURY_PROFILE_SCOPE("VulkanRHI::prepareBeforePass");
+        if (m_is_headless)
         {
-            recreateSwapchain();
-            passUpdateAfterRecreateSwapchain();
-            return RHI_SUCCESS;
+            // 离屏图像与帧一一对应，waitForFrameInFlight之后这一帧的图像已不再被GPU使用，不需要acquire
+            m_current_swapchain_image_index = m_current_frame_index;
         }
-        else if (VK_SUBOPTIMAL_KHR == acquire_image_result) // 交换链仍可用于成功呈现曲面，但曲面属性已不再完全匹配。
+        else
         {
-            recreateSwapchain();
-            passUpdateAfterRecreateSwapchain();
-
-
-            VkSubmitInfo         submit_info = {};
-            submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-
-            VkPipelineStageFlags wait_stages[] = { VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT };
-            submit_info.waitSemaphoreCount = 1;
-            submit_info.pWaitSemaphores = &m_image_available_for_render_semaphores[m_current_frame_index];
-            submit_info.pWaitDstStageMask = wait_stages;
-            submit_info.commandBufferCount = 0;
-            submit_info.pCommandBuffers = NULL;
-            submit_info.signalSemaphoreCount = 0;
-            submit_info.pSignalSemaphores = NULL;
-
-            VkResult res_reset_fences = _vkResetFences(m_logical_device, 1, &m_is_frame_in_flight_fences[m_current_frame_index]);
-            if (VK_SUCCESS != res_reset_fences)
+            // https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Rendering_and_presentation#page_Acquiring-an-image-from-the-swap-chain
+            VkResult acquire_image_result =
+                vkAcquireNextImageKHR(m_logical_device,
+                    m_swapchain,
+                    UINT64_MAX,
+                    m_image_available_for_render_semaphores[m_current_frame_index],
+                    VK_NULL_HANDLE,
+                    &m_current_swapchain_image_index);
+
+            // https://vulkan-tutorial.com/Drawing_a_triangle/Swap_chain_recreation#page_Suboptimal-or-out-of-date-swap-chain
+            if (VK_ERROR_OUT_OF_DATE_KHR == acquire_image_result) // 交换链已与表面不兼容，不能再用于呈现。通常发生在调整窗口大小之后。
             {
-                throw std::runtime_error("_vkResetFences failed!");
-                return false;
+                recreateSwapchain();
+                passUpdateAfterRecreateSwapchain();
+                return RHI_SUCCESS;
             }
-
-            VkResult res_queue_submit =
-                vkQueueSubmit(((VulkanQueue*)m_graphics_queue)->getResource(), 1, &submit_info, m_is_frame_in_flight_fences[m_current_frame_index]);
-            if (VK_SUCCESS != res_queue_submit)
+            else if (VK_SUBOPTIMAL_KHR == acquire_image_result) // 交换链仍可用于成功呈现曲面，但曲面属性已不再完全匹配。
             {
-                throw std::runtime_error("vkQueueSubmit failed!");
-                return false;
+                // 图像已经获取成功、信号量也会被signal：照常渲染并present这一帧，present之后再重建。
+                // 不需要为了消耗信号量、重新signal fence而做一次空提交
+                m_is_swapchain_recreate_requested = true;
             }
-            m_current_frame_index = (m_current_frame_index + 1) % k_max_frames_in_flight;
-            return RHI_SUCCESS;
-        }
-        else
-        {
-            if (VK_SUCCESS != acquire_image_result)
+            else
             {
-                throw std::runtime_error("vkAcquireNextImageKHR failed!");
-                return false;
+                if (VK_SUCCESS != acquire_image_result)
+                {
+                    throw std::runtime_error("vkAcquireNextImageKHR failed!");
+                    return false;
+                }
             }
         }
 
@@ -815,11 +1099,25 @@ namespace Mercury
             throw std::runtime_error("_vkBeginCommandBuffer failed!");
             return false;
         }
+
+        // 这一帧槽位已经等待过，上一次使用这组查询的帧已在GPU上完成：先读回结果，再在命令缓冲区开头重置查询
+        if (m_is_gpu_timestamp_supported)
+        {
+            resolveGpuTimestamps();
+            _vkCmdResetQueryPool(m_vk_command_buffers[m_current_frame_index],
+                m_gpu_timestamp_frames[m_current_frame_index].query_pool,
+                0,
+                k_max_gpu_timestamp_count);
+        }
+
+        // 把到目前为止请求的上传作为一个批次提交到传输队列，所有权的acquire屏障录制在这一帧的最前面
+        m_upload_wait_value = m_upload_manager.flush(m_vk_command_buffers[m_current_frame_index]);
         return false;
     }
 
     void VulkanRHI::submitRendering(std::function<void()> passUpdateAfterRecreateSwapchain)
     {
+        MERCURY_PROFILE_SCOPE("VulkanRHI::submitRendering");
         // end command buffer
         VkResult res_end_command_buffer = _vkEndCommandBuffer(m_vk_command_buffers[m_current_frame_index]);
         if (VK_SUCCESS != res_end_command_buffer)
@@ -828,48 +1126,92 @@ namespace Mercury
             return;
         }
 
-        // 信号量 Semaphores
-        VkSemaphore semaphores[1] = {
+        // 信号量 Semaphores：帧时间线signal为新的值；非headless时还要signal给present等待的二值信号量（它的值被忽略）
+        const uint64_t frame_timeline_value = m_frame_timeline_value + 1;
+        VkSemaphore semaphores[2] = {
             //((VulkanSemaphore*)m_image_available_for_texturescopy_semaphores[m_current_frame_index])->getResource(),
+            m_frame_timeline_semaphore,
             m_image_finished_for_presentation_semaphores[m_current_frame_index] };
+        uint64_t signal_values[2] = { frame_timeline_value, 0 };
+        const uint32_t signal_semaphore_count = m_is_headless ? 1 : 2;
+
+        // 等待：swapchain图像可用（headless没有acquire），以及这一帧提交的上传批次完成
+        VkSemaphore wait_semaphores[3];
+        uint64_t wait_values[3];
+        VkPipelineStageFlags wait_stages[3];
+        uint32_t wait_semaphore_count = 0;
+        if (!m_is_headless)
+        {
+            wait_semaphores[wait_semaphore_count] = m_image_available_for_render_semaphores[m_current_frame_index];
+            wait_values[wait_semaphore_count] = 0;
+            wait_stages[wait_semaphore_count] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            ++wait_semaphore_count;
+        }
+        if (m_upload_wait_value != 0)
+        {
+            wait_semaphores[wait_semaphore_count] = m_upload_manager.getTimelineSemaphore();
+            wait_values[wait_semaphore_count] = m_upload_wait_value;
+            wait_stages[wait_semaphore_count] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT; // 上传的数据可能在任何阶段被读取
+            ++wait_semaphore_count;
+        }
+        if (m_graphics_async_compute_wait_value != 0)
+        {
+            wait_semaphores[wait_semaphore_count] = m_async_compute_timeline_semaphore;
+            wait_values[wait_semaphore_count] = m_graphics_async_compute_wait_value;
+            wait_stages[wait_semaphore_count] = m_graphics_async_compute_wait_stages;
+            ++wait_semaphore_count;
+            m_graphics_async_compute_wait_value = 0;
+            m_graphics_async_compute_wait_stages = 0;
+        }
+
+        VkTimelineSemaphoreSubmitInfo timeline_submit_info{};
+        timeline_submit_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timeline_submit_info.waitSemaphoreValueCount = wait_semaphore_count;
+        timeline_submit_info.pWaitSemaphoreValues = wait_values;
+        timeline_submit_info.signalSemaphoreValueCount = signal_semaphore_count;
+        timeline_submit_info.pSignalSemaphoreValues = signal_values;
 
         // Submitting the command buffer:https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Rendering_and_presentation#page_Submitting-the-command-buffer
-        VkPipelineStageFlags wait_stages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
         VkSubmitInfo         submit_info = {};
         submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.pNext = &timeline_submit_info;
         /*
         前三个参数指定了执行开始前要等待的 Semaphores，以及要等待的流水线阶段。
         我们希望等待将颜色写入图像，直到图像可用为止，因此我们指定了图形流水线中写入颜色附件的阶段。
         这意味着理论上，当图像尚未可用时，执行程序已经可以开始执行顶点着色器等程序。waitStages 数组中的每个条目都与 pWaitSemaphores 中具有相同索引的信号对应。
         */
-        submit_info.waitSemaphoreCount = 1;
-        submit_info.pWaitSemaphores = &m_image_available_for_render_semaphores[m_current_frame_index];
+        submit_info.waitSemaphoreCount = wait_semaphore_count;
+        submit_info.pWaitSemaphores = wait_semaphores;
         submit_info.pWaitDstStageMask = wait_stages;
         /* 接下来的两个参数指定了要实际提交执行的命令缓冲区。我们只需提交现有的单个命令缓冲区。 */
         submit_info.commandBufferCount = 1;
         submit_info.pCommandBuffers = &m_vk_command_buffers[m_current_frame_index];
         /* signalSemaphoreCount 和 pSignalSemaphores 参数指定一旦命令缓冲区执行完毕，要向哪些 semaphore 发送信号。 */
-        submit_info.signalSemaphoreCount = 1;
+        submit_info.signalSemaphoreCount = signal_semaphore_count;
         submit_info.pSignalSemaphores = semaphores;
 
-        VkResult res_reset_fences = _vkResetFences(m_logical_device, 1, &m_is_frame_in_flight_fences[m_current_frame_index]);
-
-        if (VK_SUCCESS != res_reset_fences)
-        {
-            throw std::runtime_error("_vkResetFences failed!");
-            return;
-        }
         /*
         使用 vkQueueSubmit 将命令缓冲区提交到图形队列。
         该函数使用 VkSubmitInfo 结构数组作为参数，以便在工作量较大时提高效率。
-        最后一个参数引用了一个可选的栅栏，该栅栏将在命令缓冲区执行完毕时发出信号。这样我们就能知道何时可以安全地重复使用命令缓冲区，因此我们希望赋予它 inFlightFence。
-        现在，在下一帧中，CPU 将等待命令缓冲区执行完毕，然后再向其中记录新命令。 */
-        VkResult res_queue_submit = vkQueueSubmit(((VulkanQueue*)m_graphics_queue)->getResource(), 1, &submit_info, m_is_frame_in_flight_fences[m_current_frame_index]);
+        最后一个参数是可选的栅栏；这里不再需要它，命令缓冲区执行完毕时帧时间线会到达frame_timeline_value，
+        下一次复用这个帧槽位前CPU等待这个值，然后再向命令缓冲区中记录新命令。 */
+        m_gpu_timestamp_frames[m_current_frame_index].cpu_submit_time = Profiler::now();
+        VkResult res_queue_submit = vkQueueSubmit(((VulkanQueue*)m_graphics_queue)->getResource(), 1, &submit_info, VK_NULL_HANDLE);
         if (VK_SUCCESS != res_queue_submit)
         {
             throw std::runtime_error("vkQueueSubmit failed!");
             return;
         }
+        m_frame_timeline_value = frame_timeline_value;
+        m_frame_slot_timeline_values[m_current_frame_index] = frame_timeline_value;
+
+        if (m_is_headless)
+        {
+            // 没有present，提交后这一帧就结束了；present mode对离屏图像没有意义，忽略切换请求
+            m_is_swapchain_recreate_requested = false;
+            m_current_frame_index = (m_current_frame_index + 1) % m_frames_in_flight;
+            return;
+        }
 
         // https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Rendering_and_presentation#page_Presentation
         // 绘制帧的最后一步是将结果提交回交换链，使其最终显示在屏幕上。
@@ -886,7 +1228,8 @@ namespace Mercury
         present_info.pImageIndices = &m_current_swapchain_image_index;
 
         VkResult present_result = vkQueuePresentKHR(m_present_queue, &present_info);
-        if (VK_ERROR_OUT_OF_DATE_KHR == present_result || VK_SUBOPTIMAL_KHR == present_result)
+        // 切换present mode也需要重建swapchain
+        if (VK_ERROR_OUT_OF_DATE_KHR == present_result || VK_SUBOPTIMAL_KHR == present_result || m_is_swapchain_recreate_requested)
         {
             recreateSwapchain();
             passUpdateAfterRecreateSwapchain();
@@ -900,7 +1243,7 @@ namespace Mercury
             }
         }
 
-        m_current_frame_index = (m_current_frame_index + 1) % k_max_frames_in_flight;
+        m_current_frame_index = (m_current_frame_index + 1) % m_frames_in_flight;
     }
 
     void VulkanRHI::pushEvent(RHICommandBuffer* command_buffer, const char* name, const float* color) {
@@ -915,102 +1258,472 @@ namespace Mercury
             VkCommandBuffer res = ((VulkanCommandBuffer*)command_buffer)->getResource();
             _vkCmdBeginDebugUtilsLabelEXT(res, &label_info);
         }
+
+        // 与标签无关，release构建中同样计时；secondary command buffer可能在其他线程上录制，只打标签不计时
+        if (m_is_gpu_timestamp_supported && isCurrentPrimaryCommandBuffer(command_buffer)) {
+            GpuTimestampFrame& frame = m_gpu_timestamp_frames[m_current_frame_index];
+            if (frame.query_count + 2 > k_max_gpu_timestamp_count) {
+                // 超出上限的区间不计时，但仍然入栈，保证与popEvent一一对应
+                m_open_gpu_regions.push_back(UINT32_MAX);
+                return;
+            }
+            m_open_gpu_regions.push_back(static_cast<uint32_t>(frame.regions.size()));
+            frame.regions.push_back({ name, static_cast<uint32_t>(m_open_gpu_regions.size() - 1), frame.query_count });
+            _vkCmdWriteTimestamp(((VulkanCommandBuffer*)command_buffer)->getResource(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.query_pool, frame.query_count);
+            frame.query_count += 2;
+        }
     }
 
     void VulkanRHI::popEvent(RHICommandBuffer* command_buffer) {
         if (m_enable_debug_utils_label) {
             _vkCmdEndDebugUtilsLabelEXT(((VulkanCommandBuffer*)command_buffer)->getResource());
         }
+
+        if (m_is_gpu_timestamp_supported && isCurrentPrimaryCommandBuffer(command_buffer) && !m_open_gpu_regions.empty()) {
+            uint32_t region_index = m_open_gpu_regions.back();
+            m_open_gpu_regions.pop_back();
+            if (region_index != UINT32_MAX) {
+                GpuTimestampFrame& frame = m_gpu_timestamp_frames[m_current_frame_index];
+                _vkCmdWriteTimestamp(((VulkanCommandBuffer*)command_buffer)->getResource(), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.query_pool, frame.regions[region_index].begin_query + 1);
+            }
+        }
     }
 
-    void VulkanRHI::cmdSetViewportPFN(RHICommandBuffer* commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const RHIViewport* pViewports) {
-        // viewprot
-        int viewport_size = viewportCount;
-        std::vector<VkViewport> vk_viewport_list(viewport_size);
-        for (int i = 0; i < viewport_size; i++)
+    bool VulkanRHI::isCurrentPrimaryCommandBuffer(RHICommandBuffer* command_buffer) const
+    {
+        return ((VulkanCommandBuffer*)command_buffer)->getResource() == m_vk_command_buffers[m_current_frame_index];
+    }
+
+    // https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#queries-timestamps
+    void VulkanRHI::createGpuTimestampQueryPools()
+    {
+        // 图形队列族的timestampValidBits为0表示该队列不支持写入timestamp
+        uint32_t queue_family_count = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_physical_device, &queue_family_count, nullptr);
+        std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+        vkGetPhysicalDeviceQueueFamilyProperties(m_physical_device, &queue_family_count, queue_families.data());
+        const uint32_t timestamp_valid_bits = queue_families[m_queue_indices.graphics_family.value()].timestampValidBits;
+
+        m_is_gpu_timestamp_supported = timestamp_valid_bits > 0 && m_physical_device_properties.limits.timestampPeriod > 0.f;
+        if (!m_is_gpu_timestamp_supported)
         {
-            const auto& rhi_viewport_element = pViewports[i];
-            auto& vk_viewport_element = vk_viewport_list[i];
+            std::cout << "gpu timestamp query is not supported, gpu timings disabled" << std::endl;
+            return;
+        }
+        m_timestamp_mask = timestamp_valid_bits >= 64 ? ~0ull : ((1ull << timestamp_valid_bits) - 1);
+        m_timestamp_period = m_physical_device_properties.limits.timestampPeriod;
 
-            vk_viewport_element.x = rhi_viewport_element.x;
-            vk_viewport_element.y = rhi_viewport_element.y;
-            vk_viewport_element.width = rhi_viewport_element.width;
-            vk_viewport_element.height = rhi_viewport_element.height;
-            vk_viewport_element.minDepth = rhi_viewport_element.minDepth;
-            vk_viewport_element.maxDepth = rhi_viewport_element.maxDepth;
+        VkQueryPoolCreateInfo query_pool_create_info{};
+        query_pool_create_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        query_pool_create_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        query_pool_create_info.queryCount = k_max_gpu_timestamp_count;
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            if (vkCreateQueryPool(m_logical_device, &query_pool_create_info, nullptr, &m_gpu_timestamp_frames[i].query_pool) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create timestamp query pool!");
+            }
+        }
+        // 每个查询的结果是[timestamp, availability]两个64位值
+        m_gpu_timestamp_results.resize(k_max_gpu_timestamp_count * 2);
+        // 区间数量有上限，预先分配好，录制时pushEvent不再分配内存
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            m_gpu_timestamp_frames[i].regions.reserve(k_max_gpu_timestamp_count / 2);
         }
-        return _vkCmdSetViewport(((VulkanCommandBuffer*)commandBuffer)->getResource(), firstViewport, viewportCount, vk_viewport_list.data());
+        m_open_gpu_regions.reserve(k_max_gpu_timestamp_count / 2);
+        m_gpu_timings.reserve(k_max_gpu_timestamp_count / 2);
+
+        std::cout << "create gpu timestamp query pools success!" << std::endl;
     }
 
-    void VulkanRHI::cmdSetScissorPFN(RHICommandBuffer* commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const RHIRect2D* pScissors)
+    void VulkanRHI::resolveGpuTimestamps()
     {
-        //rect_2d
-        int rect_2d_size = scissorCount;
-        std::vector<VkRect2D> vk_rect_2d_list(rect_2d_size);
-        for (int i = 0; i < rect_2d_size; ++i)
+        GpuTimestampFrame& frame = m_gpu_timestamp_frames[m_current_frame_index];
+        m_open_gpu_regions.clear();
+        if (frame.query_count == 0)
         {
-            const auto& rhi_rect_2d_element = pScissors[i];
-            auto& vk_rect_2d_element = vk_rect_2d_list[i];
+            return;
+        }
 
-            VkOffset2D offset_2d{};
-            offset_2d.x = rhi_rect_2d_element.offset.x;
-            offset_2d.y = rhi_rect_2d_element.offset.y;
+        // 不等待：fence已经完成，查询结果都已可用；没有pop的区间对应的查询不可用，按availability跳过
+        VkResult result = vkGetQueryPoolResults(m_logical_device,
+            frame.query_pool,
+            0,
+            frame.query_count,
+            frame.query_count * 2 * sizeof(uint64_t),
+            m_gpu_timestamp_results.data(),
+            2 * sizeof(uint64_t),
+            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        if (VK_SUCCESS == result || VK_NOT_READY == result)
+        {
+            m_gpu_timings.clear();
+            const bool is_capturing = Profiler::isCapturing();
+            bool has_frame_begin_timestamp = false;
+            uint64_t frame_begin_timestamp = 0;
+            for (const GpuTimestampRegion& region : frame.regions)
+            {
+                const uint64_t* begin = &m_gpu_timestamp_results[region.begin_query * 2];
+                const uint64_t* end = begin + 2;
+                if (begin[1] == 0 || end[1] == 0)
+                {
+                    continue;
+                }
+                const double nanoseconds = static_cast<double>((end[0] - begin[0]) & m_timestamp_mask) * m_timestamp_period;
+                m_gpu_timings.push_back({ region.name, region.depth, static_cast<float>(nanoseconds * 1e-6) });
 
-            VkExtent2D extent_2d{};
-            extent_2d.width = rhi_rect_2d_element.extent.width;
-            extent_2d.height = rhi_rect_2d_element.extent.height;
+                if (is_capturing)
+                {
+                    // GPU与CPU的时钟没有校准，把这一帧第一个区间的开始对齐到提交时刻：一帧之内各区间的相对位置和长度是准确的
+                    if (!has_frame_begin_timestamp)
+                    {
+                        frame_begin_timestamp = begin[0];
+                        has_frame_begin_timestamp = true;
+                    }
+                    const int64_t begin_time = frame.cpu_submit_time +
+                        static_cast<int64_t>(static_cast<double>((begin[0] - frame_begin_timestamp) & m_timestamp_mask) * m_timestamp_period);
+                    Profiler::recordGpuZone(region.name, begin_time, begin_time + static_cast<int64_t>(nanoseconds));
+                }
+            }
+        }
 
-            vk_rect_2d_element.offset = (VkOffset2D)offset_2d;
-            vk_rect_2d_element.extent = (VkExtent2D)extent_2d;
+        frame.regions.clear();
+        frame.query_count = 0;
+    }
 
-        };
+    void VulkanRHI::cmdSetViewportPFN(RHICommandBuffer* commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const RHIViewport* pViewports) {
+        // RHIViewport与VkViewport布局一致（见文件开头的static_assert），直接传入
+        return _vkCmdSetViewport(((VulkanCommandBuffer*)commandBuffer)->getResource(), firstViewport, viewportCount, reinterpret_cast<const VkViewport*>(pViewports));
+    }
 
-        return _vkCmdSetScissor(((VulkanCommandBuffer*)commandBuffer)->getResource(), firstScissor, scissorCount, vk_rect_2d_list.data());
+    void VulkanRHI::cmdSetScissorPFN(RHICommandBuffer* commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const RHIRect2D* pScissors)
+    {
+        return _vkCmdSetScissor(((VulkanCommandBuffer*)commandBuffer)->getResource(), firstScissor, scissorCount, reinterpret_cast<const VkRect2D*>(pScissors));
     }
 
+    // 描述符池按帧分配和重置，见VulkanDescriptorAllocator
     void VulkanRHI::createDescriptorPool()
     {
+        m_descriptor_allocator.initialize(m_logical_device, k_max_frames_in_flight);
     }
 
-    // semaphore : signal an image is ready for rendering // ready for presentation
-    // (m_vulkan_context._swapchain_images --> semaphores, fences)
-    // https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Rendering_and_presentation#page_Creating-the-synchronization-objects
-    // 有两个地方可以方便地应用同步：交换链操作(semaphores)和等待上一帧完成(fences)。
-    void VulkanRHI::createSyncPrimitives() {
-        VkSemaphoreCreateInfo semaphoreInfo{};
-        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-
-        VkFenceCreateInfo fenceInfo{};
-        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT; // the fence is initialized as signaled
-        /*
-        在第一帧中，我们调用了 drawFrame()，它会立即等待 inFlightFence 发出信号。inFlightFence 只有在一帧完成渲染后才会发出信号，但由于这是第一帧，所以没有前几帧可以发出信号！因此，vkWaitForFences() 会无限期地阻塞，等待永远不会发生的事情。
-        在解决这一难题的众多方案中，API 中内置了一个巧妙的变通方法。在已发出信号的状态下创建栅栏，这样第一次调用 vkWaitForFences() 就会立即返回，因为栅栏已发出信号。
-         */
+    bool VulkanRHI::allocateFrameDescriptorSet(RHIDescriptorSetLayout* layout, RHIDescriptorSet*& pDescriptorSet)
+    {
+        pDescriptorSet = m_descriptor_allocator.allocate(m_current_frame_index, ((VulkanDescriptorSetLayout*)layout)->getResource());
+        return RHI_SUCCESS;
+    }
 
-        for (uint32_t i = 0; i < k_max_frames_in_flight; i++)
+    void VulkanRHI::updateDescriptorSets(uint32_t descriptorWriteCount, const RHIWriteDescriptorSet* pDescriptorWrites)
+    {
+        // 先统计需要转换的buffer/image信息数量，保证写入过程中vector不会重新分配，pBufferInfo/pImageInfo指针保持有效
+        size_t buffer_info_count = 0;
+        size_t image_info_count = 0;
+        for (uint32_t i = 0; i < descriptorWriteCount; ++i)
         {
-            if (vkCreateSemaphore(m_logical_device, &semaphoreInfo, nullptr, &m_image_available_for_render_semaphores[i]) != VK_SUCCESS ||
-                vkCreateSemaphore(m_logical_device, &semaphoreInfo, nullptr, &m_image_finished_for_presentation_semaphores[i]) != VK_SUCCESS ||
-                //vkCreateSemaphore(m_logical_device, &semaphoreInfo, nullptr, &(((VulkanSemaphore*)m_image_available_for_texturescopy_semaphores[i])->getResource())) != VK_SUCCESS ||
-                vkCreateFence(m_logical_device, &fenceInfo, nullptr, &m_is_frame_in_flight_fences[i]) != VK_SUCCESS) {
-                throw std::runtime_error("failed to create semaphores & fences!");
+            if (pDescriptorWrites[i].pBufferInfo != nullptr)
+            {
+                buffer_info_count += pDescriptorWrites[i].descriptorCount;
+            }
+            if (pDescriptorWrites[i].pImageInfo != nullptr)
+            {
+                image_info_count += pDescriptorWrites[i].descriptorCount;
             }
-            m_rhi_is_frame_in_flight_fences[i] = new VulkanFence();
-            ((VulkanFence*)m_rhi_is_frame_in_flight_fences[i])->setResource(m_is_frame_in_flight_fences[i]);
         }
-    }
 
-    // https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Rendering_and_presentation#page_Waiting-for-the-previous-frame
-    void VulkanRHI::waitForFences() {
-        // vkWaitForFences 函数接收一个围栏数组，并在主机上等待任何或所有围栏发出信号后返回。
-        // 传递的 VK_TRUE 表示我们要等待所有围栏
-        // 超时参数，我们将其设置为 64 位无符号整数 UINT64_MAX 的最大值，这样就有效地禁用了超时。
-        VkResult res_wait_for_fences = _vkWaitForFences(m_logical_device, 1, &m_is_frame_in_flight_fences[m_current_frame_index], VK_TRUE, UINT64_MAX);
-        if (VK_SUCCESS != res_wait_for_fences) {
-            throw std::runtime_error("failed to synchronize!");
-        }
-    }
+        std::vector<VkDescriptorBufferInfo> vk_buffer_info_list;
+        std::vector<VkDescriptorImageInfo> vk_image_info_list;
+        vk_buffer_info_list.reserve(buffer_info_count);
+        vk_image_info_list.reserve(image_info_count);
+        std::vector<VkWriteDescriptorSet> vk_write_list(descriptorWriteCount);
+        for (uint32_t i = 0; i < descriptorWriteCount; ++i)
+        {
+            const auto& rhi_write = pDescriptorWrites[i];
+            auto& vk_write = vk_write_list[i];
+            vk_write.sType = (VkStructureType)rhi_write.sType;
+            vk_write.pNext = (const void*)rhi_write.pNext;
+            vk_write.dstSet = ((VulkanDescriptorSet*)rhi_write.dstSet)->getResource();
+            vk_write.dstBinding = rhi_write.dstBinding;
+            vk_write.dstArrayElement = rhi_write.dstArrayElement;
+            vk_write.descriptorCount = rhi_write.descriptorCount;
+            vk_write.descriptorType = (VkDescriptorType)rhi_write.descriptorType;
+
+            if (rhi_write.pBufferInfo != nullptr)
+            {
+                vk_write.pBufferInfo = vk_buffer_info_list.data() + vk_buffer_info_list.size();
+                for (uint32_t j = 0; j < rhi_write.descriptorCount; ++j)
+                {
+                    const auto& rhi_buffer_info = rhi_write.pBufferInfo[j];
+                    vk_buffer_info_list.push_back({ ((VulkanBuffer*)rhi_buffer_info.buffer)->getResource(), rhi_buffer_info.offset, rhi_buffer_info.range });
+                }
+            }
+            if (rhi_write.pImageInfo != nullptr)
+            {
+                vk_write.pImageInfo = vk_image_info_list.data() + vk_image_info_list.size();
+                for (uint32_t j = 0; j < rhi_write.descriptorCount; ++j)
+                {
+                    const auto& rhi_image_info = rhi_write.pImageInfo[j];
+                    VkSampler vk_sampler = rhi_image_info.sampler != nullptr ? ((VulkanSampler*)rhi_image_info.sampler)->getResource() : VK_NULL_HANDLE;
+                    VkImageView vk_image_view = rhi_image_info.imageView != nullptr ? ((VulkanImageView*)rhi_image_info.imageView)->getResource() : VK_NULL_HANDLE;
+                    vk_image_info_list.push_back({ vk_sampler, vk_image_view, (VkImageLayout)rhi_image_info.imageLayout });
+                }
+            }
+        }
+
+        vkUpdateDescriptorSets(m_logical_device, descriptorWriteCount, vk_write_list.data(), 0, nullptr);
+    }
+
+    // semaphore : signal an image is ready for rendering // ready for presentation
+    // (m_vulkan_context._swapchain_images --> semaphores, frame timeline)
+    // https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Rendering_and_presentation#page_Creating-the-synchronization-objects
+    // 有两个地方可以方便地应用同步：交换链操作(二值semaphores)和等待之前的帧完成(帧时间线)。
+    void VulkanRHI::createSyncPrimitives() {
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        for (uint32_t i = 0; i < k_max_frames_in_flight; i++)
+        {
+            if (vkCreateSemaphore(m_logical_device, &semaphoreInfo, nullptr, &m_image_available_for_render_semaphores[i]) != VK_SUCCESS ||
+                vkCreateSemaphore(m_logical_device, &semaphoreInfo, nullptr, &m_image_finished_for_presentation_semaphores[i]) != VK_SUCCESS
+                //vkCreateSemaphore(m_logical_device, &semaphoreInfo, nullptr, &(((VulkanSemaphore*)m_image_available_for_texturescopy_semaphores[i])->getResource())) != VK_SUCCESS ||
+                ) {
+                throw std::runtime_error("failed to create semaphores!");
+            }
+        }
+
+        /*
+        fence需要以已signal的状态创建，否则第一帧的等待会永远阻塞；timeline semaphore不需要这个技巧：
+        初始值为0，每个帧槽位记录的值也从0开始，等待0会立即返回。
+        */
+        VkSemaphoreTypeCreateInfo semaphore_type_create_info{};
+        semaphore_type_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        semaphore_type_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        semaphore_type_create_info.initialValue = 0;
+        VkSemaphoreCreateInfo timeline_semaphore_create_info{};
+        timeline_semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        timeline_semaphore_create_info.pNext = &semaphore_type_create_info;
+        if (vkCreateSemaphore(m_logical_device, &timeline_semaphore_create_info, nullptr, &m_frame_timeline_semaphore) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create frame timeline semaphore!");
+        }
+        m_rhi_frame_timeline_semaphore = new VulkanSemaphore();
+        ((VulkanSemaphore*)m_rhi_frame_timeline_semaphore)->setResource(m_frame_timeline_semaphore);
+    }
+
+    // https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Rendering_and_presentation#page_Waiting-for-the-previous-frame
+    void VulkanRHI::waitForFrameInFlight() {
+        // 等待GPU的时间，GPU瓶颈时这一段会变长
+        MERCURY_PROFILE_SCOPE("VulkanRHI::waitForFrameInFlight");
+        waitForFrameTimelineValue(m_frame_slot_timeline_values[m_current_frame_index]);
+        // 这一帧槽位的计算command buffer也要等GPU用完才能重置
+        waitForAsyncComputeTimelineValue(m_frame_slot_async_compute_values[m_current_frame_index]);
+
+        // 顺便释放GPU已经不再使用的资源
+        const uint64_t completed_value = getCompletedFrameTimelineValue();
+        while (!m_deferred_releases.empty() && m_deferred_releases.front().timeline_value <= completed_value)
+        {
+            m_deferred_releases.front().release();
+            m_deferred_releases.pop_front();
+        }
+    }
+
+    uint64_t VulkanRHI::getCompletedFrameTimelineValue()
+    {
+        uint64_t value = 0;
+        if (VK_SUCCESS != _vkGetSemaphoreCounterValue(m_logical_device, m_frame_timeline_semaphore, &value))
+        {
+            throw std::runtime_error("vkGetSemaphoreCounterValue failed!");
+        }
+        return value;
+    }
+
+    // https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#vkWaitSemaphores
+    void VulkanRHI::waitForFrameTimelineValue(uint64_t value)
+    {
+        if (value == 0)
+        {
+            return;
+        }
+        // 超时参数设置为UINT64_MAX，等价于禁用超时
+        VkSemaphoreWaitInfo wait_info{};
+        wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        wait_info.semaphoreCount = 1;
+        wait_info.pSemaphores = &m_frame_timeline_semaphore;
+        wait_info.pValues = &value;
+        if (VK_SUCCESS != _vkWaitSemaphores(m_logical_device, &wait_info, UINT64_MAX))
+        {
+            throw std::runtime_error("failed to synchronize!");
+        }
+    }
+
+    uint64_t VulkanRHI::uploadBuffer(RHIBuffer* dst_buffer, RHIDeviceSize dst_offset, const void* data, RHIDeviceSize size)
+    {
+        return m_upload_manager.uploadBuffer(dst_buffer, dst_offset, data, size);
+    }
+
+    uint64_t VulkanRHI::uploadImage(RHIImage* dst_image, uint32_t width, uint32_t height, const void* data, RHIDeviceSize size, RHIImageLayout final_layout)
+    {
+        return m_upload_manager.uploadImage(dst_image, width, height, data, size, final_layout);
+    }
+
+    uint64_t VulkanRHI::getCompletedUploadTimelineValue()
+    {
+        return m_upload_manager.getCompletedValue();
+    }
+
+    void VulkanRHI::createAsyncComputeResources()
+    {
+        // 计算命令池属于计算队列族，在帧开始时整体重置
+        VkCommandPoolCreateInfo command_pool_create_info{};
+        command_pool_create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        command_pool_create_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        command_pool_create_info.queueFamilyIndex = m_queue_indices.m_compute_family.value();
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            if (vkCreateCommandPool(m_logical_device, &command_pool_create_info, nullptr, &m_async_compute_command_pools[i]) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create async compute command pool!");
+            }
+        }
+
+        VkSemaphoreTypeCreateInfo semaphore_type_create_info{};
+        semaphore_type_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        semaphore_type_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        semaphore_type_create_info.initialValue = 0;
+        VkSemaphoreCreateInfo semaphore_create_info{};
+        semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphore_create_info.pNext = &semaphore_type_create_info;
+        if (vkCreateSemaphore(m_logical_device, &semaphore_create_info, nullptr, &m_async_compute_timeline_semaphore) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create async compute timeline semaphore!");
+        }
+        m_rhi_async_compute_timeline_semaphore = new VulkanSemaphore();
+        ((VulkanSemaphore*)m_rhi_async_compute_timeline_semaphore)->setResource(m_async_compute_timeline_semaphore);
+
+        const bool is_dedicated = m_queue_indices.m_compute_family.value() != m_queue_indices.graphics_family.value();
+        std::cout << "create async compute resources success! dedicated compute queue: " << (is_dedicated ? "yes" : "no") << std::endl;
+    }
+
+    RHICommandBuffer* VulkanRHI::beginAsyncComputeCommandBuffer()
+    {
+        std::vector<RHICommandBuffer*>& command_buffers = m_async_compute_command_buffers[m_current_frame_index];
+        uint32_t& used_count = m_used_async_compute_command_buffer_counts[m_current_frame_index];
+        if (used_count == command_buffers.size())
+        {
+            VkCommandBufferAllocateInfo command_buffer_allocate_info{};
+            command_buffer_allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            command_buffer_allocate_info.commandPool = m_async_compute_command_pools[m_current_frame_index];
+            command_buffer_allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            command_buffer_allocate_info.commandBufferCount = 1U;
+
+            VkCommandBuffer vk_command_buffer;
+            if (vkAllocateCommandBuffers(m_logical_device, &command_buffer_allocate_info, &vk_command_buffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to allocate async compute command buffer!");
+                return nullptr;
+            }
+            RHICommandBuffer* command_buffer = new VulkanCommandBuffer();
+            ((VulkanCommandBuffer*)command_buffer)->setResource(vk_command_buffer);
+            command_buffers.push_back(command_buffer);
+        }
+        RHICommandBuffer* command_buffer = command_buffers[used_count++];
+
+        VkCommandBufferBeginInfo command_buffer_begin_info{};
+        command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        command_buffer_begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (VK_SUCCESS != _vkBeginCommandBuffer(((VulkanCommandBuffer*)command_buffer)->getResource(), &command_buffer_begin_info))
+        {
+            throw std::runtime_error("_vkBeginCommandBuffer failed!");
+            return nullptr;
+        }
+        return command_buffer;
+    }
+
+    uint64_t VulkanRHI::submitAsyncCompute(RHICommandBuffer* command_buffer, uint64_t wait_frame_timeline_value)
+    {
+        MERCURY_PROFILE_SCOPE("VulkanRHI::submitAsyncCompute");
+        VkCommandBuffer vk_command_buffer = ((VulkanCommandBuffer*)command_buffer)->getResource();
+        if (VK_SUCCESS != _vkEndCommandBuffer(vk_command_buffer))
+        {
+            throw std::runtime_error("_vkEndCommandBuffer failed!");
+            return 0;
+        }
+
+        const uint64_t signal_value = m_async_compute_timeline_value + 1;
+        VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+        VkTimelineSemaphoreSubmitInfo timeline_submit_info{};
+        timeline_submit_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timeline_submit_info.waitSemaphoreValueCount = wait_frame_timeline_value != 0 ? 1 : 0;
+        timeline_submit_info.pWaitSemaphoreValues = &wait_frame_timeline_value;
+        timeline_submit_info.signalSemaphoreValueCount = 1;
+        timeline_submit_info.pSignalSemaphoreValues = &signal_value;
+
+        VkSubmitInfo submit_info{};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.pNext = &timeline_submit_info;
+        submit_info.waitSemaphoreCount = wait_frame_timeline_value != 0 ? 1 : 0;
+        submit_info.pWaitSemaphores = &m_frame_timeline_semaphore;
+        submit_info.pWaitDstStageMask = &wait_stage;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &vk_command_buffer;
+        submit_info.signalSemaphoreCount = 1;
+        submit_info.pSignalSemaphores = &m_async_compute_timeline_semaphore;
+        if (VK_SUCCESS != vkQueueSubmit(((VulkanQueue*)m_compute_queue)->getResource(), 1, &submit_info, VK_NULL_HANDLE))
+        {
+            throw std::runtime_error("async compute vkQueueSubmit failed!");
+            return 0;
+        }
+
+        m_async_compute_timeline_value = signal_value;
+        m_frame_slot_async_compute_values[m_current_frame_index] = signal_value;
+        return signal_value;
+    }
+
+    void VulkanRHI::waitForAsyncComputeInGraphics(uint64_t value, RHIPipelineStageFlags wait_stage)
+    {
+        // 同一帧多次等待时合并：计算时间线是单调的，等待最大的值即可
+        m_graphics_async_compute_wait_value = std::max(m_graphics_async_compute_wait_value, value);
+        m_graphics_async_compute_wait_stages |= (VkPipelineStageFlags)wait_stage;
+    }
+
+    uint64_t VulkanRHI::getCompletedAsyncComputeTimelineValue()
+    {
+        uint64_t value = 0;
+        if (VK_SUCCESS != _vkGetSemaphoreCounterValue(m_logical_device, m_async_compute_timeline_semaphore, &value))
+        {
+            throw std::runtime_error("vkGetSemaphoreCounterValue failed!");
+        }
+        return value;
+    }
+
+    void VulkanRHI::waitForAsyncComputeTimelineValue(uint64_t value)
+    {
+        if (value == 0)
+        {
+            return;
+        }
+        VkSemaphoreWaitInfo wait_info{};
+        wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        wait_info.semaphoreCount = 1;
+        wait_info.pSemaphores = &m_async_compute_timeline_semaphore;
+        wait_info.pValues = &value;
+        if (VK_SUCCESS != _vkWaitSemaphores(m_logical_device, &wait_info, UINT64_MAX))
+        {
+            throw std::runtime_error("failed to synchronize async compute!");
+        }
+    }
+
+    void VulkanRHI::deferRelease(std::function<void()> release)
+    {
+        // 当前正在录制的帧会以m_frame_timeline_value + 1提交，之前录制的工作都不会晚于它完成
+        m_deferred_releases.push_back({ m_frame_timeline_value + 1, std::move(release) });
+    }
+
+    void VulkanRHI::waitDeviceIdle() {
+        VkResult res_device_wait_idle = vkDeviceWaitIdle(m_logical_device);
+        if (VK_SUCCESS != res_device_wait_idle) {
+            throw std::runtime_error("vkDeviceWaitIdle failed!");
+        }
+    }
 
     void VulkanRHI::resetCommandPool()
     {
@@ -1019,60 +1732,44 @@ namespace Mercury
         {
             throw std::runtime_error("failed to synchronize");
         }
-    }
 
-    void VulkanRHI::cmdBeginRenderPassPFN(RHICommandBuffer* commandBuffer, const RHIRenderPassBeginInfo* pRenderPassBegin, RHISubpassContents contents) {
-        VkOffset2D offset_2d{};
-        offset_2d.x = pRenderPassBegin->renderArea.offset.x;
-        offset_2d.y = pRenderPassBegin->renderArea.offset.y;
-
-        VkExtent2D extent_2d{};
-        extent_2d.width = pRenderPassBegin->renderArea.extent.width;
-        extent_2d.height = pRenderPassBegin->renderArea.extent.height;
-
-        VkRect2D rect_2d{};
-        rect_2d.offset = offset_2d;
-        rect_2d.extent = extent_2d;
-
-        //clear values：有可能包括深度、模板的数据
-        int clear_value_size = pRenderPassBegin->clearValueCount;
-        std::vector<VkClearValue> vk_clear_value_list(clear_value_size);
-        for (int i = 0; i < clear_value_size; ++i)
-        {
-            const auto& rhi_clear_value_element = pRenderPassBegin->pClearValues[i];
-            auto& vk_clear_value_element = vk_clear_value_list[i];
-
-            VkClearColorValue vk_clear_color_value;
-            vk_clear_color_value.float32[0] = rhi_clear_value_element.color.float32[0];
-            vk_clear_color_value.float32[1] = rhi_clear_value_element.color.float32[1];
-            vk_clear_color_value.float32[2] = rhi_clear_value_element.color.float32[2];
-            vk_clear_color_value.float32[3] = rhi_clear_value_element.color.float32[3];
-            vk_clear_color_value.int32[0] = rhi_clear_value_element.color.int32[0];
-            vk_clear_color_value.int32[1] = rhi_clear_value_element.color.int32[1];
-            vk_clear_color_value.int32[2] = rhi_clear_value_element.color.int32[2];
-            vk_clear_color_value.int32[3] = rhi_clear_value_element.color.int32[3];
-            vk_clear_color_value.uint32[0] = rhi_clear_value_element.color.uint32[0];
-            vk_clear_color_value.uint32[1] = rhi_clear_value_element.color.uint32[1];
-            vk_clear_color_value.uint32[2] = rhi_clear_value_element.color.uint32[2];
-            vk_clear_color_value.uint32[3] = rhi_clear_value_element.color.uint32[3];
-
-            VkClearDepthStencilValue vk_clear_depth_stencil_value;
-            vk_clear_depth_stencil_value.depth = rhi_clear_value_element.depthStencil.depth;
-            vk_clear_depth_stencil_value.stencil = rhi_clear_value_element.depthStencil.stencil;
-
-            vk_clear_value_element.color = vk_clear_color_value;
-            vk_clear_value_element.depthStencil = vk_clear_depth_stencil_value;
+        // 重置pool会把其中分配的所有command buffer恢复到initial状态，secondary command buffer对象保留下来在这一帧重新分配
+        for (WorkerCommandPool& worker_command_pool : m_worker_command_pools[m_current_frame_index])
+        {
+            if (worker_command_pool.used_secondary_count == 0)
+            {
+                continue;
+            }
+            if (VK_SUCCESS != _vkResetCommandPool(m_logical_device, worker_command_pool.command_pool, 0))
+            {
+                throw std::runtime_error("failed to reset worker command pool");
+            }
+            worker_command_pool.used_secondary_count = 0;
+        }
 
-        };
+        if (m_used_async_compute_command_buffer_counts[m_current_frame_index] != 0)
+        {
+            if (VK_SUCCESS != _vkResetCommandPool(m_logical_device, m_async_compute_command_pools[m_current_frame_index], 0))
+            {
+                throw std::runtime_error("failed to reset async compute command pool");
+            }
+            m_used_async_compute_command_buffer_counts[m_current_frame_index] = 0;
+        }
+
+        // 这一帧槽位分配的描述符set随池整体回收
+        m_descriptor_allocator.resetFrame(m_current_frame_index);
+    }
 
+    void VulkanRHI::cmdBeginRenderPassPFN(RHICommandBuffer* commandBuffer, const RHIRenderPassBeginInfo* pRenderPassBegin, RHISubpassContents contents) {
         VkRenderPassBeginInfo vk_render_pass_begin_info{};
         vk_render_pass_begin_info.sType = (VkStructureType)pRenderPassBegin->sType;
         vk_render_pass_begin_info.pNext = pRenderPassBegin->pNext;
         vk_render_pass_begin_info.renderPass = ((VulkanRenderPass*)pRenderPassBegin->renderPass)->getResource();
         vk_render_pass_begin_info.framebuffer = ((VulkanFramebuffer*)pRenderPassBegin->framebuffer)->getResource();
-        vk_render_pass_begin_info.renderArea = rect_2d;
+        vk_render_pass_begin_info.renderArea = *reinterpret_cast<const VkRect2D*>(&pRenderPassBegin->renderArea);
+        //clear values：有可能包括深度、模板的数据，RHIClearValue与VkClearValue布局一致
         vk_render_pass_begin_info.clearValueCount = pRenderPassBegin->clearValueCount;
-        vk_render_pass_begin_info.pClearValues = vk_clear_value_list.data();
+        vk_render_pass_begin_info.pClearValues = reinterpret_cast<const VkClearValue*>(pRenderPassBegin->pClearValues);
 
         return _vkCmdBeginRenderPass(((VulkanCommandBuffer*)commandBuffer)->getResource(), &vk_render_pass_begin_info, (VkSubpassContents)contents);
     }
@@ -1085,59 +1782,710 @@ namespace Mercury
         return _vkCmdEndRenderPass(((VulkanCommandBuffer*)commandBuffer)->getResource());
     }
 
+    void VulkanRHI::cmdBindVertexBuffersPFN(RHICommandBuffer* commandBuffer, uint32_t firstBinding, uint32_t bindingCount, RHIBuffer* const* pBuffers, const RHIDeviceSize* pOffsets) {
+        // 一次绑定的vertex buffer数量不会超过设备的maxVertexInputBindings（通常为16或32）
+        static constexpr uint32_t k_max_vertex_buffer_binding_count = 32;
+        if (bindingCount > k_max_vertex_buffer_binding_count)
+        {
+            throw std::runtime_error("too many vertex buffer bindings!");
+            return;
+        }
+        VkBuffer vk_buffer_list[k_max_vertex_buffer_binding_count];
+        for (uint32_t i = 0; i < bindingCount; ++i)
+        {
+            vk_buffer_list[i] = ((VulkanBuffer*)pBuffers[i])->getResource();
+        }
+        return _vkCmdBindVertexBuffers(((VulkanCommandBuffer*)commandBuffer)->getResource(), firstBinding, bindingCount, vk_buffer_list, reinterpret_cast<const VkDeviceSize*>(pOffsets));
+    }
+
+    void VulkanRHI::cmdBindIndexBufferPFN(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, RHIIndexType indexType) {
+        return _vkCmdBindIndexBuffer(((VulkanCommandBuffer*)commandBuffer)->getResource(), ((VulkanBuffer*)buffer)->getResource(), (VkDeviceSize)offset, (VkIndexType)indexType);
+    }
+
+    void VulkanRHI::cmdBindDescriptorSetsPFN(RHICommandBuffer* commandBuffer, RHIPipelineBindPoint pipelineBindPoint, RHIPipelineLayout* layout, uint32_t firstSet, uint32_t descriptorSetCount, RHIDescriptorSet* const* pDescriptorSets, uint32_t dynamicOffsetCount, const uint32_t* pDynamicOffsets) {
+        // 一次绑定的set数量不会超过设备的maxBoundDescriptorSets（规范要求至少4，常见实现为8到32）
+        static constexpr uint32_t k_max_bound_descriptor_set_count = 32;
+        if (descriptorSetCount > k_max_bound_descriptor_set_count)
+        {
+            throw std::runtime_error("too many descriptor sets bound at once!");
+            return;
+        }
+        VkDescriptorSet vk_descriptor_set_list[k_max_bound_descriptor_set_count];
+        for (uint32_t i = 0; i < descriptorSetCount; ++i)
+        {
+            vk_descriptor_set_list[i] = ((VulkanDescriptorSet*)pDescriptorSets[i])->getResource();
+        }
+        return _vkCmdBindDescriptorSets(((VulkanCommandBuffer*)commandBuffer)->getResource(), (VkPipelineBindPoint)pipelineBindPoint, ((VulkanPipelineLayout*)layout)->getResource(), firstSet, descriptorSetCount, vk_descriptor_set_list, dynamicOffsetCount, pDynamicOffsets);
+    }
+
+    void VulkanRHI::cmdPushConstants(RHICommandBuffer* commandBuffer, RHIPipelineLayout* layout, RHIShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* pValues) {
+        vkCmdPushConstants(((VulkanCommandBuffer*)commandBuffer)->getResource(), ((VulkanPipelineLayout*)layout)->getResource(), (VkShaderStageFlags)stageFlags, offset, size, pValues);
+    }
+
     void VulkanRHI::cmdDraw(RHICommandBuffer* commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) {
         vkCmdDraw(((VulkanCommandBuffer*)commandBuffer)->getResource(), vertexCount, instanceCount, firstVertex, firstInstance);
     }
 
+    void VulkanRHI::cmdDrawIndexed(RHICommandBuffer* commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance) {
+        return _vkCmdDrawIndexed(((VulkanCommandBuffer*)commandBuffer)->getResource(), indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+    }
+
+    void VulkanRHI::cmdDispatch(RHICommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
+        vkCmdDispatch(((VulkanCommandBuffer*)commandBuffer)->getResource(), groupCountX, groupCountY, groupCountZ);
+    }
+
+    // buffer中offset处是VkDispatchIndirectCommand（三个uint32_t），可以由之前的计算着色器写入，例如GPU剔除后的工作组数量
+    void VulkanRHI::cmdDispatchIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset) {
+        vkCmdDispatchIndirect(((VulkanCommandBuffer*)commandBuffer)->getResource(), ((VulkanBuffer*)buffer)->getResource(), offset);
+    }
+
+    // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkCmdPipelineBarrier.html
+    void VulkanRHI::cmdPipelineBarrier(RHICommandBuffer* commandBuffer,
+        RHIPipelineStageFlags srcStageMask,
+        RHIPipelineStageFlags dstStageMask,
+        RHIDependencyFlags dependencyFlags,
+        uint32_t memoryBarrierCount,
+        const RHIMemoryBarrier* pMemoryBarriers,
+        uint32_t bufferMemoryBarrierCount,
+        const RHIBufferMemoryBarrier* pBufferMemoryBarriers,
+        uint32_t imageMemoryBarrierCount,
+        const RHIImageMemoryBarrier* pImageMemoryBarriers)
+    {
+        // 一次barrier中的buffer/image数量通常很少，放在栈上转换，超出时才退回到堆分配
+        static constexpr uint32_t k_inline_barrier_count = 16;
+
+        VkBufferMemoryBarrier vk_buffer_barrier_inline[k_inline_barrier_count];
+        std::vector<VkBufferMemoryBarrier> vk_buffer_barrier_heap;
+        VkBufferMemoryBarrier* vk_buffer_barrier_list = vk_buffer_barrier_inline;
+        if (bufferMemoryBarrierCount > k_inline_barrier_count)
+        {
+            vk_buffer_barrier_heap.resize(bufferMemoryBarrierCount);
+            vk_buffer_barrier_list = vk_buffer_barrier_heap.data();
+        }
+        for (uint32_t i = 0; i < bufferMemoryBarrierCount; ++i)
+        {
+            const auto& rhi_buffer_barrier_element = pBufferMemoryBarriers[i];
+            auto& vk_buffer_barrier_element = vk_buffer_barrier_list[i];
+
+            vk_buffer_barrier_element.sType = (VkStructureType)rhi_buffer_barrier_element.sType;
+            vk_buffer_barrier_element.pNext = rhi_buffer_barrier_element.pNext;
+            vk_buffer_barrier_element.srcAccessMask = (VkAccessFlags)rhi_buffer_barrier_element.srcAccessMask;
+            vk_buffer_barrier_element.dstAccessMask = (VkAccessFlags)rhi_buffer_barrier_element.dstAccessMask;
+            vk_buffer_barrier_element.srcQueueFamilyIndex = rhi_buffer_barrier_element.srcQueueFamilyIndex;
+            vk_buffer_barrier_element.dstQueueFamilyIndex = rhi_buffer_barrier_element.dstQueueFamilyIndex;
+            vk_buffer_barrier_element.buffer = ((VulkanBuffer*)rhi_buffer_barrier_element.buffer)->getResource();
+            vk_buffer_barrier_element.offset = rhi_buffer_barrier_element.offset;
+            vk_buffer_barrier_element.size = rhi_buffer_barrier_element.size;
+        }
+
+        VkImageMemoryBarrier vk_image_barrier_inline[k_inline_barrier_count];
+        std::vector<VkImageMemoryBarrier> vk_image_barrier_heap;
+        VkImageMemoryBarrier* vk_image_barrier_list = vk_image_barrier_inline;
+        if (imageMemoryBarrierCount > k_inline_barrier_count)
+        {
+            vk_image_barrier_heap.resize(imageMemoryBarrierCount);
+            vk_image_barrier_list = vk_image_barrier_heap.data();
+        }
+        for (uint32_t i = 0; i < imageMemoryBarrierCount; ++i)
+        {
+            const auto& rhi_image_barrier_element = pImageMemoryBarriers[i];
+            auto& vk_image_barrier_element = vk_image_barrier_list[i];
+
+            vk_image_barrier_element.sType = (VkStructureType)rhi_image_barrier_element.sType;
+            vk_image_barrier_element.pNext = rhi_image_barrier_element.pNext;
+            vk_image_barrier_element.srcAccessMask = (VkAccessFlags)rhi_image_barrier_element.srcAccessMask;
+            vk_image_barrier_element.dstAccessMask = (VkAccessFlags)rhi_image_barrier_element.dstAccessMask;
+            vk_image_barrier_element.oldLayout = (VkImageLayout)rhi_image_barrier_element.oldLayout;
+            vk_image_barrier_element.newLayout = (VkImageLayout)rhi_image_barrier_element.newLayout;
+            vk_image_barrier_element.srcQueueFamilyIndex = rhi_image_barrier_element.srcQueueFamilyIndex;
+            vk_image_barrier_element.dstQueueFamilyIndex = rhi_image_barrier_element.dstQueueFamilyIndex;
+            vk_image_barrier_element.image = ((VulkanImage*)rhi_image_barrier_element.image)->getResource();
+            vk_image_barrier_element.subresourceRange.aspectMask = (VkImageAspectFlags)rhi_image_barrier_element.subresourceRange.aspectMask;
+            vk_image_barrier_element.subresourceRange.baseMipLevel = rhi_image_barrier_element.subresourceRange.baseMipLevel;
+            vk_image_barrier_element.subresourceRange.levelCount = rhi_image_barrier_element.subresourceRange.levelCount;
+            vk_image_barrier_element.subresourceRange.baseArrayLayer = rhi_image_barrier_element.subresourceRange.baseArrayLayer;
+            vk_image_barrier_element.subresourceRange.layerCount = rhi_image_barrier_element.subresourceRange.layerCount;
+        }
+
+        vkCmdPipelineBarrier(((VulkanCommandBuffer*)commandBuffer)->getResource(),
+            (VkPipelineStageFlags)srcStageMask,
+            (VkPipelineStageFlags)dstStageMask,
+            (VkDependencyFlags)dependencyFlags,
+            memoryBarrierCount,
+            reinterpret_cast<const VkMemoryBarrier*>(pMemoryBarriers),
+            bufferMemoryBarrierCount,
+            vk_buffer_barrier_list,
+            imageMemoryBarrierCount,
+            vk_image_barrier_list);
+    }
+
 
+    // https://gpuopen-librariesandsdks.github.io/VulkanMemoryAllocator/html/quick_start.html
+    // VMA从较大的VkDeviceMemory块中子分配资源，驱动分配次数不再随资源数量增长（受maxMemoryAllocationCount限制）
     void VulkanRHI::createAssetAllocator()
     {
+        VmaVulkanFunctions vulkan_functions{};
+        vulkan_functions.vkGetInstanceProcAddr = &vkGetInstanceProcAddr;
+        vulkan_functions.vkGetDeviceProcAddr = &vkGetDeviceProcAddr;
+
+        VmaAllocatorCreateInfo allocator_create_info{};
+        allocator_create_info.vulkanApiVersion = m_vulkan_api_version;
+        allocator_create_info.physicalDevice = m_physical_device;
+        allocator_create_info.device = m_logical_device;
+        allocator_create_info.instance = m_instance;
+        allocator_create_info.pVulkanFunctions = &vulkan_functions;
+        if (m_enable_memory_budget)
+        {
+            allocator_create_info.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+        }
+
+        if (vmaCreateAllocator(&allocator_create_info, &m_assets_allocator) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create asset allocator!");
+        }
+
+        std::cout << "create asset allocator success!" << std::endl;
+    }
+
+    // 写在pipeline cache数据之前的文件头。驱动自带的header不包含驱动版本，驱动升级后旧数据虽然会被驱动拒绝，
+    // 但先在这里校验可以避免把无效数据交给驱动
+    struct PipelineCacheFileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vendor_id;
+        uint32_t device_id;
+        uint32_t driver_version;
+        uint8_t  pipeline_cache_uuid[VK_UUID_SIZE];
+        uint64_t data_size;
+    };
+    static constexpr uint32_t k_pipeline_cache_file_magic = 0x4D504343; // "MPCC"
+    static constexpr uint32_t k_pipeline_cache_file_version = 1;
+
+    static PipelineCacheFileHeader makePipelineCacheFileHeader(const VkPhysicalDeviceProperties& properties, uint64_t data_size)
+    {
+        PipelineCacheFileHeader header{};
+        header.magic = k_pipeline_cache_file_magic;
+        header.version = k_pipeline_cache_file_version;
+        header.vendor_id = properties.vendorID;
+        header.device_id = properties.deviceID;
+        header.driver_version = properties.driverVersion;
+        memcpy(header.pipeline_cache_uuid, properties.pipelineCacheUUID, VK_UUID_SIZE);
+        header.data_size = data_size;
+        return header;
+    }
+
+    // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkPipelineCache.html
+    void VulkanRHI::createPipelineCache()
+    {
+        std::vector<char> initial_data;
+        if (!m_pipeline_cache_path.empty())
+        {
+            std::ifstream file(m_pipeline_cache_path, std::ios::binary | std::ios::ate);
+            if (file.is_open())
+            {
+                std::streamsize file_size = file.tellg();
+                file.seekg(0);
+
+                PipelineCacheFileHeader header{};
+                PipelineCacheFileHeader expected_header = makePipelineCacheFileHeader(m_physical_device_properties, 0);
+                if (file_size >= static_cast<std::streamsize>(sizeof(header)) && file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+                    header.magic == expected_header.magic &&
+                    header.version == expected_header.version &&
+                    header.vendor_id == expected_header.vendor_id &&
+                    header.device_id == expected_header.device_id &&
+                    header.driver_version == expected_header.driver_version &&
+                    memcmp(header.pipeline_cache_uuid, expected_header.pipeline_cache_uuid, VK_UUID_SIZE) == 0 &&
+                    header.data_size == static_cast<uint64_t>(file_size) - sizeof(header))
+                {
+                    initial_data.resize(header.data_size);
+                    if (!file.read(initial_data.data(), initial_data.size()))
+                    {
+                        initial_data.clear();
+                    }
+                }
+
+                if (initial_data.empty())
+                {
+                    std::cout << "pipeline cache on disk is stale or corrupted, ignored" << std::endl;
+                }
+            }
+        }
+
+        VkPipelineCacheCreateInfo pipeline_cache_create_info{};
+        pipeline_cache_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        pipeline_cache_create_info.initialDataSize = initial_data.size();
+        pipeline_cache_create_info.pInitialData = initial_data.empty() ? nullptr : initial_data.data();
+
+        VkPipelineCache vk_pipeline_cache;
+        VkResult result = vkCreatePipelineCache(m_logical_device, &pipeline_cache_create_info, nullptr, &vk_pipeline_cache);
+        if (result != VK_SUCCESS && !initial_data.empty())
+        {
+            // 驱动拒绝了旧数据，退回到空的cache
+            pipeline_cache_create_info.initialDataSize = 0;
+            pipeline_cache_create_info.pInitialData = nullptr;
+            result = vkCreatePipelineCache(m_logical_device, &pipeline_cache_create_info, nullptr, &vk_pipeline_cache);
+        }
+        if (result != VK_SUCCESS)
+        {
+            throw std::runtime_error("vkCreatePipelineCache failed!");
+        }
+
+        m_pipeline_cache = new VulkanPipelineCache();
+        ((VulkanPipelineCache*)m_pipeline_cache)->setResource(vk_pipeline_cache);
+
+        std::cout << "createPipelineCache success! (" << initial_data.size() << " bytes loaded)" << std::endl;
+    }
+
+    bool VulkanRHI::savePipelineCache()
+    {
+        if (m_pipeline_cache == nullptr || m_pipeline_cache_path.empty())
+        {
+            return false;
+        }
+
+        VkPipelineCache vk_pipeline_cache = ((VulkanPipelineCache*)m_pipeline_cache)->getResource();
+        size_t data_size = 0;
+        if (vkGetPipelineCacheData(m_logical_device, vk_pipeline_cache, &data_size, nullptr) != VK_SUCCESS)
+        {
+            return false;
+        }
+        std::vector<char> data(data_size);
+        if (vkGetPipelineCacheData(m_logical_device, vk_pipeline_cache, &data_size, data.data()) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        // 先写临时文件再替换，避免写到一半退出留下损坏的cache
+        std::filesystem::path temp_path = m_pipeline_cache_path;
+        temp_path += ".tmp";
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                return false;
+            }
+            PipelineCacheFileHeader header = makePipelineCacheFileHeader(m_physical_device_properties, data_size);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(data.data(), data_size);
+            if (!file)
+            {
+                return false;
+            }
+        }
+
+        std::error_code error_code;
+        std::filesystem::rename(temp_path, m_pipeline_cache_path, error_code);
+        if (error_code)
+        {
+            return false;
+        }
+
+        std::cout << "savePipelineCache success! (" << data_size << " bytes)" << std::endl;
+        return RHI_SUCCESS;
+    }
+
+    static VmaAllocationCreateInfo toVmaAllocationCreateInfo(const RHIAllocationCreateInfo* pAllocationCreateInfo)
+    {
+        VmaAllocationCreateInfo vma_allocation_create_info{};
+        vma_allocation_create_info.flags = (VmaAllocationCreateFlags)pAllocationCreateInfo->flags;
+        vma_allocation_create_info.usage = (VmaMemoryUsage)pAllocationCreateInfo->usage;
+        vma_allocation_create_info.requiredFlags = (VkMemoryPropertyFlags)pAllocationCreateInfo->requiredFlags;
+        vma_allocation_create_info.preferredFlags = (VkMemoryPropertyFlags)pAllocationCreateInfo->preferredFlags;
+        return vma_allocation_create_info;
+    }
+
+    static void toRHIAllocationInfo(const VmaAllocationInfo& vma_allocation_info, RHIAllocationInfo* pAllocationInfo)
+    {
+        if (pAllocationInfo != nullptr)
+        {
+            pAllocationInfo->memoryType = vma_allocation_info.memoryType;
+            pAllocationInfo->offset = vma_allocation_info.offset;
+            pAllocationInfo->size = vma_allocation_info.size;
+            pAllocationInfo->pMappedData = vma_allocation_info.pMappedData;
+        }
+    }
+
+    bool VulkanRHI::createBuffer(const RHIBufferCreateInfo* pCreateInfo,
+        const RHIAllocationCreateInfo* pAllocationCreateInfo,
+        RHIBuffer*& pBuffer,
+        RHIAllocation*& pAllocation,
+        RHIAllocationInfo* pAllocationInfo)
+    {
+        VkBufferCreateInfo create_info{};
+        create_info.sType = (VkStructureType)pCreateInfo->sType;
+        create_info.pNext = (const void*)pCreateInfo->pNext;
+        create_info.flags = (VkBufferCreateFlags)pCreateInfo->flags;
+        create_info.size = (VkDeviceSize)pCreateInfo->size;
+        create_info.usage = (VkBufferUsageFlags)pCreateInfo->usage;
+        create_info.sharingMode = (VkSharingMode)pCreateInfo->sharingMode;
+        create_info.queueFamilyIndexCount = pCreateInfo->queueFamilyIndexCount;
+        create_info.pQueueFamilyIndices = pCreateInfo->pQueueFamilyIndices;
+
+        VmaAllocationCreateInfo vma_allocation_create_info = toVmaAllocationCreateInfo(pAllocationCreateInfo);
+
+        VkBuffer vk_buffer;
+        VmaAllocation vma_allocation;
+        VmaAllocationInfo vma_allocation_info;
+        VkResult result = vmaCreateBuffer(m_assets_allocator, &create_info, &vma_allocation_create_info, &vk_buffer, &vma_allocation, &vma_allocation_info);
+        if (result != VK_SUCCESS)
+        {
+            throw std::runtime_error("vmaCreateBuffer failed!");
+            return false;
+        }
+
+        pBuffer = new VulkanBuffer();
+        ((VulkanBuffer*)pBuffer)->setResource(vk_buffer);
+        pAllocation = new VulkanAllocation();
+        ((VulkanAllocation*)pAllocation)->setResource(vma_allocation);
+        toRHIAllocationInfo(vma_allocation_info, pAllocationInfo);
+        return RHI_SUCCESS;
+    }
+
+    bool VulkanRHI::createImage(const RHIImageCreateInfo* pCreateInfo,
+        const RHIAllocationCreateInfo* pAllocationCreateInfo,
+        RHIImage*& pImage,
+        RHIAllocation*& pAllocation,
+        RHIAllocationInfo* pAllocationInfo)
+    {
+        VkImageCreateInfo create_info{};
+        create_info.sType = (VkStructureType)pCreateInfo->sType;
+        create_info.pNext = (const void*)pCreateInfo->pNext;
+        create_info.flags = (VkImageCreateFlags)pCreateInfo->flags;
+        create_info.imageType = (VkImageType)pCreateInfo->imageType;
+        create_info.format = (VkFormat)pCreateInfo->format;
+        create_info.extent.width = pCreateInfo->extent.width;
+        create_info.extent.height = pCreateInfo->extent.height;
+        create_info.extent.depth = pCreateInfo->extent.depth;
+        create_info.mipLevels = pCreateInfo->mipLevels;
+        create_info.arrayLayers = pCreateInfo->arrayLayers;
+        create_info.samples = (VkSampleCountFlagBits)pCreateInfo->samples;
+        create_info.tiling = (VkImageTiling)pCreateInfo->tiling;
+        create_info.usage = (VkImageUsageFlags)pCreateInfo->usage;
+        create_info.sharingMode = (VkSharingMode)pCreateInfo->sharingMode;
+        create_info.queueFamilyIndexCount = pCreateInfo->queueFamilyIndexCount;
+        create_info.pQueueFamilyIndices = pCreateInfo->pQueueFamilyIndices;
+        create_info.initialLayout = (VkImageLayout)pCreateInfo->initialLayout;
+
+        VmaAllocationCreateInfo vma_allocation_create_info = toVmaAllocationCreateInfo(pAllocationCreateInfo);
+
+        VkImage vk_image;
+        VmaAllocation vma_allocation;
+        VmaAllocationInfo vma_allocation_info;
+        VkResult result = vmaCreateImage(m_assets_allocator, &create_info, &vma_allocation_create_info, &vk_image, &vma_allocation, &vma_allocation_info);
+        if (result != VK_SUCCESS)
+        {
+            throw std::runtime_error("vmaCreateImage failed!");
+            return false;
+        }
+
+        pImage = new VulkanImage();
+        ((VulkanImage*)pImage)->setResource(vk_image);
+        pAllocation = new VulkanAllocation();
+        ((VulkanAllocation*)pAllocation)->setResource(vma_allocation);
+        toRHIAllocationInfo(vma_allocation_info, pAllocationInfo);
+        return RHI_SUCCESS;
+    }
+
+    bool VulkanRHI::createImageView(RHIImage* image, RHIFormat format, RHIImageAspectFlags image_aspect_flags, RHIImageViewType view_type, uint32_t layout_count, uint32_t miplevels, RHIImageView*& image_view)
+    {
+        VkImageView vk_image_view = VulkanUtil::createImageView(m_logical_device,
+            ((VulkanImage*)image)->getResource(),
+            (VkFormat)format,
+            (VkImageAspectFlags)image_aspect_flags,
+            (VkImageViewType)view_type,
+            layout_count,
+            miplevels);
+        if (vk_image_view == VK_NULL_HANDLE)
+        {
+            throw std::runtime_error("createImageView failed!");
+            return false;
+        }
+
+        image_view = new VulkanImageView();
+        ((VulkanImageView*)image_view)->setResource(vk_image_view);
+        return RHI_SUCCESS;
+    }
+
+    bool VulkanRHI::mapMemory(RHIAllocation* allocation, void** ppData)
+    {
+        VkResult result = vmaMapMemory(m_assets_allocator, ((VulkanAllocation*)allocation)->getResource(), ppData);
+        if (result != VK_SUCCESS)
+        {
+            throw std::runtime_error("vmaMapMemory failed!");
+            return false;
+        }
+        return RHI_SUCCESS;
+    }
+
+    void VulkanRHI::unmapMemory(RHIAllocation* allocation)
+    {
+        vmaUnmapMemory(m_assets_allocator, ((VulkanAllocation*)allocation)->getResource());
+    }
+
+    // 对非HOST_COHERENT的内存，CPU写入后需要flush才能保证GPU可见；coherent内存上VMA会直接跳过
+    void VulkanRHI::flushAllocation(RHIAllocation* allocation, RHIDeviceSize offset, RHIDeviceSize size)
+    {
+        vmaFlushAllocation(m_assets_allocator, ((VulkanAllocation*)allocation)->getResource(), offset, size);
+    }
+
+    bool VulkanRHI::readbackPresentedImage(std::vector<uint8_t>& pixels)
+    {
+        if (!m_is_headless)
+        {
+            // swapchain图像没有TRANSFER_SRC用法，并且present之后不再归应用所有
+            throw std::runtime_error("readbackPresentedImage is only supported in headless mode");
+            return false;
+        }
+
+        const RHIDeviceSize image_size = (RHIDeviceSize)m_swapchain_extend.width * m_swapchain_extend.height * 4;
+        if (m_readback_buffer_size < image_size)
+        {
+            if (m_readback_buffer != nullptr)
+            {
+                destroyBuffer(m_readback_buffer, m_readback_allocation);
+            }
+
+            RHIBufferCreateInfo buffer_create_info{};
+            buffer_create_info.sType = RHI_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            buffer_create_info.size = image_size;
+            buffer_create_info.usage = RHI_BUFFER_USAGE_TRANSFER_DST_BIT;
+            buffer_create_info.sharingMode = RHI_SHARING_MODE_EXCLUSIVE;
+
+            // CPU随机读取，优先使用带缓存的内存
+            RHIAllocationCreateInfo allocation_create_info{};
+            allocation_create_info.flags = RHI_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+            allocation_create_info.usage = RHI_MEMORY_USAGE_AUTO;
+            allocation_create_info.requiredFlags = RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+            createBuffer(&buffer_create_info, &allocation_create_info, m_readback_buffer, m_readback_allocation, nullptr);
+            m_readback_buffer_size = image_size;
+        }
+
+        VkCommandBufferAllocateInfo command_buffer_allocate_info{};
+        command_buffer_allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        command_buffer_allocate_info.commandPool = ((VulkanCommandPool*)m_rhi_command_pool)->getResource();
+        command_buffer_allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        command_buffer_allocate_info.commandBufferCount = 1;
+
+        VkCommandBuffer command_buffer;
+        if (vkAllocateCommandBuffers(m_logical_device, &command_buffer_allocate_info, &command_buffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate readback command buffer!");
+            return false;
+        }
+
+        VkCommandBufferBeginInfo command_buffer_begin_info{};
+        command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        command_buffer_begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        _vkBeginCommandBuffer(command_buffer, &command_buffer_begin_info);
+
+        // render graph在帧末已把图像转换到TRANSFER_SRC_OPTIMAL，同一队列上按提交顺序执行，这里不需要再等待那一帧的时间线
+        VkBufferImageCopy region{};
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = { m_swapchain_extend.width, m_swapchain_extend.height, 1 };
+        vkCmdCopyImageToBuffer(command_buffer,
+            m_swapchain_images[m_current_swapchain_image_index],
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            ((VulkanBuffer*)m_readback_buffer)->getResource(),
+            1,
+            &region);
+
+        // 拷贝结果对CPU读取可见
+        VkMemoryBarrier memory_barrier{};
+        memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memory_barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+
+        _vkEndCommandBuffer(command_buffer);
+
+        VkSubmitInfo submit_info{};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &command_buffer;
+        VkQueue vk_graphics_queue = ((VulkanQueue*)m_graphics_queue)->getResource();
+        if (vkQueueSubmit(vk_graphics_queue, 1, &submit_info, VK_NULL_HANDLE) != VK_SUCCESS)
+        {
+            throw std::runtime_error("vkQueueSubmit failed!");
+            return false;
+        }
+        vkQueueWaitIdle(vk_graphics_queue);
+        vkFreeCommandBuffers(m_logical_device, ((VulkanCommandPool*)m_rhi_command_pool)->getResource(), 1, &command_buffer);
+
+        void* data = nullptr;
+        mapMemory(m_readback_allocation, &data);
+        pixels.resize(image_size);
+        memcpy(pixels.data(), data, image_size);
+        unmapMemory(m_readback_allocation);
+        return RHI_SUCCESS;
+    }
+
+    RHIShader* VulkanRHI::createShaderModule(const std::vector<unsigned char>& shader_code)
+    {
+        RHIShader* shahder = new VulkanShader();
+
+        VkShaderModule vk_shader = VulkanUtil::createShaderModule(m_logical_device, shader_code);
+
+        ((VulkanShader*)shahder)->setResource(vk_shader);
+        ((VulkanShader*)shahder)->setKey(std::string(shader_code.begin(), shader_code.end()));
+
+        return shahder;
     }
 
-    RHIShader* VulkanRHI::createShaderModule(const std::vector<unsigned char>& shader_code)
+    // https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#descriptorsets-setlayout
+    bool VulkanRHI::createDescriptorSetLayout(const RHIDescriptorSetLayoutCreateInfo* pCreateInfo, RHIDescriptorSetLayout*& pSetLayout)
     {
-        RHIShader* shahder = new VulkanShader();
+        std::string key;
+        appendDescriptorSetLayoutKey(key, pCreateInfo);
+        std::lock_guard<std::mutex> lock(m_layout_cache_mutex);
+        auto iter = m_descriptor_set_layout_cache.find(key);
+        if (iter != m_descriptor_set_layout_cache.end())
+        {
+            pSetLayout = iter->second;
+            return RHI_SUCCESS;
+        }
 
-        VkShaderModule vk_shader = VulkanUtil::createShaderModule(m_logical_device, shader_code);
+        // 先统计immutable sampler的数量，保证写入过程中vector不会重新分配，pImmutableSamplers指针保持有效
+        size_t immutable_sampler_count = 0;
+        for (uint32_t i = 0; i < pCreateInfo->bindingCount; ++i)
+        {
+            if (pCreateInfo->pBindings[i].pImmutableSamplers != nullptr)
+            {
+                immutable_sampler_count += pCreateInfo->pBindings[i].descriptorCount;
+            }
+        }
+        std::vector<VkSampler> vk_immutable_sampler_list;
+        vk_immutable_sampler_list.reserve(immutable_sampler_count);
 
-        ((VulkanShader*)shahder)->setResource(vk_shader);
+        std::vector<VkDescriptorSetLayoutBinding> vk_descriptor_set_layout_binding_list(pCreateInfo->bindingCount);
+        for (uint32_t i = 0; i < pCreateInfo->bindingCount; ++i)
+        {
+            const auto& rhi_binding = pCreateInfo->pBindings[i];
+            auto& vk_binding = vk_descriptor_set_layout_binding_list[i];
+            vk_binding.binding = rhi_binding.binding;
+            vk_binding.descriptorType = (VkDescriptorType)rhi_binding.descriptorType;
+            vk_binding.descriptorCount = rhi_binding.descriptorCount;
+            vk_binding.stageFlags = (VkShaderStageFlags)rhi_binding.stageFlags;
+            vk_binding.pImmutableSamplers = nullptr;
+            if (rhi_binding.pImmutableSamplers != nullptr)
+            {
+                vk_binding.pImmutableSamplers = vk_immutable_sampler_list.data() + vk_immutable_sampler_list.size();
+                for (uint32_t j = 0; j < rhi_binding.descriptorCount; ++j)
+                {
+                    vk_immutable_sampler_list.push_back(((VulkanSampler*)rhi_binding.pImmutableSamplers[j])->getResource());
+                }
+            }
+        }
 
-        return shahder;
+        VkDescriptorSetLayoutCreateInfo create_info{};
+        create_info.sType = (VkStructureType)pCreateInfo->sType;
+        create_info.pNext = (const void*)pCreateInfo->pNext;
+        create_info.flags = (VkDescriptorSetLayoutCreateFlags)pCreateInfo->flags;
+        create_info.bindingCount = pCreateInfo->bindingCount;
+        create_info.pBindings = vk_descriptor_set_layout_binding_list.data();
+
+        VkDescriptorSetLayout vk_descriptor_set_layout;
+        if (vkCreateDescriptorSetLayout(m_logical_device, &create_info, nullptr, &vk_descriptor_set_layout) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create descriptor set layout!");
+            return false;
+        }
+
+        pSetLayout = new VulkanDescriptorSetLayout();
+        ((VulkanDescriptorSetLayout*)pSetLayout)->setResource(vk_descriptor_set_layout);
+        m_descriptor_set_layout_cache.emplace(std::move(key), pSetLayout);
+        std::cout << "createDescriptorSetLayout success!" << std::endl;
+        return RHI_SUCCESS;
     }
 
     bool VulkanRHI::createPipelineLayout(const RHIPipelineLayoutCreateInfo* pCreateInfo, RHIPipelineLayout*& pPipelineLayout)
     {
-        //todo descriptor_set_layout
-        // int descriptor_set_layout_size = pCreateInfo->setLayoutCount;
-        // std::vector<VkDescriptorSetLayout> vk_descriptor_set_layout_list(descriptor_set_layout_size);
-        // for (int i = 0; i < descriptor_set_layout_size; ++i)
-        // {
-        //     const auto& rhi_descriptor_set_layout_element = pCreateInfo->pSetLayouts[i];
-        //     auto& vk_descriptor_set_layout_element = vk_descriptor_set_layout_list[i];
-        //     vk_descriptor_set_layout_element = ((VulkanDescriptorSetLayout*)rhi_descriptor_set_layout_element)->getResource();
-        // }
+        // 各个pipeline使用同一个layout对象时，PSO注册表的key也一致
+        std::string key;
+        appendPipelineLayoutKey(key, pCreateInfo);
+        std::lock_guard<std::mutex> lock(m_layout_cache_mutex);
+        auto iter = m_pipeline_layout_cache.find(key);
+        if (iter != m_pipeline_layout_cache.end())
+        {
+            pPipelineLayout = iter->second;
+            return RHI_SUCCESS;
+        }
+
+        std::vector<VkDescriptorSetLayout> vk_descriptor_set_layout_list(pCreateInfo->setLayoutCount);
+        for (uint32_t i = 0; i < pCreateInfo->setLayoutCount; ++i)
+        {
+            vk_descriptor_set_layout_list[i] = ((VulkanDescriptorSetLayout*)pCreateInfo->pSetLayouts[i])->getResource();
+        }
 
         VkPipelineLayoutCreateInfo create_info{};
         create_info.sType = (VkStructureType)pCreateInfo->sType;
         create_info.pNext = (const void*)pCreateInfo->pNext;
         create_info.flags = (VkPipelineLayoutCreateFlags)pCreateInfo->flags;
         create_info.setLayoutCount = pCreateInfo->setLayoutCount; // Optional
-        create_info.pSetLayouts = nullptr; // Optional
-        // create_info.pushConstantRangeCount = 0; // Optional
-        // create_info.pPushConstantRanges = nullptr; // Optional
+        create_info.pSetLayouts = vk_descriptor_set_layout_list.data(); // Optional
+        create_info.pushConstantRangeCount = pCreateInfo->pushConstantRangeCount;
+        create_info.pPushConstantRanges = reinterpret_cast<const VkPushConstantRange*>(pCreateInfo->pPushConstantRanges);
 
-        // pPipelineLayout是引用，本身是RHIPipelineLayout类型的指针
-        pPipelineLayout = new VulkanPipelineLayout();
         VkPipelineLayout vk_pipeline_layout;
         if (vkCreatePipelineLayout(m_logical_device, &create_info, nullptr, &vk_pipeline_layout) != VK_SUCCESS) {
             throw std::runtime_error("failed to create pipeline layout!");
             return false;
         }
-        else {
-            ((VulkanPipelineLayout*)pPipelineLayout)->setResource(vk_pipeline_layout);
-            std::cout << "createPipelineLayout success!" << std::endl;
+        // pPipelineLayout是引用，本身是RHIPipelineLayout类型的指针
+        pPipelineLayout = new VulkanPipelineLayout();
+        ((VulkanPipelineLayout*)pPipelineLayout)->setResource(vk_pipeline_layout);
+        m_pipeline_layout_cache.emplace(std::move(key), pPipelineLayout);
+        std::cout << "createPipelineLayout success!" << std::endl;
+        return RHI_SUCCESS;
+    }
+
+    // https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#samplers
+    bool VulkanRHI::createSampler(const RHISamplerCreateInfo* pCreateInfo, RHISampler*& pSampler)
+    {
+        std::string key;
+        appendSamplerKey(key, pCreateInfo);
+        std::lock_guard<std::mutex> lock(m_layout_cache_mutex);
+        auto iter = m_sampler_cache.find(key);
+        if (iter != m_sampler_cache.end())
+        {
+            pSampler = iter->second;
             return RHI_SUCCESS;
         }
+
+        VkSamplerCreateInfo create_info{};
+        create_info.sType = (VkStructureType)pCreateInfo->sType;
+        create_info.pNext = (const void*)pCreateInfo->pNext;
+        create_info.flags = (VkSamplerCreateFlags)pCreateInfo->flags;
+        create_info.magFilter = (VkFilter)pCreateInfo->magFilter;
+        create_info.minFilter = (VkFilter)pCreateInfo->minFilter;
+        create_info.mipmapMode = (VkSamplerMipmapMode)pCreateInfo->mipmapMode;
+        create_info.addressModeU = (VkSamplerAddressMode)pCreateInfo->addressModeU;
+        create_info.addressModeV = (VkSamplerAddressMode)pCreateInfo->addressModeV;
+        create_info.addressModeW = (VkSamplerAddressMode)pCreateInfo->addressModeW;
+        create_info.mipLodBias = pCreateInfo->mipLodBias;
+        create_info.anisotropyEnable = (VkBool32)pCreateInfo->anisotropyEnable;
+        create_info.maxAnisotropy = pCreateInfo->maxAnisotropy;
+        create_info.compareEnable = (VkBool32)pCreateInfo->compareEnable;
+        create_info.compareOp = (VkCompareOp)pCreateInfo->compareOp;
+        create_info.minLod = pCreateInfo->minLod;
+        create_info.maxLod = pCreateInfo->maxLod;
+        create_info.borderColor = (VkBorderColor)pCreateInfo->borderColor;
+        create_info.unnormalizedCoordinates = (VkBool32)pCreateInfo->unnormalizedCoordinates;
+
+        VkSampler vk_sampler;
+        if (vkCreateSampler(m_logical_device, &create_info, nullptr, &vk_sampler) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create sampler!");
+            return false;
+        }
+
+        pSampler = new VulkanSampler();
+        ((VulkanSampler*)pSampler)->setResource(vk_sampler);
+        m_sampler_cache.emplace(std::move(key), pSampler);
+        std::cout << "createSampler success!" << std::endl;
+        return RHI_SUCCESS;
     }
 
     bool VulkanRHI::createRenderPass(const RHIRenderPassCreateInfo* pCreateInfo, RHIRenderPass*& pRenderPass) {
@@ -1280,6 +2628,9 @@ namespace Mercury
         VkRenderPass vk_render_pass;
         VkResult result = vkCreateRenderPass(m_logical_device, &create_info, nullptr, &vk_render_pass);
         ((VulkanRenderPass*)pRenderPass)->setResource(vk_render_pass);
+        std::string render_pass_key;
+        appendRenderPassCompatibilityKey(render_pass_key, pCreateInfo);
+        ((VulkanRenderPass*)pRenderPass)->setKey(std::move(render_pass_key));
 
         if (result == VK_SUCCESS)
         {
@@ -1335,12 +2686,70 @@ namespace Mercury
         }
     }
 
+    std::string VulkanRHI::makeGraphicsPipelineKey(const RHIGraphicsPipelineCreateInfo* pCreateInfo)
+    {
+        std::string key;
+        appendGraphicsPipelineStateKey(key, pCreateInfo);
+        for (uint32_t i = 0; i < pCreateInfo->stageCount; ++i)
+        {
+            // shader module每次加载都会重新创建，句柄可能被复用，所以按字节码比较
+            key_append(key, std::string_view(((VulkanShader*)pCreateInfo->pStages[i].module)->getKey()));
+        }
+        // pipeline layout由layout缓存去重并持有到设备销毁，句柄相同即内容相同
+        key_append(key, pCreateInfo->layout);
+        key_append(key, std::string_view(((VulkanRenderPass*)pCreateInfo->renderPass)->getKey()));
+        key_append(key, pCreateInfo->basePipelineHandle);
+        return key;
+    }
+
     // https://vulkan-tutorial.com/Drawing_a_triangle/Graphics_pipeline_basics/Conclusion
+    // 注册表中的pipeline由RHI持有，调用者不能单独销毁返回的pipeline
     bool VulkanRHI::createGraphicsPipelines(
         RHIPipelineCache* pipelineCache,
         uint32_t createInfoCount,
         const RHIGraphicsPipelineCreateInfo* pCreateInfo,
         RHIPipeline*& pPipelines) {
+        if (createInfoCount != 1)
+        {
+            throw std::runtime_error("createGraphicsPipelines only supports one create info!");
+            return false;
+        }
+
+        std::string key = makeGraphicsPipelineKey(pCreateInfo);
+        std::promise<RHIPipeline*> promise;
+        std::unique_lock<std::mutex> lock(m_graphics_pipeline_registry_mutex);
+        auto iter = m_graphics_pipeline_registry.find(key);
+        if (iter != m_graphics_pipeline_registry.end())
+        {
+            std::shared_future<RHIPipeline*> future = iter->second;
+            lock.unlock();
+            pPipelines = future.get();
+            return RHI_SUCCESS;
+        }
+        m_graphics_pipeline_registry.emplace(key, promise.get_future().share());
+        lock.unlock();
+
+        try
+        {
+            compileGraphicsPipeline(pipelineCache, pCreateInfo, pPipelines);
+        }
+        catch (...)
+        {
+            // 编译失败时移除注册项，等待中的线程会收到同样的异常，之后的请求可以重新尝试
+            lock.lock();
+            m_graphics_pipeline_registry.erase(key);
+            lock.unlock();
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+        promise.set_value(pPipelines);
+        return RHI_SUCCESS;
+    }
+
+    bool VulkanRHI::compileGraphicsPipeline(
+        RHIPipelineCache* pipelineCache,
+        const RHIGraphicsPipelineCreateInfo* pCreateInfo,
+        RHIPipeline*& pPipelines) {
         //pipeline_shader_stage_create_info
         int pipeline_shader_stage_create_info_size = pCreateInfo->stageCount;
         std::vector<VkPipelineShaderStageCreateInfo> vk_pipeline_shader_stage_create_info_list(pipeline_shader_stage_create_info_size);
@@ -1466,7 +2875,8 @@ namespace Mercury
         }
 
         //viewport
-        int viewport_size = pCreateInfo->pViewportState->viewportCount;
+        // viewport/scissor为动态状态时pViewports/pScissors可以为空
+        int viewport_size = pCreateInfo->pViewportState->pViewports != nullptr ? pCreateInfo->pViewportState->viewportCount : 0;
         std::vector<VkViewport> vk_viewport_list(viewport_size);
         for (int i = 0; i < viewport_size; ++i)
         {
@@ -1482,7 +2892,7 @@ namespace Mercury
         };
 
         //rect_2d
-        int rect_2d_size = pCreateInfo->pViewportState->scissorCount;
+        int rect_2d_size = pCreateInfo->pViewportState->pScissors != nullptr ? pCreateInfo->pViewportState->scissorCount : 0;
         std::vector<VkRect2D> vk_rect_2d_list(rect_2d_size);
         for (int i = 0; i < rect_2d_size; ++i)
         {
@@ -1506,9 +2916,9 @@ namespace Mercury
         vk_pipeline_viewport_state_create_info.pNext = (const void*)pCreateInfo->pViewportState->pNext;
         vk_pipeline_viewport_state_create_info.flags = (VkPipelineViewportStateCreateFlags)pCreateInfo->pViewportState->flags;
         vk_pipeline_viewport_state_create_info.viewportCount = pCreateInfo->pViewportState->viewportCount;
-        vk_pipeline_viewport_state_create_info.pViewports = vk_viewport_list.data();
+        vk_pipeline_viewport_state_create_info.pViewports = viewport_size > 0 ? vk_viewport_list.data() : nullptr;
         vk_pipeline_viewport_state_create_info.scissorCount = pCreateInfo->pViewportState->scissorCount;
-        vk_pipeline_viewport_state_create_info.pScissors = vk_rect_2d_list.data();
+        vk_pipeline_viewport_state_create_info.pScissors = rect_2d_size > 0 ? vk_rect_2d_list.data() : nullptr;
 
         VkPipelineRasterizationStateCreateInfo vk_pipeline_rasterization_state_create_info{};
         vk_pipeline_rasterization_state_create_info.sType = (VkStructureType)pCreateInfo->pRasterizationState->sType;
@@ -1648,12 +3058,14 @@ namespace Mercury
 
         pPipelines = new VulkanPipeline();
         VkPipeline vk_pipelines;
+        // 调用者没有指定时使用全局共享的pipeline cache
+        RHIPipelineCache* rhi_pipeline_cache = pipelineCache != nullptr ? pipelineCache : m_pipeline_cache;
         VkPipelineCache vk_pipeline_cache = VK_NULL_HANDLE;
-        if (pipelineCache != nullptr)
+        if (rhi_pipeline_cache != nullptr)
         {
-            vk_pipeline_cache = ((VulkanPipelineCache*)pipelineCache)->getResource();
+            vk_pipeline_cache = ((VulkanPipelineCache*)rhi_pipeline_cache)->getResource();
         }
-        VkResult result = vkCreateGraphicsPipelines(m_logical_device, vk_pipeline_cache, createInfoCount, &create_info, nullptr, &vk_pipelines);
+        VkResult result = vkCreateGraphicsPipelines(m_logical_device, vk_pipeline_cache, 1, &create_info, nullptr, &vk_pipelines);
         ((VulkanPipeline*)pPipelines)->setResource(vk_pipelines);
 
         if (result == VK_SUCCESS)
@@ -1668,54 +3080,243 @@ namespace Mercury
         }
     }
 
+    // https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#pipelines-compute
+    bool VulkanRHI::createComputePipelines(
+        RHIPipelineCache* pipelineCache,
+        uint32_t createInfoCount,
+        const RHIComputePipelineCreateInfo* pCreateInfo,
+        RHIPipeline*& pPipelines) {
+        if (createInfoCount != 1)
+        {
+            throw std::runtime_error("createComputePipelines only supports one create info!");
+            return false;
+        }
+
+        const RHIPipelineShaderStageCreateInfo& rhi_stage = *pCreateInfo->pStages;
+        VkSpecializationInfo vk_specialization_info{};
+        std::vector<VkSpecializationMapEntry> vk_specialization_map_entry_list;
+        if (rhi_stage.pSpecializationInfo != nullptr)
+        {
+            vk_specialization_map_entry_list.resize(rhi_stage.pSpecializationInfo->mapEntryCount);
+            for (uint32_t i = 0; i < rhi_stage.pSpecializationInfo->mapEntryCount; ++i)
+            {
+                const auto& rhi_specialization_map_entry_element = rhi_stage.pSpecializationInfo->pMapEntries[i];
+                vk_specialization_map_entry_list[i].constantID = rhi_specialization_map_entry_element->constantID;
+                vk_specialization_map_entry_list[i].offset = rhi_specialization_map_entry_element->offset;
+                vk_specialization_map_entry_list[i].size = rhi_specialization_map_entry_element->size;
+            }
+            vk_specialization_info.mapEntryCount = rhi_stage.pSpecializationInfo->mapEntryCount;
+            vk_specialization_info.pMapEntries = vk_specialization_map_entry_list.data();
+            vk_specialization_info.dataSize = rhi_stage.pSpecializationInfo->dataSize;
+            vk_specialization_info.pData = (const void*)rhi_stage.pSpecializationInfo->pData;
+        }
+
+        VkComputePipelineCreateInfo create_info{};
+        create_info.sType = (VkStructureType)pCreateInfo->sType;
+        create_info.pNext = (const void*)pCreateInfo->pNext;
+        create_info.flags = (VkPipelineCreateFlags)pCreateInfo->flags;
+        create_info.stage.sType = (VkStructureType)rhi_stage.sType;
+        create_info.stage.pNext = (const void*)rhi_stage.pNext;
+        create_info.stage.flags = (VkPipelineShaderStageCreateFlags)rhi_stage.flags;
+        create_info.stage.stage = (VkShaderStageFlagBits)rhi_stage.stage;
+        create_info.stage.module = ((VulkanShader*)rhi_stage.module)->getResource();
+        create_info.stage.pName = rhi_stage.pName;
+        create_info.stage.pSpecializationInfo = rhi_stage.pSpecializationInfo != nullptr ? &vk_specialization_info : nullptr;
+        create_info.layout = ((VulkanPipelineLayout*)pCreateInfo->layout)->getResource();
+        if (pCreateInfo->basePipelineHandle != nullptr)
+        {
+            create_info.basePipelineHandle = ((VulkanPipeline*)pCreateInfo->basePipelineHandle)->getResource();
+        }
+        else
+        {
+            create_info.basePipelineHandle = VK_NULL_HANDLE;
+        }
+        create_info.basePipelineIndex = pCreateInfo->basePipelineIndex;
+
+        // 调用者没有指定时使用全局共享的pipeline cache
+        RHIPipelineCache* rhi_pipeline_cache = pipelineCache != nullptr ? pipelineCache : m_pipeline_cache;
+        VkPipelineCache vk_pipeline_cache = VK_NULL_HANDLE;
+        if (rhi_pipeline_cache != nullptr)
+        {
+            vk_pipeline_cache = ((VulkanPipelineCache*)rhi_pipeline_cache)->getResource();
+        }
+        VkPipeline vk_pipeline;
+        if (vkCreateComputePipelines(m_logical_device, vk_pipeline_cache, 1, &create_info, nullptr, &vk_pipeline) != VK_SUCCESS)
+        {
+            throw std::runtime_error("vkCreateComputePipelines failed!");
+            return false;
+        }
+
+        pPipelines = new VulkanPipeline();
+        ((VulkanPipeline*)pPipelines)->setResource(vk_pipeline);
+        std::lock_guard<std::mutex> lock(m_compute_pipelines_mutex);
+        m_compute_pipelines.push_back(pPipelines);
+        std::cout << "vkCreateComputePipelines success!" << std::endl;
+        return RHI_SUCCESS;
+    }
+
     // https://vulkan-tutorial.com/Drawing_a_triangle/Swap_chain_recreation
+    void VulkanRHI::setPresentMode(RHIPresentModeKHR present_mode) {
+        if (present_mode == m_requested_present_mode)
+        {
+            return;
+        }
+        m_requested_present_mode = present_mode;
+        m_is_swapchain_recreate_requested = true;
+    }
+
+    void VulkanRHI::setFramesInFlight(uint8_t frames_in_flight) {
+        frames_in_flight = std::clamp(frames_in_flight, (uint8_t)1, k_max_frames_in_flight);
+        if (frames_in_flight == m_frames_in_flight)
+        {
+            return;
+        }
+        // 等所有在途的帧完成后再切换，之后从第0帧的资源重新开始轮转
+        waitDeviceIdle();
+        // 减少帧数后不再轮转到的槽位不会再被重置，这里把所有槽位的描述符池都回收
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            m_descriptor_allocator.resetFrame(i);
+        }
+        m_frames_in_flight = frames_in_flight;
+        m_current_frame_index = 0;
+    }
+
     void VulkanRHI::recreateSwapchain() {
+        m_is_swapchain_recreate_requested = false;
         int width = 0;
         int height = 0;
-        glfwGetFramebufferSize(m_window, &width, &height);
-        while (width == 0 || height == 0) { // minimized 0,0, pause for now
+        while (!m_is_headless && (width == 0 || height == 0)) { // minimized 0,0, pause for now
             glfwGetFramebufferSize(m_window, &width, &height);
-            glfwWaitEvents();
+            if (width == 0 || height == 0) {
+                glfwWaitEvents();
+            }
         }
 
-        // 如果CPU(主机)需要知道 GPU 完成了什么工作，我们就需要使用栅栏(Fences)
-        // https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Rendering_and_presentation#page_Fences
-        // 这里等待上一帧渲染完成之后，CPU再绘制下一帧，等价于VulkanRHI::waitForFences()函数
-        VkResult res_wait_for_fences = _vkWaitForFences(m_logical_device, k_max_frames_in_flight, m_is_frame_in_flight_fences, VK_TRUE, UINT64_MAX);
-        if (VK_SUCCESS != res_wait_for_fences)
-        {
-            throw std::runtime_error("_vkWaitForFences failed");
-            return;
-        }
+        // 等待所有已提交的帧完成：最近一次提交的值到达时，之前的帧都已完成
+        waitForFrameTimelineValue(m_frame_timeline_value);
 
         destroyImageView(m_depth_image_view);
-        vkDestroyImage(m_logical_device, ((VulkanImage*)m_depth_image)->getResource(), NULL);
-        vkFreeMemory(m_logical_device, m_depth_image_memory, NULL);
+        destroyImage(m_depth_image, m_depth_image_allocation);
 
-        for (auto imageview : m_swapchain_imageviews)
+        destroySwapchainImages();
+
+        if (m_is_headless)
         {
-            vkDestroyImageView(m_logical_device, ((VulkanImageView*)imageview)->getResource(), NULL);
+            createOffscreenImages();
+        }
+        else
+        {
+            createSwapchain();
         }
-        vkDestroySwapchainKHR(m_logical_device, m_swapchain, NULL);
-
-        createSwapchain();
         createSwapchainImageViews();
         createFramebufferImageAndView();
     }
 
-    // todo 将我们要执行的命令写入命令缓冲区:https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Command_buffers#page_Command-buffer-recording
+    RHICommandBuffer* VulkanRHI::allocateSecondaryCommandBuffer(uint32_t worker_index)
+    {
+        if (worker_index >= m_command_recording_worker_count)
+        {
+            throw std::runtime_error("command recording worker index out of range");
+            return nullptr;
+        }
+
+        WorkerCommandPool& worker_command_pool = m_worker_command_pools[m_current_frame_index][worker_index];
+        if (worker_command_pool.used_secondary_count == worker_command_pool.secondary_command_buffers.size())
+        {
+            VkCommandBufferAllocateInfo command_buffer_allocate_info{};
+            command_buffer_allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            command_buffer_allocate_info.commandPool = worker_command_pool.command_pool;
+            command_buffer_allocate_info.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY; // 不能直接提交，由主命令缓冲区通过vkCmdExecuteCommands调用
+            command_buffer_allocate_info.commandBufferCount = 1U;
+
+            VkCommandBuffer vk_command_buffer;
+            if (vkAllocateCommandBuffers(m_logical_device, &command_buffer_allocate_info, &vk_command_buffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to allocate secondary command buffer!");
+                return nullptr;
+            }
+            RHICommandBuffer* command_buffer = new VulkanCommandBuffer();
+            ((VulkanCommandBuffer*)command_buffer)->setResource(vk_command_buffer);
+            worker_command_pool.secondary_command_buffers.push_back(command_buffer);
+        }
+        return worker_command_pool.secondary_command_buffers[worker_command_pool.used_secondary_count++];
+    }
+
+    // 将我们要执行的命令写入命令缓冲区:https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Command_buffers#page_Command-buffer-recording
     bool VulkanRHI::beginCommandBuffer(RHICommandBuffer* commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo) {
-        return false;
+        // secondary command buffer需要通过inheritance info知道自己将在哪个render pass/subpass中执行
+        VkCommandBufferInheritanceInfo vk_inheritance_info{};
+        const RHICommandBufferInheritanceInfo* pInheritanceInfo = pBeginInfo->pInheritanceInfo;
+        if (pInheritanceInfo != nullptr)
+        {
+            vk_inheritance_info.sType = (VkStructureType)pInheritanceInfo->sType;
+            vk_inheritance_info.pNext = pInheritanceInfo->pNext;
+            vk_inheritance_info.renderPass = pInheritanceInfo->renderPass == nullptr ? VK_NULL_HANDLE : ((VulkanRenderPass*)pInheritanceInfo->renderPass)->getResource();
+            vk_inheritance_info.subpass = pInheritanceInfo->subpass;
+            // framebuffer是可选的，提供时驱动可以做更多优化
+            vk_inheritance_info.framebuffer = pInheritanceInfo->framebuffer == nullptr ? VK_NULL_HANDLE : ((VulkanFramebuffer*)pInheritanceInfo->framebuffer)->getResource();
+            vk_inheritance_info.occlusionQueryEnable = (VkBool32)pInheritanceInfo->occlusionQueryEnable;
+            vk_inheritance_info.queryFlags = (VkQueryControlFlags)pInheritanceInfo->queryFlags;
+            vk_inheritance_info.pipelineStatistics = (VkQueryPipelineStatisticFlags)pInheritanceInfo->pipelineStatistics;
+        }
+
+        VkCommandBufferBeginInfo command_buffer_begin_info{};
+        command_buffer_begin_info.sType = (VkStructureType)pBeginInfo->sType;
+        command_buffer_begin_info.pNext = pBeginInfo->pNext;
+        command_buffer_begin_info.flags = (VkCommandBufferUsageFlags)pBeginInfo->flags;
+        command_buffer_begin_info.pInheritanceInfo = pInheritanceInfo == nullptr ? nullptr : &vk_inheritance_info;
+
+        VkResult res_begin_command_buffer = _vkBeginCommandBuffer(((VulkanCommandBuffer*)commandBuffer)->getResource(), &command_buffer_begin_info);
+        if (VK_SUCCESS != res_begin_command_buffer)
+        {
+            throw std::runtime_error("_vkBeginCommandBuffer failed!");
+            return false;
+        }
+        return RHI_SUCCESS;
+    }
+
+    bool VulkanRHI::endCommandBuffer(RHICommandBuffer* commandBuffer) {
+        VkResult res_end_command_buffer = _vkEndCommandBuffer(((VulkanCommandBuffer*)commandBuffer)->getResource());
+        if (VK_SUCCESS != res_end_command_buffer)
+        {
+            throw std::runtime_error("_vkEndCommandBuffer failed!");
+            return false;
+        }
+        return RHI_SUCCESS;
+    }
+
+    // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkCmdExecuteCommands.html
+    // 在render pass内调用时，该render pass必须以RHI_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS开始
+    void VulkanRHI::cmdExecuteCommands(RHICommandBuffer* commandBuffer, uint32_t commandBufferCount, RHICommandBuffer* const* pCommandBuffers) {
+        // 每个工作线程录制一个secondary command buffer，数量随核心数变化，没有固定上限；
+        // 按栈上数组的大小分批调用，多次vkCmdExecuteCommands与一次执行全部等价
+        static constexpr uint32_t k_max_execute_command_buffer_count = 64;
+        VkCommandBuffer vk_command_buffer = ((VulkanCommandBuffer*)commandBuffer)->getResource();
+        VkCommandBuffer vk_command_buffer_list[k_max_execute_command_buffer_count];
+        for (uint32_t first = 0; first < commandBufferCount; first += k_max_execute_command_buffer_count)
+        {
+            const uint32_t count = std::min(commandBufferCount - first, k_max_execute_command_buffer_count);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                vk_command_buffer_list[i] = ((VulkanCommandBuffer*)pCommandBuffers[first + i])->getResource();
+            }
+            _vkCmdExecuteCommands(vk_command_buffer, count, vk_command_buffer_list);
+        }
     }
 
 
     std::vector<const char*> VulkanRHI::getRequiredExtensions()
     {
-        uint32_t     glfwExtensionCount = 0;
-        const char** glfwExtensions;
-        glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-        std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        // headless没有surface，不需要窗口系统相关的实例扩展（GLFW也没有初始化）
+        std::vector<const char*> extensions;
+        if (!m_is_headless)
+        {
+            uint32_t     glfwExtensionCount = 0;
+            const char** glfwExtensions;
+            glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        }
 
         if (m_enable_validation_layers || m_enable_debug_utils_label)
         {
@@ -1724,6 +3325,14 @@ namespace Mercury
 
 #if defined(__MACH__) // defined by implementations targeting Apple unix operating systems (OSX, iOS, and Darwin)
         extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+        m_enable_memory_budget = true;
+#else
+        // VK_EXT_memory_budget在Vulkan 1.0下依赖该实例扩展
+        if (isInstanceExtensionSupported(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+        {
+            extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+            m_enable_memory_budget = true;
+        }
 #endif
 
         return extensions;
@@ -1734,14 +3343,65 @@ namespace Mercury
         return m_current_command_buffer;
     }
 
-    RHISwapChainDesc VulkanRHI::getSwapchainInfo() {
-        RHISwapChainDesc desc;
-        desc.imageFormat = m_swapchain_images_format;
-        desc.extent = m_swapchain_extend;
-        desc.scissor = &m_scissor;
-        desc.imageViews = m_swapchain_imageviews;
-        desc.viewport = &m_viewport;
-        return desc;
+    RHIPresentModeKHR VulkanRHI::getPresentMode() const
+    {
+        return m_present_mode;
+    }
+
+    uint8_t VulkanRHI::getFramesInFlight() const
+    {
+        return m_frames_in_flight;
+    }
+
+    RHIPipelineCache* VulkanRHI::getPipelineCache() const
+    {
+        return m_pipeline_cache;
+    }
+
+    // 是否存在同时具备这些属性的内存类型，例如移动端的DEVICE_LOCAL | LAZILY_ALLOCATED
+    bool VulkanRHI::isMemoryPropertySupported(RHIMemoryPropertyFlags property_flags)
+    {
+        VkPhysicalDeviceMemoryProperties memory_properties;
+        vkGetPhysicalDeviceMemoryProperties(m_physical_device, &memory_properties);
+        for (uint32_t i = 0; i < memory_properties.memoryTypeCount; i++)
+        {
+            if ((memory_properties.memoryTypes[i].propertyFlags & property_flags) == property_flags)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<RHIMemoryHeapBudget> VulkanRHI::getMemoryHeapBudgets()
+    {
+        const VkPhysicalDeviceMemoryProperties* memory_properties = nullptr;
+        vmaGetMemoryProperties(m_assets_allocator, &memory_properties);
+
+        VmaBudget vma_budgets[VK_MAX_MEMORY_HEAPS];
+        vmaGetHeapBudgets(m_assets_allocator, vma_budgets);
+
+        std::vector<RHIMemoryHeapBudget> budgets(memory_properties->memoryHeapCount);
+        for (uint32_t i = 0; i < memory_properties->memoryHeapCount; ++i)
+        {
+            budgets[i].heap_index = i;
+            budgets[i].heap_flags = (RHIMemoryHeapFlags)memory_properties->memoryHeaps[i].flags;
+            budgets[i].block_count = vma_budgets[i].statistics.blockCount;
+            budgets[i].allocation_count = vma_budgets[i].statistics.allocationCount;
+            budgets[i].block_bytes = vma_budgets[i].statistics.blockBytes;
+            budgets[i].allocation_bytes = vma_budgets[i].statistics.allocationBytes;
+            budgets[i].usage = vma_budgets[i].usage;
+            budgets[i].budget = vma_budgets[i].budget;
+        }
+        return budgets;
+    }
+
+    const RHISwapChainDesc& VulkanRHI::getSwapchainInfo() const {
+        return m_swapchain_desc;
+    }
+
+    uint64_t VulkanRHI::getSwapchainGeneration() const {
+        return m_swapchain_desc.generation;
     }
 
     RHIDepthImageDesc VulkanRHI::getDepthImageInfo() {
@@ -1752,8 +3412,166 @@ namespace Mercury
         return desc;
     }
 
+    RHIPhysicalDeviceLimits VulkanRHI::getPhysicalDeviceLimits() {
+        const VkPhysicalDeviceLimits& limits = m_physical_device_properties.limits;
+        RHIPhysicalDeviceLimits desc;
+        desc.minUniformBufferOffsetAlignment = limits.minUniformBufferOffsetAlignment;
+        desc.minStorageBufferOffsetAlignment = limits.minStorageBufferOffsetAlignment;
+        desc.nonCoherentAtomSize = limits.nonCoherentAtomSize;
+        desc.maxUniformBufferRange = limits.maxUniformBufferRange;
+        desc.maxStorageBufferRange = limits.maxStorageBufferRange;
+        return desc;
+    }
+
     void VulkanRHI::destroyDevice() {
+        // 延迟释放的资源可能来自分配器，需要在销毁分配器之前释放
+        waitDeviceIdle();
+        for (DeferredRelease& deferred_release : m_deferred_releases)
+        {
+            deferred_release.release();
+        }
+        m_deferred_releases.clear();
+
+        for (auto& [key, future] : m_graphics_pipeline_registry)
+        {
+            RHIPipeline* pipeline = future.get();
+            vkDestroyPipeline(m_logical_device, ((VulkanPipeline*)pipeline)->getResource(), nullptr);
+            delete pipeline;
+        }
+        m_graphics_pipeline_registry.clear();
+
+        for (RHIPipeline* pipeline : m_compute_pipelines)
+        {
+            vkDestroyPipeline(m_logical_device, ((VulkanPipeline*)pipeline)->getResource(), nullptr);
+            delete pipeline;
+        }
+        m_compute_pipelines.clear();
+
+        // layout要在使用它们的pipeline之后销毁
+        for (auto& [key, pipeline_layout] : m_pipeline_layout_cache)
+        {
+            vkDestroyPipelineLayout(m_logical_device, ((VulkanPipelineLayout*)pipeline_layout)->getResource(), nullptr);
+            delete pipeline_layout;
+        }
+        m_pipeline_layout_cache.clear();
+        for (auto& [key, set_layout] : m_descriptor_set_layout_cache)
+        {
+            vkDestroyDescriptorSetLayout(m_logical_device, ((VulkanDescriptorSetLayout*)set_layout)->getResource(), nullptr);
+            delete set_layout;
+        }
+        m_descriptor_set_layout_cache.clear();
+        // immutable sampler在引用它们的set layout之后销毁
+        for (auto& [key, sampler] : m_sampler_cache)
+        {
+            vkDestroySampler(m_logical_device, ((VulkanSampler*)sampler)->getResource(), nullptr);
+            delete sampler;
+        }
+        m_sampler_cache.clear();
+
+        // pipeline cache只在RenderSystem::clear中写回磁盘一次，这里只销毁
+        if (m_pipeline_cache != nullptr)
+        {
+            vkDestroyPipelineCache(m_logical_device, ((VulkanPipelineCache*)m_pipeline_cache)->getResource(), nullptr);
+            delete m_pipeline_cache;
+            m_pipeline_cache = nullptr;
+        }
+
+        // 销毁command pool时其中分配的command buffer一并释放
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            for (WorkerCommandPool& worker_command_pool : m_worker_command_pools[i])
+            {
+                vkDestroyCommandPool(m_logical_device, worker_command_pool.command_pool, nullptr);
+                for (RHICommandBuffer* command_buffer : worker_command_pool.secondary_command_buffers)
+                {
+                    delete command_buffer;
+                }
+            }
+            m_worker_command_pools[i].clear();
+
+            vkDestroyCommandPool(m_logical_device, m_async_compute_command_pools[i], nullptr);
+            for (RHICommandBuffer* command_buffer : m_async_compute_command_buffers[i])
+            {
+                delete command_buffer;
+            }
+            m_async_compute_command_buffers[i].clear();
+
+            vkDestroyCommandPool(m_logical_device, m_command_pools[i], nullptr);
+            m_command_pools[i] = VK_NULL_HANDLE;
+            delete m_rhi_command_buffers[i];
+            m_rhi_command_buffers[i] = nullptr;
+        }
+        delete m_current_command_buffer;
+        m_current_command_buffer = nullptr;
+        if (m_rhi_command_pool != nullptr)
+        {
+            vkDestroyCommandPool(m_logical_device, ((VulkanCommandPool*)m_rhi_command_pool)->getResource(), nullptr);
+            delete m_rhi_command_pool;
+            m_rhi_command_pool = nullptr;
+        }
+
+        for (GpuTimestampFrame& frame : m_gpu_timestamp_frames)
+        {
+            if (frame.query_pool != VK_NULL_HANDLE)
+            {
+                vkDestroyQueryPool(m_logical_device, frame.query_pool, nullptr);
+                frame.query_pool = VK_NULL_HANDLE;
+            }
+        }
+
+        // 分配器销毁前必须先释放所有从它分配的资源
+        m_upload_manager.clear();
+        m_descriptor_allocator.clear();
+        destroySwapchainImages();
+        if (m_readback_buffer != nullptr)
+        {
+            destroyBuffer(m_readback_buffer, m_readback_allocation);
+            m_readback_buffer = nullptr;
+        }
+        destroyImageView(m_depth_image_view);
+        delete m_depth_image_view;
+        m_depth_image_view = nullptr;
+        destroyImage(m_depth_image, m_depth_image_allocation);
+        m_depth_image = nullptr;
+        m_depth_image_allocation = nullptr;
+        vmaDestroyAllocator(m_assets_allocator);
+        m_assets_allocator = nullptr;
+
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            vkDestroySemaphore(m_logical_device, m_image_available_for_render_semaphores[i], nullptr);
+            vkDestroySemaphore(m_logical_device, m_image_finished_for_presentation_semaphores[i], nullptr);
+        }
+        vkDestroySemaphore(m_logical_device, m_frame_timeline_semaphore, nullptr);
+        delete m_rhi_frame_timeline_semaphore;
+        m_rhi_frame_timeline_semaphore = nullptr;
+        vkDestroySemaphore(m_logical_device, m_async_compute_timeline_semaphore, nullptr);
+        delete m_rhi_async_compute_timeline_semaphore;
+        m_rhi_async_compute_timeline_semaphore = nullptr;
         vkDestroyDevice(m_logical_device, nullptr);
+        m_logical_device = VK_NULL_HANDLE;
+
+        // 队列随设备一起销毁，这里只释放包装对象
+        delete m_graphics_queue;
+        delete m_compute_queue;
+        delete m_transfer_queue;
+        m_graphics_queue = nullptr;
+        m_compute_queue = nullptr;
+        m_transfer_queue = nullptr;
+
+        // 与创建顺序相反：surface和debug messenger都属于instance，最后销毁instance
+        if (!m_is_headless)
+        {
+            vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+            m_surface = VK_NULL_HANDLE;
+        }
+        if (m_enable_validation_layers && m_debug_messager != VK_NULL_HANDLE)
+        {
+            destroyDebugUtilsMessengerEXT(m_instance, m_debug_messager, nullptr);
+            m_debug_messager = VK_NULL_HANDLE;
+        }
+        vkDestroyInstance(m_instance, nullptr);
+        m_instance = VK_NULL_HANDLE;
     }
 
     void VulkanRHI::destroyImageView(RHIImageView* imageView)
@@ -1771,5 +3589,25 @@ namespace Mercury
     {
         vkDestroyFramebuffer(m_logical_device, ((VulkanFramebuffer*)framebuffer)->getResource(), nullptr);
     }
+
+    void VulkanRHI::destroyRenderPass(RHIRenderPass* renderPass)
+    {
+        vkDestroyRenderPass(m_logical_device, ((VulkanRenderPass*)renderPass)->getResource(), nullptr);
+        delete renderPass;
+    }
+
+    void VulkanRHI::destroyBuffer(RHIBuffer* buffer, RHIAllocation* allocation)
+    {
+        vmaDestroyBuffer(m_assets_allocator, ((VulkanBuffer*)buffer)->getResource(), ((VulkanAllocation*)allocation)->getResource());
+        delete(buffer);
+        delete(allocation);
+    }
+
+    void VulkanRHI::destroyImage(RHIImage* image, RHIAllocation* allocation)
+    {
+        vmaDestroyImage(m_assets_allocator, ((VulkanImage*)image)->getResource(), ((VulkanAllocation*)allocation)->getResource());
+        delete(image);
+        delete(allocation);
+    }
 } // namespace Mercury
 
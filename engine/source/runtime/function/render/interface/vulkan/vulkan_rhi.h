@@ -5,12 +5,19 @@
 #include "runtime/function/render/interface/vulkan/vulkan_rhi_resource.h"
 #include "runtime/function/render/render_type.h"
 #include "runtime/function/render/interface/vulkan/vulkan_util.h"
+#include "runtime/function/render/interface/vulkan/vulkan_descriptor_allocator.h"
+#include "runtime/function/render/interface/vulkan/vulkan_upload_manager.h"
 
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
+#include <deque>
 #include <functional>
+#include <future>
 #include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace Mercury
@@ -26,62 +33,158 @@ namespace Mercury
         void createSwapchainImageViews() override;
         void createFramebufferImageAndView() override;
         RHIShader* createShaderModule(const std::vector<unsigned char>& shader_code) override;
+        bool createDescriptorSetLayout(const RHIDescriptorSetLayoutCreateInfo* pCreateInfo, RHIDescriptorSetLayout*& pSetLayout) override;
         bool createPipelineLayout(const RHIPipelineLayoutCreateInfo* pCreateInfo, RHIPipelineLayout*& pPipelineLayout) override;
+        bool createSampler(const RHISamplerCreateInfo* pCreateInfo, RHISampler*& pSampler) override;
         bool createRenderPass(const RHIRenderPassCreateInfo* pCreateInfo, RHIRenderPass*& pRenderPass) override;
         bool createFrameBuffer(const RHIFramebufferCreateInfo* pCreateInfo, RHIFramebuffer*& pFramebuffer) override;
         bool createGraphicsPipelines(RHIPipelineCache* pipelineCache, uint32_t createInfoCount, const RHIGraphicsPipelineCreateInfo* pCreateInfos, RHIPipeline*& pPipelines) override;
+        bool createComputePipelines(RHIPipelineCache* pipelineCache, uint32_t createInfoCount, const RHIComputePipelineCreateInfo* pCreateInfos, RHIPipeline*& pPipelines) override;
+        bool createBuffer(const RHIBufferCreateInfo* pCreateInfo, const RHIAllocationCreateInfo* pAllocationCreateInfo, RHIBuffer*& pBuffer, RHIAllocation*& pAllocation, RHIAllocationInfo* pAllocationInfo) override;
+        bool createImage(const RHIImageCreateInfo* pCreateInfo, const RHIAllocationCreateInfo* pAllocationCreateInfo, RHIImage*& pImage, RHIAllocation*& pAllocation, RHIAllocationInfo* pAllocationInfo) override;
+        bool createImageView(RHIImage* image, RHIFormat format, RHIImageAspectFlags image_aspect_flags, RHIImageViewType view_type, uint32_t layout_count, uint32_t miplevels, RHIImageView*& image_view) override;
         void recreateSwapchain() override;
+        bool savePipelineCache() override;
+        void setPresentMode(RHIPresentModeKHR present_mode) override;
+        void setFramesInFlight(uint8_t frames_in_flight) override;
 
         // command and write
+        RHICommandBuffer* allocateSecondaryCommandBuffer(uint32_t worker_index) override;
         bool beginCommandBuffer(RHICommandBuffer* commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo) override;
+        bool endCommandBuffer(RHICommandBuffer* commandBuffer) override;
+        void cmdExecuteCommands(RHICommandBuffer* commandBuffer, uint32_t commandBufferCount, RHICommandBuffer* const* pCommandBuffers) override;
         bool prepareBeforePass(std::function<void()> passUpdateAfterRecreateSwapchain) override;
         void submitRendering(std::function<void()> passUpdateAfterRecreateSwapchain) override;
         void pushEvent(RHICommandBuffer* commond_buffer, const char* name, const float* color) override;
         void popEvent(RHICommandBuffer* commond_buffer) override;
         void cmdSetViewportPFN(RHICommandBuffer* commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const RHIViewport* pViewports) override;
         void cmdSetScissorPFN(RHICommandBuffer* commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const RHIRect2D* pScissors) override;
-        void waitForFences() override;
+        void waitForFrameInFlight() override;
+        void waitDeviceIdle() override;
         void resetCommandPool() override;
         void cmdBeginRenderPassPFN(RHICommandBuffer* commandBuffer, const RHIRenderPassBeginInfo* pRenderPassBegin, RHISubpassContents contents) override;
         void cmdBindPipelinePFN(RHICommandBuffer* commandBuffer, RHIPipelineBindPoint pipelineBindPoint, RHIPipeline* pipeline) override;
         void cmdEndRenderPassPFN(RHICommandBuffer* commandBuffer) override;
+        void cmdBindVertexBuffersPFN(RHICommandBuffer* commandBuffer, uint32_t firstBinding, uint32_t bindingCount, RHIBuffer* const* pBuffers, const RHIDeviceSize* pOffsets) override;
+        void cmdBindIndexBufferPFN(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, RHIIndexType indexType) override;
+        void cmdBindDescriptorSetsPFN(RHICommandBuffer* commandBuffer, RHIPipelineBindPoint pipelineBindPoint, RHIPipelineLayout* layout, uint32_t firstSet, uint32_t descriptorSetCount, RHIDescriptorSet* const* pDescriptorSets, uint32_t dynamicOffsetCount, const uint32_t* pDynamicOffsets) override;
+        void cmdPushConstants(RHICommandBuffer* commandBuffer, RHIPipelineLayout* layout, RHIShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* pValues) override;
         void cmdDraw(RHICommandBuffer* commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) override;
+        void cmdDrawIndexed(RHICommandBuffer* commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance) override;
+        void cmdDispatch(RHICommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
+        void cmdDispatchIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset) override;
+        void cmdPipelineBarrier(RHICommandBuffer* commandBuffer, RHIPipelineStageFlags srcStageMask, RHIPipelineStageFlags dstStageMask, RHIDependencyFlags dependencyFlags, uint32_t memoryBarrierCount, const RHIMemoryBarrier* pMemoryBarriers, uint32_t bufferMemoryBarrierCount, const RHIBufferMemoryBarrier* pBufferMemoryBarriers, uint32_t imageMemoryBarrierCount, const RHIImageMemoryBarrier* pImageMemoryBarriers) override;
+        bool allocateFrameDescriptorSet(RHIDescriptorSetLayout* layout, RHIDescriptorSet*& pDescriptorSet) override;
+        void updateDescriptorSets(uint32_t descriptorWriteCount, const RHIWriteDescriptorSet* pDescriptorWrites) override;
+        bool mapMemory(RHIAllocation* allocation, void** ppData) override;
+        void unmapMemory(RHIAllocation* allocation) override;
+        void flushAllocation(RHIAllocation* allocation, RHIDeviceSize offset, RHIDeviceSize size) override;
+        bool readbackPresentedImage(std::vector<uint8_t>& pixels) override;
+
+        // upload
+        uint64_t uploadBuffer(RHIBuffer* dst_buffer, RHIDeviceSize dst_offset, const void* data, RHIDeviceSize size) override;
+        uint64_t uploadImage(RHIImage* dst_image, uint32_t width, uint32_t height, const void* data, RHIDeviceSize size, RHIImageLayout final_layout) override;
+        uint64_t getCompletedUploadTimelineValue() override;
+
+        // async compute
+        RHICommandBuffer* beginAsyncComputeCommandBuffer() override;
+        uint64_t submitAsyncCompute(RHICommandBuffer* command_buffer, uint64_t wait_frame_timeline_value) override;
+        void waitForAsyncComputeInGraphics(uint64_t value, RHIPipelineStageFlags wait_stage) override;
+        uint64_t getCompletedAsyncComputeTimelineValue() override;
+        RHISemaphore* getAsyncComputeTimelineSemaphore() const override { return m_rhi_async_compute_timeline_semaphore; }
+        const QueueFamilyIndices& getQueueFamilyIndices() const override { return m_queue_indices; }
+
+        // sync
+        uint64_t getSubmittedFrameTimelineValue() const override { return m_frame_timeline_value; }
+        uint64_t getCompletedFrameTimelineValue() override;
+        void waitForFrameTimelineValue(uint64_t value) override;
+        RHISemaphore* getFrameTimelineSemaphore() const override { return m_rhi_frame_timeline_semaphore; }
+        void deferRelease(std::function<void()> release) override;
 
         // query
-        RHISwapChainDesc getSwapchainInfo() override;
+        const RHISwapChainDesc& getSwapchainInfo() const override;
+        uint64_t getSwapchainGeneration() const override;
         RHIDepthImageDesc getDepthImageInfo() override;
+        RHIPhysicalDeviceLimits getPhysicalDeviceLimits() override;
         RHICommandBuffer* getCurrentCommandBuffer() const override;
+        RHIPresentModeKHR getPresentMode() const override;
+        uint8_t getFramesInFlight() const override;
+        bool isHeadless() const override { return m_is_headless; }
+        RHIPipelineCache* getPipelineCache() const override;
+        std::vector<RHIMemoryHeapBudget> getMemoryHeapBudgets() override;
+        const std::vector<RHIGpuTiming>& getGpuTimings() const override { return m_gpu_timings; }
+        bool isMemoryPropertySupported(RHIMemoryPropertyFlags property_flags) override;
 
         // destroy
         void destroyDevice() override;
         void destroyImageView(RHIImageView* imageView) override;
         void destroyShaderModule(RHIShader* shaderModule) override;
         void destroyFramebuffer(RHIFramebuffer* framebuffer) override;
+        void destroyRenderPass(RHIRenderPass* renderPass) override;
+        void destroyBuffer(RHIBuffer* buffer, RHIAllocation* allocation) override;
+        void destroyImage(RHIImage* image, RHIAllocation* allocation) override;
 
     public:
-        static uint8_t const k_max_frames_in_flight{ 3 }; // 定义并发处理的帧数
+        static constexpr uint8_t k_max_frames_in_flight{ 3 }; // 并发处理帧数的上限，每帧的同步对象和资源按它分配
 
         GLFWwindow* m_window{ nullptr };
         RHIViewport m_viewport;
         RHIRect2D m_scissor;
         VkSurfaceKHR  m_surface{ nullptr };
         VkPhysicalDevice  m_physical_device{ nullptr };
+        VkPhysicalDeviceProperties m_physical_device_properties{};
         QueueFamilyIndices m_queue_indices;
         VkDevice m_logical_device{ nullptr };
         RHIQueue* m_graphics_queue{ nullptr }; // 基类指针
         VkQueue m_present_queue{ nullptr };
         RHIQueue* m_compute_queue{ nullptr };
+        RHIQueue* m_transfer_queue{ nullptr }; // 没有专用传输队列族时与图形队列是同一个队列
         VkSwapchainKHR m_swapchain{ nullptr };
         std::vector<VkImage> m_swapchain_images;
         RHIFormat m_swapchain_images_format{ RHI_FORMAT_UNDEFINED };
         RHIExtent2D m_swapchain_extend;
         std::vector<RHIImageView*> m_swapchain_imageviews;
+        // 缓存的swapchain描述，只在创建/重建swapchain时更新，查询时按const引用返回避免每次拷贝imageViews
+        RHISwapChainDesc m_swapchain_desc;
+        RHIPresentModeKHR m_requested_present_mode{ RHI_PRESENT_MODE_MAILBOX_KHR };
+        RHIPresentModeKHR m_present_mode{ RHI_PRESENT_MODE_FIFO_KHR }; // 当前swapchain实际使用的模式
+        bool m_is_swapchain_recreate_requested{ false };
+
+        // headless：没有surface，用k_max_frames_in_flight张离屏图像代替swapchain图像，第i帧固定渲染到第i张，不需要acquire
+        bool m_is_headless{ false };
+        std::vector<RHIImage*> m_offscreen_images;
+        std::vector<RHIAllocation*> m_offscreen_image_allocations;
+        // 回读用的CPU可见buffer，按需创建，分辨率变大时重建
+        RHIBuffer* m_readback_buffer{ nullptr };
+        RHIAllocation* m_readback_allocation{ nullptr };
+        RHIDeviceSize m_readback_buffer_size{ 0 };
 
         // depth buffer
         RHIFormat m_depth_image_format{ VK_FORMAT_UNDEFINED };
         RHIImageView* m_depth_image_view = new VulkanImageView();
-        RHIImage* m_depth_image = new VulkanImage();
-        VkDeviceMemory m_depth_image_memory{ nullptr };
+        RHIImage* m_depth_image{ nullptr };
+        RHIAllocation* m_depth_image_allocation{ nullptr };
+
+        // 资源分配器：从大块VkDeviceMemory中子分配buffer/image，避免每个资源一次vkAllocateMemory
+        VmaAllocator m_assets_allocator{ nullptr };
+
+        // 所有pipeline共享的pipeline cache，启动时从磁盘加载，退出时写回
+        RHIPipelineCache* m_pipeline_cache{ nullptr };
+        std::filesystem::path m_pipeline_cache_path;
+
+        // PSO注册表：key为create info及其引用对象的完整内容（按字节比较，不只比较hash），等价的状态直接返回已有的pipeline。
+        // 用shared_future保存，多个线程同时请求同一个状态时只有第一个线程真正编译，其余线程等待结果
+        std::mutex m_graphics_pipeline_registry_mutex;
+        std::unordered_map<std::string, std::shared_future<RHIPipeline*>> m_graphics_pipeline_registry;
+        // layout和sampler缓存：key为create info的完整内容，内容相同的对象只创建一次。
+        // 这些对象都持有到设备销毁，引用它们的key（pipeline layout中的set layout、set layout中的immutable sampler）直接使用句柄
+        std::mutex m_layout_cache_mutex;
+        std::unordered_map<std::string, RHIDescriptorSetLayout*> m_descriptor_set_layout_cache;
+        std::unordered_map<std::string, RHIPipelineLayout*> m_pipeline_layout_cache;
+        std::unordered_map<std::string, RHISampler*> m_sampler_cache;
+        // 计算pipeline的状态很少，不做去重，只记录下来在destroyDevice时销毁
+        std::mutex m_compute_pipelines_mutex;
+        std::vector<RHIPipeline*> m_compute_pipelines;
 
         // command pool and buffers
         RHICommandPool* m_rhi_command_pool;
@@ -90,19 +193,83 @@ namespace Mercury
         VkCommandPool   m_command_pools[k_max_frames_in_flight];
         VkCommandBuffer m_vk_command_buffers[k_max_frames_in_flight];
         VkCommandBuffer m_vk_current_command_buffer;
+        // 并行录制：每个录制线程在每一帧都有自己的command pool，同一个pool只会被一个线程访问，不需要加锁
+        // https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#fundamentals-threadingbehavior
+        struct WorkerCommandPool
+        {
+            VkCommandPool command_pool{ VK_NULL_HANDLE };
+            std::vector<RHICommandBuffer*> secondary_command_buffers; // 已分配的secondary command buffer，按帧复用
+            uint32_t used_secondary_count{ 0 };
+        };
+        uint32_t m_command_recording_worker_count{ 1 };
+        std::vector<WorkerCommandPool> m_worker_command_pools[k_max_frames_in_flight];
         VkSemaphore m_image_available_for_render_semaphores[k_max_frames_in_flight]; // 提示从 swapchain 获取图像并准备渲染
         VkSemaphore m_image_finished_for_presentation_semaphores[k_max_frames_in_flight]; // 提示渲染已完成并可以进行presentation
         RHISemaphore* m_image_available_for_texturescopy_semaphores[k_max_frames_in_flight];// 提示从 swapchain 获取图像并准备纹理拷贝
-        VkFence m_is_frame_in_flight_fences[k_max_frames_in_flight]; // 栅栏来确保一次只渲染一帧图像
-        RHIFence* m_rhi_is_frame_in_flight_fences[k_max_frames_in_flight];
+        // 帧时间线：替代每帧一个fence。swapchain的acquire/present只接受二值信号量，上面两组仍然保留
+        // https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#synchronization-semaphores
+        VkSemaphore m_frame_timeline_semaphore{ VK_NULL_HANDLE };
+        RHISemaphore* m_rhi_frame_timeline_semaphore{ nullptr };
+        uint64_t m_frame_timeline_value{ 0 }; // 最近一次提交的帧signal的值
+        uint64_t m_frame_slot_timeline_values[k_max_frames_in_flight]{}; // 每个帧槽位最近一次提交signal的值，复用槽位前等待它
+        struct DeferredRelease
+        {
+            uint64_t timeline_value; // GPU完成这个值之后才能释放
+            std::function<void()> release;
+        };
+        std::deque<DeferredRelease> m_deferred_releases; // 按timeline_value递增排列
+
+        // async compute：计算队列每帧一个command pool，command buffer按帧复用；计算时间线在每次submitAsyncCompute时递增
+        VkCommandPool m_async_compute_command_pools[k_max_frames_in_flight];
+        std::vector<RHICommandBuffer*> m_async_compute_command_buffers[k_max_frames_in_flight];
+        uint32_t m_used_async_compute_command_buffer_counts[k_max_frames_in_flight]{};
+        VkSemaphore m_async_compute_timeline_semaphore{ VK_NULL_HANDLE };
+        RHISemaphore* m_rhi_async_compute_timeline_semaphore{ nullptr };
+        uint64_t m_async_compute_timeline_value{ 0 };
+        uint64_t m_frame_slot_async_compute_values[k_max_frames_in_flight]{}; // 每个帧槽位最近一次计算提交的值，复用槽位前同样需要等待
+        uint64_t m_graphics_async_compute_wait_value{ 0 }; // 当前帧图形提交需要等待的计算时间线值，0表示不等待
+        VkPipelineStageFlags m_graphics_async_compute_wait_stages{ 0 };
+
+        // 每帧的描述符池链，在resetCommandPool中随这一帧的command pool一起重置
+        VulkanDescriptorAllocator m_descriptor_allocator;
+
+        // 传输队列上传：每帧在prepareBeforePass中提交一次，这一帧的图形提交等待m_upload_wait_value
+        VulkanUploadManager m_upload_manager;
+        uint64_t m_upload_wait_value{ 0 };
+        uint8_t m_frames_in_flight{ k_max_frames_in_flight }; // 实际并发处理的帧数，m_current_frame_index在[0, m_frames_in_flight)中循环
         uint8_t m_current_frame_index{ 0 };
         uint32_t m_current_swapchain_image_index{ 0 }; // todo set
 
+        // GPU计时：pushEvent/popEvent在当前帧的主命令缓冲区中写入开始/结束timestamp，
+        // 等这一帧的fence下次被等待之后（frames in flight帧之后）再读回结果，不会让CPU等待GPU
+        // https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#queries-timestamps
+        static constexpr uint32_t k_max_gpu_timestamp_count{ 256 }; // 每帧的timestamp数量上限，每个区间占两个
+        struct GpuTimestampRegion
+        {
+            const char* name; // pushEvent传入的名字，要求生命周期到程序结束，不做拷贝
+            uint32_t depth;
+            uint32_t begin_query; // 结束timestamp紧跟在后面
+        };
+        struct GpuTimestampFrame
+        {
+            VkQueryPool query_pool{ VK_NULL_HANDLE };
+            uint32_t query_count{ 0 };
+            std::vector<GpuTimestampRegion> regions;
+            int64_t cpu_submit_time{ 0 }; // 提交时的分析器时间，用于把GPU区间近似对齐到CPU时间线
+        };
+        GpuTimestampFrame m_gpu_timestamp_frames[k_max_frames_in_flight];
+        std::vector<uint32_t> m_open_gpu_regions; // 当前帧还没有pop的区间，超出上限的区间记为UINT32_MAX
+        std::vector<uint64_t> m_gpu_timestamp_results;
+        std::vector<RHIGpuTiming> m_gpu_timings;
+        bool m_is_gpu_timestamp_supported{ false };
+        float m_timestamp_period{ 1.f }; // 每个tick的纳秒数
+        uint64_t m_timestamp_mask{ ~0ull };
+
         // function pointers
         PFN_vkCmdBeginDebugUtilsLabelEXT _vkCmdBeginDebugUtilsLabelEXT;
         PFN_vkCmdEndDebugUtilsLabelEXT   _vkCmdEndDebugUtilsLabelEXT;
-        PFN_vkWaitForFences         _vkWaitForFences;
-        PFN_vkResetFences           _vkResetFences;
+        PFN_vkWaitSemaphores        _vkWaitSemaphores;
+        PFN_vkGetSemaphoreCounterValue _vkGetSemaphoreCounterValue;
         PFN_vkResetCommandPool      _vkResetCommandPool;
         PFN_vkBeginCommandBuffer    _vkBeginCommandBuffer;
         PFN_vkEndCommandBuffer      _vkEndCommandBuffer;
@@ -117,33 +284,53 @@ namespace Mercury
         PFN_vkCmdBindDescriptorSets _vkCmdBindDescriptorSets;
         PFN_vkCmdDrawIndexed        _vkCmdDrawIndexed;
         PFN_vkCmdClearAttachments   _vkCmdClearAttachments;
+        PFN_vkCmdExecuteCommands    _vkCmdExecuteCommands;
+        PFN_vkCmdWriteTimestamp     _vkCmdWriteTimestamp;
+        PFN_vkCmdResetQueryPool     _vkCmdResetQueryPool;
 
 
     private:
         bool m_enable_validation_layers{ true };
         bool m_enable_debug_utils_label{ true };
+        bool m_enable_memory_budget{ false }; // 是否启用VK_EXT_memory_budget，由VMA查询驱动报告的显存预算
         VkDebugUtilsMessengerEXT m_debug_messager = nullptr;
         void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo);
         VkResult createDebugUtilsMessengerEXT(VkInstance instance,
             const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo,
             const VkAllocationCallbacks* pAllocator,
             VkDebugUtilsMessengerEXT* pDebugMessenger);
+        void destroyDebugUtilsMessengerEXT(VkInstance instance,
+            VkDebugUtilsMessengerEXT debugMessenger,
+            const VkAllocationCallbacks* pAllocator);
 
 
         void createInstance();
         void initializeDebugMessenger();
         void createWindowSurface();
+        void createOffscreenImages();
+        void destroySwapchainImages();
         void initializePhysicalDevice();
         void createLogicalDevice();
         void createCommandPool() override;
         void createCommandBuffers();
         void createDescriptorPool();
         void createSyncPrimitives();
+        void createAsyncComputeResources();
+        void waitForAsyncComputeTimelineValue(uint64_t value);
+        void createGpuTimestampQueryPools();
+        void resolveGpuTimestamps();
+        bool isCurrentPrimaryCommandBuffer(RHICommandBuffer* command_buffer) const;
         void createAssetAllocator();
+        void createPipelineCache();
+        std::string makeGraphicsPipelineKey(const RHIGraphicsPipelineCreateInfo* pCreateInfo);
+        bool compileGraphicsPipeline(RHIPipelineCache* pipelineCache, const RHIGraphicsPipelineCreateInfo* pCreateInfo, RHIPipeline*& pPipeline);
+        void updateSwapchainDesc();
         std::vector<const char*> getRequiredExtensions();
         bool isDeviceSuitable(VkPhysicalDevice physical_device);
         QueueFamilyIndices VulkanRHI::findQueueFamilies(VkPhysicalDevice physical_device);
         bool checkDeviceExtensionSupport(VkPhysicalDevice physical_device);
+        bool isInstanceExtensionSupported(const char* extension_name);
+        bool isDeviceExtensionSupported(VkPhysicalDevice physical_device, const char* extension_name);
         SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice physical_device);
         VkSurfaceFormatKHR chooseSwapChainSurfaceFormatFromDetails(const std::vector<VkSurfaceFormatKHR>& available_surface_formats);
         VkPresentModeKHR chooseSwapchainPresentModeFromDetails(const std::vector<VkPresentModeKHR>& available_present_modes);
@@ -2,8 +2,11 @@
 
 #include "runtime/function/render/interface/rhi_struct.h"
 
+#include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
+#include <string>
+
 namespace Mercury
 {
 
@@ -21,6 +24,20 @@ namespace Mercury
     private:
         VkQueue m_resource;
     };
+    class VulkanBuffer : public RHIBuffer
+    {
+    public:
+        void setResource(VkBuffer res)
+        {
+            m_resource = res;
+        }
+        VkBuffer getResource() const
+        {
+            return m_resource;
+        }
+    private:
+        VkBuffer m_resource;
+    };
     class VulkanImage : public RHIImage
     {
     public:
@@ -61,8 +78,32 @@ namespace Mercury
         {
             return m_resource;
         }
+        // shader字节码，作为PSO注册表key的一部分按内容比较
+        void setKey(std::string key)
+        {
+            m_key = std::move(key);
+        }
+        const std::string& getKey() const
+        {
+            return m_key;
+        }
     private:
         VkShaderModule m_resource;
+        std::string m_key;
+    };
+    class VulkanSampler : public RHISampler
+    {
+    public:
+        void setResource(VkSampler res)
+        {
+            m_resource = res;
+        }
+        VkSampler getResource() const
+        {
+            return m_resource;
+        }
+    private:
+        VkSampler m_resource;
     };
     class VulkanDescriptorSetLayout :public RHIDescriptorSetLayout
     {
@@ -76,6 +117,18 @@ namespace Mercury
     private:
         VkDescriptorSetLayout m_resource;
     };
+    class VulkanDescriptorSet :public RHIDescriptorSet
+    {
+    public:
+        void setResource(VkDescriptorSet res) {
+            m_resource = res;
+        }
+        VkDescriptorSet getResource() const {
+            return m_resource;
+        }
+    private:
+        VkDescriptorSet m_resource;
+    };
     class VulkanPipelineLayout :public RHIPipelineLayout
     {
     public:
@@ -99,8 +152,18 @@ namespace Mercury
         {
             return m_resource;
         }
+        // render pass兼容性key，兼容的render pass可以共用同一个pipeline
+        void setKey(std::string key)
+        {
+            m_key = std::move(key);
+        }
+        const std::string& getKey() const
+        {
+            return m_key;
+        }
     private:
         VkRenderPass m_resource;
+        std::string m_key;
     };
     class VulkanFramebuffer : public RHIFramebuffer
     {
@@ -201,4 +264,18 @@ namespace Mercury
     private:
         VkFence m_resource;
     };
+    class VulkanAllocation : public RHIAllocation
+    {
+    public:
+        void setResource(VmaAllocation res)
+        {
+            m_resource = res;
+        }
+        VmaAllocation getResource() const
+        {
+            return m_resource;
+        }
+    private:
+        VmaAllocation m_resource;
+    };
 } // namespace Mercury
@@ -0,0 +1,450 @@
+#include "runtime/function/render/interface/vulkan/vulkan_upload_manager.h"
+#include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace Mercury
+{
+    namespace
+    {
+        // 暂存区间的对齐：满足vkCmdCopyBufferToImage要求的4字节对齐，并覆盖常见格式的texel大小
+        constexpr VkDeviceSize k_staging_alignment = 16;
+
+        // 图形队列acquire之后这些资源可能以任意方式被读取
+        constexpr VkAccessFlags k_buffer_read_access = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+            VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+        constexpr VkAccessFlags k_image_read_access = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+    } // namespace
+
+    void VulkanUploadManager::initialize(VulkanRHI* rhi)
+    {
+        m_rhi = rhi;
+        m_device = rhi->m_logical_device;
+        m_graphics_family = rhi->m_queue_indices.graphics_family.value();
+        m_transfer_family = rhi->m_queue_indices.transfer_family.value();
+        m_transfer_queue = ((VulkanQueue*)rhi->m_transfer_queue)->getResource();
+
+        // 批次的命令缓冲区在GPU完成后复用，begin时隐式重置
+        VkCommandPoolCreateInfo command_pool_create_info{};
+        command_pool_create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        command_pool_create_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        command_pool_create_info.queueFamilyIndex = m_transfer_family;
+        if (vkCreateCommandPool(m_device, &command_pool_create_info, nullptr, &m_command_pool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create upload command pool!");
+        }
+
+        VkSemaphoreTypeCreateInfo semaphore_type_create_info{};
+        semaphore_type_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        semaphore_type_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        semaphore_type_create_info.initialValue = 0;
+        VkSemaphoreCreateInfo semaphore_create_info{};
+        semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphore_create_info.pNext = &semaphore_type_create_info;
+        if (vkCreateSemaphore(m_device, &semaphore_create_info, nullptr, &m_timeline_semaphore) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create upload timeline semaphore!");
+        }
+
+        // 与全局上传环形缓冲区相同：持久映射、HOST_COHERENT，CPU写入后无需flush
+        RHIBufferCreateInfo buffer_create_info{};
+        buffer_create_info.sType = RHI_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_create_info.size = k_staging_ring_size;
+        buffer_create_info.usage = RHI_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        buffer_create_info.sharingMode = RHI_SHARING_MODE_EXCLUSIVE;
+
+        RHIAllocationCreateInfo allocation_create_info{};
+        allocation_create_info.flags = RHI_ALLOCATION_CREATE_MAPPED_BIT | RHI_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+        allocation_create_info.usage = RHI_MEMORY_USAGE_AUTO;
+        allocation_create_info.requiredFlags = RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+        RHIAllocationInfo allocation_info{};
+        m_rhi->createBuffer(&buffer_create_info, &allocation_create_info, m_staging_ring, m_staging_ring_allocation, &allocation_info);
+        m_staging_ring_memory_pointer = allocation_info.pMappedData;
+
+        std::cout << "create upload manager success! dedicated transfer queue: " << (isDedicatedTransferQueue() ? "yes" : "no") << std::endl;
+    }
+
+    void VulkanUploadManager::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        waitForValue(m_submitted_value);
+        retireCompletedBatches(m_submitted_value);
+
+        // 录制中但没有提交的批次直接丢弃，命令缓冲区随command pool一起释放
+        for (size_t i = 0; i < m_recording_batch.dedicated_staging_buffers.size(); ++i)
+        {
+            m_rhi->destroyBuffer(m_recording_batch.dedicated_staging_buffers[i], m_recording_batch.dedicated_staging_allocations[i]);
+        }
+        m_recording_batch = UploadBatch{};
+        m_free_command_buffers.clear();
+
+        if (m_staging_ring != nullptr)
+        {
+            m_rhi->destroyBuffer(m_staging_ring, m_staging_ring_allocation);
+            m_staging_ring = nullptr;
+            m_staging_ring_allocation = nullptr;
+            m_staging_ring_memory_pointer = nullptr;
+        }
+        vkDestroySemaphore(m_device, m_timeline_semaphore, nullptr);
+        m_timeline_semaphore = VK_NULL_HANDLE;
+        vkDestroyCommandPool(m_device, m_command_pool, nullptr);
+        m_command_pool = VK_NULL_HANDLE;
+    }
+
+    uint64_t VulkanUploadManager::uploadBuffer(RHIBuffer* dst_buffer, RHIDeviceSize dst_offset, const void* data, RHIDeviceSize size)
+    {
+        if (size == 0)
+        {
+            return 0;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        StagingAllocation staging = allocateStaging(size, k_staging_alignment);
+        memcpy(staging.mapped_data, data, static_cast<size_t>(size));
+
+        VkBuffer vk_dst_buffer = ((VulkanBuffer*)dst_buffer)->getResource();
+        VkBufferCopy copy_region{};
+        copy_region.srcOffset = staging.offset;
+        copy_region.dstOffset = dst_offset;
+        copy_region.size = size;
+        vkCmdCopyBuffer(getRecordingCommandBuffer(), staging.buffer, vk_dst_buffer, 1, &copy_region);
+
+        // 同一队列族时信号量的signal/wait已经保证了可见性，buffer不需要额外的屏障
+        if (isDedicatedTransferQueue())
+        {
+            VkBufferMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = 0;
+            barrier.srcQueueFamilyIndex = m_transfer_family;
+            barrier.dstQueueFamilyIndex = m_graphics_family;
+            barrier.buffer = vk_dst_buffer;
+            barrier.offset = dst_offset;
+            barrier.size = size;
+            m_recording_batch.release_buffer_barriers.push_back(barrier);
+
+            // acquire与release的队列族和范围必须一致，访问掩码各自只描述本队列一侧
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = k_buffer_read_access;
+            m_recording_batch.acquire_buffer_barriers.push_back(barrier);
+        }
+        return m_submitted_value + 1;
+    }
+
+    uint64_t VulkanUploadManager::uploadImage(RHIImage* dst_image, uint32_t width, uint32_t height, const void* data, RHIDeviceSize size, RHIImageLayout final_layout)
+    {
+        if (size == 0)
+        {
+            return 0;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        StagingAllocation staging = allocateStaging(size, k_staging_alignment);
+        memcpy(staging.mapped_data, data, static_cast<size_t>(size));
+
+        VkCommandBuffer command_buffer = getRecordingCommandBuffer();
+        VkImage vk_dst_image = ((VulkanImage*)dst_image)->getResource();
+
+        // 原有内容丢弃，从UNDEFINED转换到拷贝目标布局
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = vk_dst_image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+        vkCmdPipelineBarrier(command_buffer,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        // bufferRowLength和bufferImageHeight为0表示texel紧密排列
+        VkBufferImageCopy copy_region{};
+        copy_region.bufferOffset = staging.offset;
+        copy_region.bufferRowLength = 0;
+        copy_region.bufferImageHeight = 0;
+        copy_region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copy_region.imageSubresource.mipLevel = 0;
+        copy_region.imageSubresource.baseArrayLayer = 0;
+        copy_region.imageSubresource.layerCount = 1;
+        copy_region.imageOffset = { 0, 0, 0 };
+        copy_region.imageExtent = { width, height, 1 };
+        vkCmdCopyBufferToImage(command_buffer, staging.buffer, vk_dst_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy_region);
+
+        // 拷贝之后转换到final_layout；不同队列族时这个布局转换同时是所有权的release，图形队列acquire时使用相同的布局
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = (VkImageLayout)final_layout;
+        if (isDedicatedTransferQueue())
+        {
+            barrier.srcQueueFamilyIndex = m_transfer_family;
+            barrier.dstQueueFamilyIndex = m_graphics_family;
+        }
+        m_recording_batch.release_image_barriers.push_back(barrier);
+
+        if (isDedicatedTransferQueue())
+        {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = k_image_read_access;
+            m_recording_batch.acquire_image_barriers.push_back(barrier);
+        }
+        return m_submitted_value + 1;
+    }
+
+    uint64_t VulkanUploadManager::flush(VkCommandBuffer graphics_command_buffer)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        retireCompletedBatches(getCompletedValue());
+
+        UploadBatch& batch = m_recording_batch;
+        if (batch.command_buffer == VK_NULL_HANDLE)
+        {
+            return 0;
+        }
+
+        if (!batch.release_buffer_barriers.empty() || !batch.release_image_barriers.empty())
+        {
+            vkCmdPipelineBarrier(batch.command_buffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                0,
+                0, nullptr,
+                static_cast<uint32_t>(batch.release_buffer_barriers.size()), batch.release_buffer_barriers.data(),
+                static_cast<uint32_t>(batch.release_image_barriers.size()), batch.release_image_barriers.data());
+        }
+        if (vkEndCommandBuffer(batch.command_buffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("vkEndCommandBuffer failed!");
+        }
+
+        batch.timeline_value = m_submitted_value + 1;
+        VkTimelineSemaphoreSubmitInfo timeline_submit_info{};
+        timeline_submit_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timeline_submit_info.signalSemaphoreValueCount = 1;
+        timeline_submit_info.pSignalSemaphoreValues = &batch.timeline_value;
+
+        VkSubmitInfo submit_info{};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.pNext = &timeline_submit_info;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &batch.command_buffer;
+        submit_info.signalSemaphoreCount = 1;
+        submit_info.pSignalSemaphores = &m_timeline_semaphore;
+        if (vkQueueSubmit(m_transfer_queue, 1, &submit_info, VK_NULL_HANDLE) != VK_SUCCESS)
+        {
+            throw std::runtime_error("upload vkQueueSubmit failed!");
+        }
+        m_submitted_value = batch.timeline_value;
+
+        // 图形队列的提交会等待上传时间线，acquire之后这一帧的所有命令都能看到上传的数据
+        if (!batch.acquire_buffer_barriers.empty() || !batch.acquire_image_barriers.empty())
+        {
+            vkCmdPipelineBarrier(graphics_command_buffer,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                0,
+                0, nullptr,
+                static_cast<uint32_t>(batch.acquire_buffer_barriers.size()), batch.acquire_buffer_barriers.data(),
+                static_cast<uint32_t>(batch.acquire_image_barriers.size()), batch.acquire_image_barriers.data());
+        }
+
+        batch.staging_ring_end = m_staging_ring_tail;
+        batch.release_buffer_barriers.clear();
+        batch.release_image_barriers.clear();
+        batch.acquire_buffer_barriers.clear();
+        batch.acquire_image_barriers.clear();
+        m_submitted_batches.push_back(std::move(batch));
+        m_recording_batch = UploadBatch{};
+        return m_submitted_value;
+    }
+
+    uint64_t VulkanUploadManager::getCompletedValue()
+    {
+        uint64_t value = 0;
+        if (vkGetSemaphoreCounterValue(m_device, m_timeline_semaphore, &value) != VK_SUCCESS)
+        {
+            throw std::runtime_error("vkGetSemaphoreCounterValue failed!");
+        }
+        return value;
+    }
+
+    VulkanUploadManager::StagingAllocation VulkanUploadManager::allocateStaging(VkDeviceSize size, VkDeviceSize alignment)
+    {
+        StagingAllocation allocation;
+        if (size <= k_staging_ring_size)
+        {
+            for (;;)
+            {
+                VkDeviceSize offset = 0;
+                if (tryAllocateStagingRing(size, alignment, offset))
+                {
+                    allocation.buffer = ((VulkanBuffer*)m_staging_ring)->getResource();
+                    allocation.offset = offset;
+                    allocation.mapped_data = static_cast<uint8_t*>(m_staging_ring_memory_pointer) + offset;
+                    return allocation;
+                }
+                // 空间被已提交的批次占用时等待最早的批次完成；剩下的都属于录制中的批次时只能改用临时buffer
+                if (m_submitted_batches.empty())
+                {
+                    break;
+                }
+                waitForValue(m_submitted_batches.front().timeline_value);
+                retireCompletedBatches(getCompletedValue());
+            }
+        }
+
+        // 临时暂存buffer，随批次完成一起销毁
+        RHIBufferCreateInfo buffer_create_info{};
+        buffer_create_info.sType = RHI_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_create_info.size = size;
+        buffer_create_info.usage = RHI_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        buffer_create_info.sharingMode = RHI_SHARING_MODE_EXCLUSIVE;
+
+        RHIAllocationCreateInfo allocation_create_info{};
+        allocation_create_info.flags = RHI_ALLOCATION_CREATE_MAPPED_BIT | RHI_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+        allocation_create_info.usage = RHI_MEMORY_USAGE_AUTO;
+        allocation_create_info.requiredFlags = RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+        RHIBuffer* buffer = nullptr;
+        RHIAllocation* buffer_allocation = nullptr;
+        RHIAllocationInfo allocation_info{};
+        m_rhi->createBuffer(&buffer_create_info, &allocation_create_info, buffer, buffer_allocation, &allocation_info);
+        m_recording_batch.dedicated_staging_buffers.push_back(buffer);
+        m_recording_batch.dedicated_staging_allocations.push_back(buffer_allocation);
+
+        allocation.buffer = ((VulkanBuffer*)buffer)->getResource();
+        allocation.offset = 0;
+        allocation.mapped_data = allocation_info.pMappedData;
+        return allocation;
+    }
+
+    bool VulkanUploadManager::tryAllocateStagingRing(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset)
+    {
+        bool is_empty = !m_recording_batch.has_staging_ring_allocation;
+        for (const UploadBatch& batch : m_submitted_batches)
+        {
+            is_empty = is_empty && !batch.has_staging_ring_allocation;
+        }
+        if (is_empty)
+        {
+            m_staging_ring_head = 0;
+            m_staging_ring_tail = 0;
+        }
+
+        const VkDeviceSize aligned_tail = (m_staging_ring_tail + alignment - 1) / alignment * alignment;
+        if (is_empty || m_staging_ring_tail > m_staging_ring_head)
+        {
+            // 空闲区间为[tail, size)和[0, head)：尾部放不下时绕回起点，尾部剩余的空间跳过
+            if (aligned_tail + size <= k_staging_ring_size)
+            {
+                offset = aligned_tail;
+            }
+            else if (size <= m_staging_ring_head)
+            {
+                offset = 0;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        else
+        {
+            // 已经绕回：空闲区间为[tail, head)
+            if (aligned_tail + size <= m_staging_ring_head)
+            {
+                offset = aligned_tail;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        m_staging_ring_tail = offset + size;
+        m_recording_batch.has_staging_ring_allocation = true;
+        return true;
+    }
+
+    VkCommandBuffer VulkanUploadManager::getRecordingCommandBuffer()
+    {
+        if (m_recording_batch.command_buffer != VK_NULL_HANDLE)
+        {
+            return m_recording_batch.command_buffer;
+        }
+
+        VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+        if (!m_free_command_buffers.empty())
+        {
+            command_buffer = m_free_command_buffers.back();
+            m_free_command_buffers.pop_back();
+        }
+        else
+        {
+            VkCommandBufferAllocateInfo command_buffer_allocate_info{};
+            command_buffer_allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            command_buffer_allocate_info.commandPool = m_command_pool;
+            command_buffer_allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            command_buffer_allocate_info.commandBufferCount = 1;
+            if (vkAllocateCommandBuffers(m_device, &command_buffer_allocate_info, &command_buffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to allocate upload command buffer!");
+            }
+        }
+
+        VkCommandBufferBeginInfo command_buffer_begin_info{};
+        command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        command_buffer_begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (vkBeginCommandBuffer(command_buffer, &command_buffer_begin_info) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to begin upload command buffer!");
+        }
+        m_recording_batch.command_buffer = command_buffer;
+        return command_buffer;
+    }
+
+    void VulkanUploadManager::retireCompletedBatches(uint64_t completed_value)
+    {
+        while (!m_submitted_batches.empty() && m_submitted_batches.front().timeline_value <= completed_value)
+        {
+            UploadBatch& batch = m_submitted_batches.front();
+            m_free_command_buffers.push_back(batch.command_buffer);
+            // 批次按提交顺序完成，这个批次之前分配的暂存区间都已不再使用
+            m_staging_ring_head = batch.staging_ring_end;
+            for (size_t i = 0; i < batch.dedicated_staging_buffers.size(); ++i)
+            {
+                m_rhi->destroyBuffer(batch.dedicated_staging_buffers[i], batch.dedicated_staging_allocations[i]);
+            }
+            m_submitted_batches.pop_front();
+        }
+    }
+
+    // https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#vkWaitSemaphores
+    void VulkanUploadManager::waitForValue(uint64_t value)
+    {
+        if (value == 0)
+        {
+            return;
+        }
+        VkSemaphoreWaitInfo wait_info{};
+        wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        wait_info.semaphoreCount = 1;
+        wait_info.pSemaphores = &m_timeline_semaphore;
+        wait_info.pValues = &value;
+        if (vkWaitSemaphores(m_device, &wait_info, UINT64_MAX) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to wait for uploads!");
+        }
+    }
+} // namespace Mercury
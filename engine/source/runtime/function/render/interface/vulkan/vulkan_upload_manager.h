@@ -0,0 +1,99 @@
+#pragma once
+
+#include "runtime/function/render/interface/rhi.h"
+
+#include <vulkan/vulkan.h>
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace Mercury
+{
+    class VulkanRHI;
+
+    /*
+    * 上传管理器：把CPU数据经由暂存（staging）缓冲区拷贝到GPU本地的buffer/image。
+    * • 优先使用只支持传输的专用队列族（通常对应GPU上的DMA引擎），拷贝与图形队列上的渲染并行执行；没有时退化为图形队列族
+    * • 暂存内存从一个持久映射的大环形缓冲区中子分配，批次在GPU上完成后回收对应的区间；超过环形缓冲区容量的上传单独创建临时buffer
+    * • 任意线程都可以发起上传，拷贝命令录制到当前批次的命令缓冲区中；渲染线程每帧调用一次flush，把整个批次合并为一次提交
+    * • 完成情况用上传时间线（timeline semaphore）表示：每个批次signal一个递增的值，图形队列在同一帧的提交中等待这个值
+    * • 传输队列族与图形队列族不同时，目标资源需要做队列族所有权转移：传输队列release，图形队列在这一帧开头acquire
+    * https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#synchronization-queue-transfers
+    *
+    * 目标资源需要以EXCLUSIVE共享模式创建并带有TRANSFER_DST用途，上传时其原有内容会被丢弃（新创建的资源，或者不再被GPU使用的资源）。
+    */
+    class VulkanUploadManager
+    {
+    public:
+        static VkDeviceSize const k_staging_ring_size{ 1024 * 1024 * 64 };
+
+        void initialize(VulkanRHI* rhi);
+        void clear();
+
+        // 返回上传完成时上传时间线到达的值，与getCompletedValue比较即可知道是否完成，也可以交给其他队列等待
+        uint64_t uploadBuffer(RHIBuffer* dst_buffer, RHIDeviceSize dst_offset, const void* data, RHIDeviceSize size);
+        // 只上传第0层mip、第0个array layer；data为紧密排列的texel，上传后图像处于final_layout
+        uint64_t uploadImage(RHIImage* dst_image, uint32_t width, uint32_t height, const void* data, RHIDeviceSize size, RHIImageLayout final_layout);
+
+        // 只能在渲染线程调用：提交当前批次，并把所有权acquire屏障录制到graphics_command_buffer的当前位置。
+        // 返回图形队列提交时需要等待的上传时间线值，没有待提交的上传时返回0
+        uint64_t flush(VkCommandBuffer graphics_command_buffer);
+        uint64_t getCompletedValue();
+        VkSemaphore getTimelineSemaphore() const { return m_timeline_semaphore; }
+        bool isDedicatedTransferQueue() const { return m_transfer_family != m_graphics_family; }
+
+    private:
+        struct StagingAllocation
+        {
+            VkBuffer buffer{ VK_NULL_HANDLE };
+            VkDeviceSize offset{ 0 };
+            void* mapped_data{ nullptr };
+        };
+
+        // 一次提交：录制中的批次只有一个，提交后进入m_submitted_batches，GPU完成后回收命令缓冲区和暂存内存
+        struct UploadBatch
+        {
+            uint64_t timeline_value{ 0 };
+            VkCommandBuffer command_buffer{ VK_NULL_HANDLE };
+            bool has_staging_ring_allocation{ false };
+            VkDeviceSize staging_ring_end{ 0 }; // 提交时环形缓冲区的尾部，批次完成后头部前进到这里
+            std::vector<RHIBuffer*> dedicated_staging_buffers;
+            std::vector<RHIAllocation*> dedicated_staging_allocations;
+            // 拷贝之后的屏障在提交前一次性录制：release（或同一队列族时的布局转换）在传输队列，acquire在图形队列
+            std::vector<VkBufferMemoryBarrier> release_buffer_barriers;
+            std::vector<VkImageMemoryBarrier> release_image_barriers;
+            std::vector<VkBufferMemoryBarrier> acquire_buffer_barriers;
+            std::vector<VkImageMemoryBarrier> acquire_image_barriers;
+        };
+
+        // 以下函数需要持有m_mutex
+        StagingAllocation allocateStaging(VkDeviceSize size, VkDeviceSize alignment);
+        bool tryAllocateStagingRing(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset);
+        VkCommandBuffer getRecordingCommandBuffer();
+        void retireCompletedBatches(uint64_t completed_value);
+        void waitForValue(uint64_t value);
+
+        VulkanRHI* m_rhi{ nullptr };
+        VkDevice m_device{ VK_NULL_HANDLE };
+        uint32_t m_transfer_family{ 0 };
+        uint32_t m_graphics_family{ 0 };
+        VkQueue m_transfer_queue{ VK_NULL_HANDLE };
+        VkCommandPool m_command_pool{ VK_NULL_HANDLE };
+        std::vector<VkCommandBuffer> m_free_command_buffers;
+
+        VkSemaphore m_timeline_semaphore{ VK_NULL_HANDLE };
+        uint64_t m_submitted_value{ 0 }; // 录制中的批次会以m_submitted_value + 1提交
+
+        // 暂存环形缓冲区：[head, tail)之间（可能绕回）是尚未完成的批次在使用的区间
+        RHIBuffer* m_staging_ring{ nullptr };
+        RHIAllocation* m_staging_ring_allocation{ nullptr };
+        void* m_staging_ring_memory_pointer{ nullptr };
+        VkDeviceSize m_staging_ring_head{ 0 };
+        VkDeviceSize m_staging_ring_tail{ 0 };
+
+        std::mutex m_mutex;
+        UploadBatch m_recording_batch;
+        std::deque<UploadBatch> m_submitted_batches;
+    };
+} // namespace Mercury
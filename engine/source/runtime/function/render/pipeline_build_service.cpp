@@ -0,0 +1,19 @@
+#include "runtime/function/render/pipeline_build_service.h"
+
+namespace Mercury
+{
+    void PipelineBuildService::initialize(std::shared_ptr<JobSystem> job_system)
+    {
+        m_job_system = job_system;
+    }
+
+    void PipelineBuildService::clear()
+    {
+        // 任务中还可能继续提交任务（例如派生pipeline），计数器归零时它们都已执行完
+        if (m_job_system)
+        {
+            m_job_system->wait(m_counter);
+            m_job_system.reset();
+        }
+    }
+} // namespace Mercury
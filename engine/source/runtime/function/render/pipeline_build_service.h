@@ -0,0 +1,39 @@
+#pragma once
+
+#include <future>
+#include <memory>
+
+#include "runtime/core/job/job_system.h"
+
+namespace Mercury
+{
+    /*
+    * pipeline编译服务：在任务系统的线程上创建shader module、pipeline layout和pipeline，返回future。
+    * 编译任务作为普通job提交，与其他job共用同一组线程，不额外创建线程池。
+    * vkCreateGraphicsPipelines对同一个device可以并发调用，共享的VkPipelineCache默认是内部同步的，
+    * 因此多个pipeline可以同时编译，主线程可以在此期间继续初始化其他资源，需要使用pipeline时再等待future。
+    * 提交的任务负责保证其中用到的create info在任务执行期间有效（通常直接在任务中构造）。
+    */
+    class PipelineBuildService
+    {
+    public:
+        void initialize(std::shared_ptr<JobSystem> job_system);
+        // 等待所有已提交的任务执行完，保证所有future都能就绪；必须在主线程调用
+        void clear();
+
+        template<typename Function>
+        auto submit(Function&& function) -> std::future<decltype(function())>
+        {
+            using ResultType = decltype(function());
+            auto task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<Function>(function));
+            std::future<ResultType> future = task->get_future();
+            m_job_system->run([task]() { (*task)(); }, &m_counter);
+            return future;
+        }
+
+    private:
+        std::shared_ptr<JobSystem> m_job_system;
+        // 所有已提交、尚未执行完的任务
+        JobCounter m_counter;
+    };
+} // namespace Mercury
@@ -0,0 +1,51 @@
+#include "runtime/function/render/render_camera.h"
+
+#include <cmath>
+
+namespace Mercury
+{
+    void RenderCamera::tick(float delta_time)
+    {
+        const float two_pi = 6.2831853f;
+        m_yaw = std::fmod(m_yaw + m_yaw_speed * delta_time, two_pi);
+    }
+
+    void RenderCamera::getProjViewMatrix(float proj_view_matrix[16]) const
+    {
+        const Vector3 up(0.f, 1.f, 0.f);
+        const Vector3 eye = m_target + Vector3(std::cos(m_pitch) * std::sin(m_yaw), std::sin(m_pitch), std::cos(m_pitch) * std::cos(m_yaw)) * m_distance;
+
+        // 右手坐标系的look at：相机看向-z
+        const Vector3 forward = (m_target - eye).normalisedCopy();
+        const Vector3 side = forward.crossProduct(up).normalisedCopy();
+        const Vector3 camera_up = side.crossProduct(forward);
+        const float view[4][4] = {
+            { side.x, side.y, side.z, -side.dotProduct(eye) },
+            { camera_up.x, camera_up.y, camera_up.z, -camera_up.dotProduct(eye) },
+            { -forward.x, -forward.y, -forward.z, forward.dotProduct(eye) },
+            { 0.f, 0.f, 0.f, 1.f },
+        };
+
+        // 透视投影，y取反使屏幕上方为+y，深度映射到[0, 1]
+        const float tan_half_fovy = std::tan(m_fovy * 0.5f);
+        float projection[4][4] = {};
+        projection[0][0] = 1.f / (m_aspect_ratio * tan_half_fovy);
+        projection[1][1] = -1.f / tan_half_fovy;
+        projection[2][2] = m_z_far / (m_z_near - m_z_far);
+        projection[2][3] = m_z_far * m_z_near / (m_z_near - m_z_far);
+        projection[3][2] = -1.f;
+
+        for (int column = 0; column < 4; ++column)
+        {
+            for (int row = 0; row < 4; ++row)
+            {
+                float value = 0.f;
+                for (int k = 0; k < 4; ++k)
+                {
+                    value += projection[row][k] * view[k][column];
+                }
+                proj_view_matrix[column * 4 + row] = value;
+            }
+        }
+    }
+} // namespace Mercury
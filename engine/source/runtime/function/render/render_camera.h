@@ -0,0 +1,30 @@
+#pragma once
+
+#include "runtime/core/math/vector3.h"
+
+namespace Mercury
+{
+    /*
+    * 逻辑侧的相机：绕目标点匀速旋转的轨道相机，由逻辑tick更新，结果写入render proxy快照交给渲染侧。
+    * 世界空间y轴向上；投影矩阵按Vulkan的裁剪空间约定，y轴向下，深度范围[0, 1]。
+    */
+    class RenderCamera
+    {
+    public:
+        void tick(float delta_time);
+        void setAspectRatio(float aspect_ratio) { m_aspect_ratio = aspect_ratio; }
+        // 列主序，与GLSL的mat4一致
+        void getProjViewMatrix(float proj_view_matrix[16]) const;
+
+    private:
+        Vector3 m_target{ 0.f, 0.f, 0.f };
+        float m_distance{ 12.f };
+        float m_pitch{ 0.5f };       // 弧度，俯视为正
+        float m_yaw{ 0.f };          // 弧度
+        float m_yaw_speed{ 0.2f };   // 弧度每秒
+        float m_fovy{ 1.0471976f };  // 60度
+        float m_aspect_ratio{ 16.f / 9.f };
+        float m_z_near{ 0.1f };
+        float m_z_far{ 100.f };
+    };
+} // namespace Mercury
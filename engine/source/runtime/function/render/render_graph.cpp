@@ -0,0 +1,568 @@
+#include "runtime/function/render/render_graph.h"
+
+#include "runtime/core/base/profiler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Mercury
+{
+    namespace
+    {
+        struct RenderGraphAccessInfo
+        {
+            RHIPipelineStageFlags stage;
+            RHIAccessFlags access;
+            RHIImageLayout layout;
+            bool is_write;
+        };
+
+        // 每种访问方式对应的同步范围与layout
+        RenderGraphAccessInfo getAccessInfo(RenderGraphAccessType access)
+        {
+            switch (access)
+            {
+            case RenderGraphAccessType::color_attachment_write:
+                return { RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                    RHI_ACCESS_COLOR_ATTACHMENT_READ_BIT | RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                    RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, true };
+            case RenderGraphAccessType::depth_stencil_attachment_write:
+                return { RHI_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | RHI_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                    RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                    RHI_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, true };
+            case RenderGraphAccessType::depth_stencil_attachment_read:
+                return { RHI_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | RHI_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                    RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                    RHI_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, false };
+            case RenderGraphAccessType::input_attachment_read:
+                return { RHI_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                    RHI_ACCESS_INPUT_ATTACHMENT_READ_BIT,
+                    RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false };
+            case RenderGraphAccessType::fragment_shader_read:
+                return { RHI_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                    RHI_ACCESS_SHADER_READ_BIT,
+                    RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false };
+            case RenderGraphAccessType::compute_shader_read:
+                return { RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    RHI_ACCESS_SHADER_READ_BIT,
+                    RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false };
+            case RenderGraphAccessType::compute_shader_write:
+                return { RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    RHI_ACCESS_SHADER_WRITE_BIT,
+                    RHI_IMAGE_LAYOUT_GENERAL, true };
+            case RenderGraphAccessType::transfer_read:
+                return { RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                    RHI_ACCESS_TRANSFER_READ_BIT,
+                    RHI_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, false };
+            case RenderGraphAccessType::transfer_write:
+                return { RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                    RHI_ACCESS_TRANSFER_WRITE_BIT,
+                    RHI_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, true };
+            case RenderGraphAccessType::swapchain_acquire:
+                return { RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                    0,
+                    RHI_IMAGE_LAYOUT_UNDEFINED, false };
+            case RenderGraphAccessType::present:
+                return { RHI_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                    0,
+                    RHI_IMAGE_LAYOUT_PRESENT_SRC_KHR, false };
+            case RenderGraphAccessType::undefined:
+            default:
+                return { RHI_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, RHI_IMAGE_LAYOUT_UNDEFINED, false };
+            }
+        }
+
+        // 资源在compile过程中的同步状态：最近一次写入的范围，以及写入之后已经同步过的读取stage
+        struct ResourceState
+        {
+            RHIImageLayout layout{ RHI_IMAGE_LAYOUT_UNDEFINED };
+            RHIPipelineStageFlags write_stage{ 0 };
+            RHIAccessFlags write_access{ 0 };
+            RHIPipelineStageFlags read_stages{ 0 };
+        };
+
+        void setLastAccess(ResourceState& state, const RenderGraphAccessInfo& info)
+        {
+            if (info.is_write)
+            {
+                state.write_stage = info.stage;
+                state.write_access = info.access;
+                state.read_stages = 0;
+            }
+            else
+            {
+                state.read_stages |= info.stage;
+            }
+        }
+
+        bool isAttachmentAccess(RenderGraphAccessType access)
+        {
+            return access == RenderGraphAccessType::color_attachment_write ||
+                access == RenderGraphAccessType::depth_stencil_attachment_write ||
+                access == RenderGraphAccessType::depth_stencil_attachment_read ||
+                access == RenderGraphAccessType::input_attachment_read;
+        }
+    } // namespace
+
+    void RenderGraphBuilder::read(RenderGraphResourceHandle resource, RenderGraphAccessType access)
+    {
+        if (resource >= m_graph.m_resources.size())
+        {
+            throw std::runtime_error("render graph: read of invalid resource");
+        }
+        m_graph.m_passes[m_pass_index].accesses.push_back({ resource, access, false });
+    }
+
+    void RenderGraphBuilder::write(RenderGraphResourceHandle resource, RenderGraphAccessType access)
+    {
+        if (resource >= m_graph.m_resources.size())
+        {
+            throw std::runtime_error("render graph: write of invalid resource");
+        }
+        m_graph.m_passes[m_pass_index].accesses.push_back({ resource, access, true });
+    }
+
+    void RenderGraphBuilder::setSideEffect()
+    {
+        m_graph.m_passes[m_pass_index].has_side_effect = true;
+    }
+
+    RHIImage* RenderGraphPassContext::getImage(RenderGraphResourceHandle resource) const
+    {
+        return graph->getImage(resource);
+    }
+
+    RHIImageView* RenderGraphPassContext::getImageView(RenderGraphResourceHandle resource) const
+    {
+        return graph->getImageView(resource);
+    }
+
+    void RenderGraph::initialize(std::shared_ptr<RHI> rhi)
+    {
+        m_rhi = rhi;
+        m_render_target_pool.initialize(rhi);
+        m_is_dirty = true;
+    }
+
+    void RenderGraph::clear()
+    {
+        releasePhysicalImages();
+        m_render_target_pool.clear();
+        m_passes.clear();
+        m_resources.clear();
+        m_compiled_passes.clear();
+        m_final_barrier_batch = CompiledBarrierBatch();
+        m_is_dirty = true;
+    }
+
+    RenderGraphResourceHandle RenderGraph::createImage(const std::string& name, const RenderGraphImageDesc& desc)
+    {
+        Resource resource;
+        resource.name = name;
+        resource.desc = desc;
+        m_resources.push_back(resource);
+        m_is_dirty = true;
+        return static_cast<RenderGraphResourceHandle>(m_resources.size() - 1);
+    }
+
+    RenderGraphResourceHandle RenderGraph::importImage(const std::string& name,
+        const RenderGraphImageDesc& desc,
+        RenderGraphAccessType initial_access,
+        RenderGraphAccessType final_access)
+    {
+        Resource resource;
+        resource.name = name;
+        resource.desc = desc;
+        resource.is_imported = true;
+        resource.initial_access = initial_access;
+        resource.final_access = final_access;
+        m_resources.push_back(resource);
+        m_is_dirty = true;
+        return static_cast<RenderGraphResourceHandle>(m_resources.size() - 1);
+    }
+
+    void RenderGraph::setImportedImage(RenderGraphResourceHandle resource, RHIImage* image, RHIImageView* image_view)
+    {
+        Resource& imported = m_resources[resource];
+        if (!imported.is_imported)
+        {
+            throw std::runtime_error("render graph: " + imported.name + " is not an imported resource");
+        }
+        imported.image = image;
+        imported.image_view = image_view;
+    }
+
+    void RenderGraph::addPass(const std::string& name,
+        std::function<void(RenderGraphBuilder&)> setup,
+        std::function<void(RenderGraphPassContext&)> execute)
+    {
+        Pass pass;
+        pass.name = Profiler::internName(name);
+        pass.execute = execute;
+        m_passes.push_back(pass);
+
+        RenderGraphBuilder builder(*this, static_cast<uint32_t>(m_passes.size() - 1));
+        setup(builder);
+        m_is_dirty = true;
+    }
+
+    void RenderGraph::compile()
+    {
+        cullPasses();
+        allocatePhysicalImages();
+        buildBarriers();
+        // 本次compile没有再用到的render target（如旧分辨率的），此时GPU已空闲，可以安全销毁
+        m_render_target_pool.trim();
+
+        m_swapchain_generation = m_rhi->getSwapchainGeneration();
+        m_is_dirty = false;
+    }
+
+    void RenderGraph::execute(RHICommandBuffer* command_buffer)
+    {
+        if (m_is_dirty || m_swapchain_generation != m_rhi->getSwapchainGeneration())
+        {
+            compile();
+        }
+
+        RenderGraphPassContext context;
+        context.command_buffer = command_buffer;
+        context.graph = this;
+
+        // 每个pass都是一个调试区间：在调试工具中按pass名分组，并统计每个pass的GPU耗时（见RHI::getGpuTimings）
+        const float pass_color[4] = { 0.5f, 0.8f, 1.0f, 1.0f };
+        for (const CompiledPass& compiled_pass : m_compiled_passes)
+        {
+            recordBarrierBatch(command_buffer, compiled_pass.barrier_batch);
+            const Pass& pass = m_passes[compiled_pass.pass_index];
+            m_rhi->pushEvent(command_buffer, pass.name, pass_color);
+            pass.execute(context);
+            m_rhi->popEvent(command_buffer);
+        }
+        recordBarrierBatch(command_buffer, m_final_barrier_batch);
+    }
+
+    RHIImage* RenderGraph::getImage(RenderGraphResourceHandle resource) const
+    {
+        const Resource& graph_resource = m_resources[resource];
+        if (graph_resource.is_imported)
+        {
+            return graph_resource.image;
+        }
+        return graph_resource.physical_index < m_physical_images.size() ? m_physical_images[graph_resource.physical_index].render_target->image : nullptr;
+    }
+
+    RHIImageView* RenderGraph::getImageView(RenderGraphResourceHandle resource) const
+    {
+        const Resource& graph_resource = m_resources[resource];
+        if (graph_resource.is_imported)
+        {
+            return graph_resource.image_view;
+        }
+        return graph_resource.physical_index < m_physical_images.size() ? m_physical_images[graph_resource.physical_index].render_target->image_view : nullptr;
+    }
+
+    // 从输出反向遍历：只有写入了被需要的资源（或有副作用）的pass才会保留，保留的pass读取的资源也随之成为被需要的资源
+    void RenderGraph::cullPasses()
+    {
+        std::vector<bool> is_resource_needed(m_resources.size(), false);
+        for (size_t i = 0; i < m_resources.size(); ++i)
+        {
+            if (m_resources[i].is_imported && m_resources[i].final_access != RenderGraphAccessType::undefined)
+            {
+                is_resource_needed[i] = true;
+            }
+        }
+
+        m_culled_pass_count = 0;
+        for (size_t i = m_passes.size(); i-- > 0;)
+        {
+            Pass& pass = m_passes[i];
+            bool is_needed = pass.has_side_effect;
+            for (const ResourceAccess& access : pass.accesses)
+            {
+                if (access.is_write && is_resource_needed[access.resource])
+                {
+                    is_needed = true;
+                }
+            }
+
+            pass.is_culled = !is_needed;
+            if (pass.is_culled)
+            {
+                ++m_culled_pass_count;
+                continue;
+            }
+
+            for (const ResourceAccess& access : pass.accesses)
+            {
+                if (!access.is_write)
+                {
+                    is_resource_needed[access.resource] = true;
+                }
+            }
+        }
+    }
+
+    // 按首次使用的顺序为transient资源分配物理image，描述相同且生命周期不重叠的资源共用一张image
+    // 物理image从render target池中获取，重新compile（如重建swapchain）时描述未变的render target会被直接复用
+    void RenderGraph::allocatePhysicalImages()
+    {
+        releasePhysicalImages();
+
+        const RHISwapChainDesc& swapchain_info = m_rhi->getSwapchainInfo();
+
+        std::vector<uint32_t> first_use(m_resources.size(), UINT32_MAX);
+        std::vector<uint32_t> last_use(m_resources.size(), 0);
+        // 只在单个pass内作为attachment使用的资源，内容不需要写回内存，可以使用lazily allocated内存
+        std::vector<bool> is_transient(m_resources.size(), true);
+        for (uint32_t pass_index = 0; pass_index < m_passes.size(); ++pass_index)
+        {
+            if (m_passes[pass_index].is_culled)
+            {
+                continue;
+            }
+            for (const ResourceAccess& access : m_passes[pass_index].accesses)
+            {
+                first_use[access.resource] = std::min(first_use[access.resource], pass_index);
+                last_use[access.resource] = std::max(last_use[access.resource], pass_index);
+                if (!isAttachmentAccess(access.access))
+                {
+                    is_transient[access.resource] = false;
+                }
+            }
+        }
+        for (RenderGraphResourceHandle i = 0; i < m_resources.size(); ++i)
+        {
+            const RHIImageUsageFlags attachment_usage = RHI_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                RHI_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                RHI_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+            if (first_use[i] != last_use[i] || (m_resources[i].desc.usage & ~attachment_usage) != 0)
+            {
+                is_transient[i] = false;
+            }
+        }
+
+        std::vector<RenderGraphResourceHandle> transient_resources;
+        for (RenderGraphResourceHandle i = 0; i < m_resources.size(); ++i)
+        {
+            m_resources[i].physical_index = UINT32_MAX;
+            if (!m_resources[i].is_imported && first_use[i] != UINT32_MAX)
+            {
+                transient_resources.push_back(i);
+            }
+        }
+        std::sort(transient_resources.begin(), transient_resources.end(),
+            [&first_use](RenderGraphResourceHandle lhs, RenderGraphResourceHandle rhs) { return first_use[lhs] < first_use[rhs]; });
+
+        for (RenderGraphResourceHandle resource_index : transient_resources)
+        {
+            Resource& resource = m_resources[resource_index];
+            RenderTargetDesc desc;
+            desc.format = resource.desc.format;
+            desc.usage = resource.desc.usage;
+            desc.aspect = resource.desc.aspect;
+            desc.width = resource.desc.width != 0 ? resource.desc.width : swapchain_info.extent.width;
+            desc.height = resource.desc.height != 0 ? resource.desc.height : swapchain_info.extent.height;
+            desc.is_transient = is_transient[resource_index];
+
+            uint32_t physical_index = UINT32_MAX;
+            for (uint32_t i = 0; i < m_physical_images.size(); ++i)
+            {
+                if (m_physical_images[i].last_pass < first_use[resource_index] && m_physical_images[i].desc == desc)
+                {
+                    physical_index = i;
+                    break;
+                }
+            }
+
+            if (physical_index == UINT32_MAX)
+            {
+                PhysicalImage physical_image;
+                physical_image.desc = desc;
+                physical_image.render_target = m_render_target_pool.acquire(desc);
+                m_physical_images.push_back(physical_image);
+                physical_index = static_cast<uint32_t>(m_physical_images.size() - 1);
+            }
+
+            m_physical_images[physical_index].last_pass = last_use[resource_index];
+            resource.physical_index = physical_index;
+        }
+    }
+
+    void RenderGraph::buildBarriers()
+    {
+        m_compiled_passes.clear();
+        m_final_barrier_batch = CompiledBarrierBatch();
+
+        // transient资源的状态跟随物理image（别名资源之间也需要同步），导入资源各自独立
+        std::vector<ResourceState> physical_states(m_physical_images.size());
+        std::vector<ResourceState> imported_states(m_resources.size());
+        std::vector<RenderGraphResourceHandle> physical_owner(m_physical_images.size(), k_invalid_render_graph_resource);
+
+        for (size_t i = 0; i < m_resources.size(); ++i)
+        {
+            if (m_resources[i].is_imported)
+            {
+                RenderGraphAccessInfo info = getAccessInfo(m_resources[i].initial_access);
+                imported_states[i].layout = info.layout;
+                imported_states[i].write_stage = info.stage;
+                imported_states[i].write_access = info.is_write ? info.access : 0;
+            }
+        }
+
+        // 内容被丢弃的资源（transient以及initial_access为undefined的导入资源）跨帧复用同一张image，
+        // 用上一帧最后一次访问的范围作为本帧首次访问的源范围（同一队列上按提交顺序同步）
+        for (const Pass& pass : m_passes)
+        {
+            if (pass.is_culled)
+            {
+                continue;
+            }
+            for (const ResourceAccess& access : pass.accesses)
+            {
+                const Resource& resource = m_resources[access.resource];
+                if (resource.is_imported && resource.initial_access != RenderGraphAccessType::undefined)
+                {
+                    continue;
+                }
+
+                ResourceState& state = resource.is_imported ? imported_states[access.resource] : physical_states[resource.physical_index];
+                RenderGraphAccessInfo info = getAccessInfo(access.access);
+                state.write_stage = info.stage;
+                state.write_access = info.is_write ? info.access : 0;
+                state.read_stages = 0;
+            }
+        }
+
+        auto transition = [](CompiledBarrierBatch& batch, RenderGraphResourceHandle resource, ResourceState& state, const RenderGraphAccessInfo& info)
+            {
+                bool is_layout_change = state.layout != info.layout;
+                if (info.is_write || is_layout_change)
+                {
+                    // 写入或layout转换：需要等待之前所有的写和读完成
+                    RHIPipelineStageFlags src_stage = state.write_stage | state.read_stages;
+                    batch.src_stage |= src_stage != 0 ? src_stage : static_cast<RHIPipelineStageFlags>(RHI_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+                    batch.dst_stage |= info.stage;
+                    batch.barriers.push_back({ resource, state.write_access, info.access, state.layout, info.layout });
+
+                    state.layout = info.layout;
+                    if (info.is_write)
+                    {
+                        setLastAccess(state, info);
+                    }
+                    else
+                    {
+                        // layout转换本身相当于一次写，之后的同stage读取无需再同步
+                        state.write_stage = info.stage;
+                        state.write_access = 0;
+                        state.read_stages = info.stage;
+                    }
+                }
+                else if ((state.read_stages & info.stage) != info.stage && state.write_stage != 0)
+                {
+                    // 读后读不需要barrier，只有新的stage第一次读取之前的写入结果时才需要
+                    batch.src_stage |= state.write_stage;
+                    batch.dst_stage |= info.stage;
+                    batch.barriers.push_back({ resource, state.write_access, info.access, state.layout, info.layout });
+                    setLastAccess(state, info);
+                }
+            };
+
+        for (uint32_t pass_index = 0; pass_index < m_passes.size(); ++pass_index)
+        {
+            const Pass& pass = m_passes[pass_index];
+            if (pass.is_culled)
+            {
+                continue;
+            }
+
+            CompiledPass compiled_pass;
+            compiled_pass.pass_index = pass_index;
+            for (const ResourceAccess& access : pass.accesses)
+            {
+                const Resource& resource = m_resources[access.resource];
+                RenderGraphAccessInfo info = getAccessInfo(access.access);
+                if (resource.is_imported)
+                {
+                    transition(compiled_pass.barrier_batch, access.resource, imported_states[access.resource], info);
+                }
+                else
+                {
+                    // 物理image换了新的占用者，旧内容不再需要保留
+                    ResourceState& state = physical_states[resource.physical_index];
+                    if (physical_owner[resource.physical_index] != access.resource)
+                    {
+                        physical_owner[resource.physical_index] = access.resource;
+                        state.layout = RHI_IMAGE_LAYOUT_UNDEFINED;
+                    }
+                    transition(compiled_pass.barrier_batch, access.resource, state, info);
+                }
+            }
+            m_compiled_passes.push_back(compiled_pass);
+        }
+
+        for (RenderGraphResourceHandle i = 0; i < m_resources.size(); ++i)
+        {
+            const Resource& resource = m_resources[i];
+            if (resource.is_imported && resource.final_access != RenderGraphAccessType::undefined)
+            {
+                transition(m_final_barrier_batch, i, imported_states[i], getAccessInfo(resource.final_access));
+            }
+        }
+    }
+
+    void RenderGraph::releasePhysicalImages()
+    {
+        if (m_physical_images.empty())
+        {
+            return;
+        }
+
+        // 之前的帧可能仍在使用这些image，重新compile只发生在拓扑或swapchain变化时，这里直接等待设备空闲
+        m_rhi->waitDeviceIdle();
+        for (PhysicalImage& physical_image : m_physical_images)
+        {
+            m_render_target_pool.release(physical_image.render_target);
+        }
+        m_physical_images.clear();
+    }
+
+    void RenderGraph::recordBarrierBatch(RHICommandBuffer* command_buffer, const CompiledBarrierBatch& batch)
+    {
+        if (batch.barriers.empty())
+        {
+            return;
+        }
+
+        m_barrier_scratch.resize(batch.barriers.size());
+        for (size_t i = 0; i < batch.barriers.size(); ++i)
+        {
+            const CompiledBarrier& compiled_barrier = batch.barriers[i];
+            const Resource& resource = m_resources[compiled_barrier.resource];
+
+            RHIImageMemoryBarrier& barrier = m_barrier_scratch[i];
+            barrier.sType = RHI_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.pNext = nullptr;
+            barrier.srcAccessMask = compiled_barrier.src_access;
+            barrier.dstAccessMask = compiled_barrier.dst_access;
+            barrier.oldLayout = compiled_barrier.old_layout;
+            barrier.newLayout = compiled_barrier.new_layout;
+            barrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+            barrier.image = getImage(compiled_barrier.resource);
+            barrier.subresourceRange = { resource.desc.aspect, 0, 1, 0, 1 };
+        }
+
+        m_rhi->cmdPipelineBarrier(command_buffer,
+            batch.src_stage,
+            batch.dst_stage,
+            0,
+            0,
+            nullptr,
+            0,
+            nullptr,
+            static_cast<uint32_t>(m_barrier_scratch.size()),
+            m_barrier_scratch.data());
+    }
+} // namespace Mercury
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "runtime/function/render/interface/rhi.h"
+#include "runtime/function/render/render_target_pool.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Mercury
+{
+    typedef uint32_t RenderGraphResourceHandle;
+    static constexpr RenderGraphResourceHandle k_invalid_render_graph_resource = UINT32_MAX;
+
+    // pass对资源的访问方式，由它推导出所需的pipeline stage、access mask和image layout
+    enum class RenderGraphAccessType : uint8_t
+    {
+        undefined = 0,
+        swapchain_acquire, // 刚从swapchain获取的image，等待acquire semaphore的stage为COLOR_ATTACHMENT_OUTPUT
+        color_attachment_write,
+        depth_stencil_attachment_write,
+        depth_stencil_attachment_read,
+        input_attachment_read,
+        fragment_shader_read,
+        compute_shader_read,
+        compute_shader_write,
+        transfer_read,
+        transfer_write,
+        present,
+    };
+
+    // image的描述，width/height为0时跟随swapchain的分辨率
+    struct RenderGraphImageDesc
+    {
+        RHIFormat format{ RHI_FORMAT_UNDEFINED };
+        RHIImageUsageFlags usage{ 0 };
+        RHIImageAspectFlags aspect{ RHI_IMAGE_ASPECT_COLOR_BIT };
+        uint32_t width{ 0 };
+        uint32_t height{ 0 };
+    };
+
+    class RenderGraph;
+
+    // 声明阶段：pass通过builder声明它读写哪些资源
+    class RenderGraphBuilder
+    {
+    public:
+        void read(RenderGraphResourceHandle resource, RenderGraphAccessType access);
+        void write(RenderGraphResourceHandle resource, RenderGraphAccessType access);
+        // 有副作用的pass（如写回CPU）不会被裁剪
+        void setSideEffect();
+
+    private:
+        friend class RenderGraph;
+        RenderGraphBuilder(RenderGraph& graph, uint32_t pass_index) : m_graph(graph), m_pass_index(pass_index) {}
+
+        RenderGraph& m_graph;
+        uint32_t m_pass_index;
+    };
+
+    // 执行阶段：pass在回调中通过context录制命令、取得实际的image
+    struct RenderGraphPassContext
+    {
+        RHICommandBuffer* command_buffer{ nullptr };
+        const RenderGraph* graph{ nullptr };
+
+        RHIImage* getImage(RenderGraphResourceHandle resource) const;
+        RHIImageView* getImageView(RenderGraphResourceHandle resource) const;
+    };
+
+    /*
+    * 渲染图：每个pass声明读写的资源，render graph负责
+    * • 从输出（导入资源的final状态/有副作用的pass）反向裁剪没有被使用的pass
+    * • 根据前后两次访问自动推导pipeline barrier和layout转换
+    * • 为生命周期不重叠且描述相同的transient image复用同一张物理image，只在单个pass内使用的attachment使用lazily allocated内存
+    * 拓扑（pass/资源声明）或swapchain变化时才重新compile，每帧只执行预先算好的barrier和pass回调
+    */
+    class RenderGraph
+    {
+    public:
+        void initialize(std::shared_ptr<RHI> rhi);
+        void clear();
+
+        // 由render graph创建并管理生命周期的transient image
+        RenderGraphResourceHandle createImage(const std::string& name, const RenderGraphImageDesc& desc);
+        // 外部资源（如swapchain image），initial_access/final_access是进入/离开渲染图时的状态
+        // initial_access为undefined时丢弃旧内容，但仍与上一帧最后一次访问同步
+        RenderGraphResourceHandle importImage(const std::string& name,
+            const RenderGraphImageDesc& desc,
+            RenderGraphAccessType initial_access,
+            RenderGraphAccessType final_access);
+        // 外部资源每帧可能变化（如swapchain image index），在execute之前更新
+        void setImportedImage(RenderGraphResourceHandle resource, RHIImage* image, RHIImageView* image_view);
+
+        void addPass(const std::string& name,
+            std::function<void(RenderGraphBuilder&)> setup,
+            std::function<void(RenderGraphPassContext&)> execute);
+
+        void compile();
+        void execute(RHICommandBuffer* command_buffer);
+
+        RHIImage* getImage(RenderGraphResourceHandle resource) const;
+        RHIImageView* getImageView(RenderGraphResourceHandle resource) const;
+        uint32_t getCulledPassCount() const { return m_culled_pass_count; }
+        uint32_t getPhysicalImageCount() const { return static_cast<uint32_t>(m_physical_images.size()); }
+        const RenderTargetPool& getRenderTargetPool() const { return m_render_target_pool; }
+
+    private:
+        friend class RenderGraphBuilder;
+
+        struct ResourceAccess
+        {
+            RenderGraphResourceHandle resource;
+            RenderGraphAccessType access;
+            bool is_write;
+        };
+
+        struct Pass
+        {
+            const char* name{ nullptr }; // 由Profiler::internName保存，生命周期到程序结束，直接作为pushEvent的区间名
+            std::function<void(RenderGraphPassContext&)> execute;
+            std::vector<ResourceAccess> accesses;
+            bool has_side_effect{ false };
+            bool is_culled{ false };
+        };
+
+        struct Resource
+        {
+            std::string name;
+            RenderGraphImageDesc desc;
+            bool is_imported{ false };
+            RenderGraphAccessType initial_access{ RenderGraphAccessType::undefined };
+            RenderGraphAccessType final_access{ RenderGraphAccessType::undefined };
+            RHIImage* image{ nullptr };
+            RHIImageView* image_view{ nullptr };
+            uint32_t physical_index{ UINT32_MAX };
+        };
+
+        struct PhysicalImage
+        {
+            RenderTargetDesc desc;
+            RenderTarget* render_target{ nullptr };
+            uint32_t last_pass{ 0 }; // 当前占用者最后一次被使用的pass
+        };
+
+        struct CompiledBarrier
+        {
+            RenderGraphResourceHandle resource;
+            RHIAccessFlags src_access;
+            RHIAccessFlags dst_access;
+            RHIImageLayout old_layout;
+            RHIImageLayout new_layout;
+        };
+
+        struct CompiledBarrierBatch
+        {
+            RHIPipelineStageFlags src_stage{ 0 };
+            RHIPipelineStageFlags dst_stage{ 0 };
+            std::vector<CompiledBarrier> barriers;
+        };
+
+        struct CompiledPass
+        {
+            uint32_t pass_index;
+            CompiledBarrierBatch barrier_batch;
+        };
+
+        void cullPasses();
+        void allocatePhysicalImages();
+        void buildBarriers();
+        void releasePhysicalImages();
+        void recordBarrierBatch(RHICommandBuffer* command_buffer, const CompiledBarrierBatch& batch);
+
+        std::shared_ptr<RHI> m_rhi;
+        std::vector<Pass> m_passes;
+        std::vector<Resource> m_resources;
+        std::vector<PhysicalImage> m_physical_images;
+        RenderTargetPool m_render_target_pool;
+        std::vector<CompiledPass> m_compiled_passes;
+        CompiledBarrierBatch m_final_barrier_batch;
+        std::vector<RHIImageMemoryBarrier> m_barrier_scratch; // 执行时复用，避免每帧分配
+
+        bool m_is_dirty{ true };
+        uint64_t m_swapchain_generation{ 0 };
+        uint32_t m_culled_pass_count{ 0 };
+    };
+} // namespace Mercury
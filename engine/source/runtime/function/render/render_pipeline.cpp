@@ -2,12 +2,61 @@
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
 #include "runtime/function/render/render_pipeline.h"
 #include "runtime/function/global/global_context.h"
+#include "runtime/core/base/profiler.h"
 
 #include<iostream>
 namespace Mercury
 {
-    void RenderPipeline::initialize(RenderPipelineInitInfo init_info) {}
+    void RenderPipeline::initialize(RenderPipelineInitInfo init_info) {
+        setupRenderGraph();
+        // 先compile一次，render graph创建的image在第一帧之前就存在
+        m_render_graph.compile();
+    }
+
+    void RenderPipeline::clear() {
+        // render graph创建的transient image来自RHI的分配器
+        m_render_graph.clear();
+    }
+
+    // 各个pass只声明读写的资源，barrier和layout转换由render graph推导
+    void RenderPipeline::setupRenderGraph() {
+        m_render_graph.initialize(m_rhi);
+
+        RenderGraphImageDesc swapchain_image_desc;
+        swapchain_image_desc.format = m_rhi->getSwapchainInfo().imageFormat;
+        swapchain_image_desc.aspect = RHI_IMAGE_ASPECT_COLOR_BIT;
+        // headless时没有present，帧末把离屏图像转换为拷贝源，随时可以回读
+        m_swapchain_image_handle = m_render_graph.importImage("swapchain_image",
+            swapchain_image_desc,
+            RenderGraphAccessType::swapchain_acquire,
+            m_rhi->isHeadless() ? RenderGraphAccessType::transfer_read : RenderGraphAccessType::present);
+
+        // 深度只在debug draw pass内使用，由render graph从RenderTargetPool中分配：
+        // 只在单个pass内作为attachment使用，会被识别为transient，支持时放在lazily allocated内存中
+        RenderGraphImageDesc depth_image_desc;
+        depth_image_desc.format = m_rhi->getDepthImageInfo().depth_image_format;
+        depth_image_desc.usage = RHI_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        depth_image_desc.aspect = RHI_IMAGE_ASPECT_DEPTH_BIT;
+        m_depth_image_handle = m_render_graph.createImage("depth_image", depth_image_desc);
+
+        // todo other pass
+
+        // debug draw
+        m_render_graph.addPass("debug_draw",
+            [this](RenderGraphBuilder& builder) {
+                builder.write(m_swapchain_image_handle, RenderGraphAccessType::color_attachment_write);
+                builder.write(m_depth_image_handle, RenderGraphAccessType::depth_stencil_attachment_write);
+            },
+            [this](RenderGraphPassContext& context) {
+                VulkanRHI* vulkan_rhi = static_cast<VulkanRHI*>(m_rhi.get());
+                g_runtime_global_context.m_debugdraw_manager->draw(context.command_buffer,
+                    vulkan_rhi->m_current_swapchain_image_index,
+                    context.getImageView(m_depth_image_handle));
+            });
+    }
+
     void RenderPipeline::forwardRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource) {
+        MERCURY_PROFILE_SCOPE("RenderPipeline::forwardRender");
         // std::cout << "render pipeline:: forwardRender()" << std::endl;
         /*
         在 Vulkan 中渲染帧包含一组常见步骤：
@@ -20,10 +69,9 @@ namespace Mercury
         VulkanRHI* vulkan_rhi = static_cast<VulkanRHI*>(rhi.get());
         RenderResource* vulkan_resource = static_cast<RenderResource*>(render_resource.get());
 
-        // todo 
         vulkan_resource->resetRingBufferOffset(vulkan_rhi->m_current_frame_index);
 
-        vulkan_rhi->waitForFences();
+        vulkan_rhi->waitForFrameInFlight();
 
         vulkan_rhi->resetCommandPool();
 
@@ -34,19 +82,25 @@ namespace Mercury
         if (recreate_swapchain)
             return;
 
-        // todo other
-        
-        // debug draw
-        g_runtime_global_context.m_debugdraw_manager->draw(vulkan_rhi->m_current_swapchain_image_index);
+        // 每帧更新导入到render graph中的外部资源，然后按编译好的顺序执行各个pass
+        const RHISwapChainDesc& swapchain_info = vulkan_rhi->getSwapchainInfo();
+        m_render_graph.setImportedImage(m_swapchain_image_handle,
+            swapchain_info.images[vulkan_rhi->m_current_swapchain_image_index],
+            swapchain_info.imageViews[vulkan_rhi->m_current_swapchain_image_index]);
+
+        m_render_graph.execute(vulkan_rhi->getCurrentCommandBuffer());
 
         vulkan_rhi->submitRendering(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
     }
 
     void RenderPipeline::passUpdateAfterRecreateSwapchain() {
+        // 之前的帧已经完成，此时重新compile：跟随swapchain分辨率的render target在这里重建，各pass再引用新的image view
+        m_render_graph.compile();
+
         // todo other
 
         // debug draw:更新交换链
-        g_runtime_global_context.m_debugdraw_manager->updateAfterRecreateSwapchain();
+        g_runtime_global_context.m_debugdraw_manager->updateAfterRecreateSwapchain(m_render_graph.getImageView(m_depth_image_handle));
     }
 
 } // namespace Mercury
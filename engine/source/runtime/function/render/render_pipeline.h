@@ -1,14 +1,23 @@
 #pragma once
 
 #include "runtime/function/render/render_pipeline_base.h"
+#include "runtime/function/render/render_graph.h"
 
 namespace Mercury
 {
     class RenderPipeline :public RenderPipelineBase {
     public:
         virtual void initialize(RenderPipelineInitInfo init_info) override final;
+        virtual void clear() override final;
         virtual void forwardRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource) override;
 
         void passUpdateAfterRecreateSwapchain();
+
+    private:
+        void setupRenderGraph();
+
+        RenderGraph m_render_graph;
+        RenderGraphResourceHandle m_swapchain_image_handle{ k_invalid_render_graph_resource };
+        RenderGraphResourceHandle m_depth_image_handle{ k_invalid_render_graph_resource };
     };
 } // namespace Mercury
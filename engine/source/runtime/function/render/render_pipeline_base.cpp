@@ -4,6 +4,7 @@
 namespace Mercury
 {
     void RenderPipelineBase::initialize(RenderPipelineInitInfo init_info) {}
+    void RenderPipelineBase::clear() {}
     void RenderPipelineBase::forwardRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource) {}
 
     void RenderPipelineBase::preparePassData(std::shared_ptr<RenderResourceBase> render_resource) {
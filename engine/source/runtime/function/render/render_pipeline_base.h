@@ -16,6 +16,8 @@ namespace Mercury
     class RenderPipelineBase {
     public:
         virtual void initialize(RenderPipelineInitInfo init_info);
+        // 释放从RHI创建的资源，需要在RHI销毁设备之前调用
+        virtual void clear();
         virtual void forwardRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource);
         virtual void preparePassData(std::shared_ptr<RenderResourceBase> render_resource);
 
@@ -1,10 +1,110 @@
 #include "runtime/function/render/render_resource.h"
+#include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
 #include "runtime/function/global/global_context.h"
 
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
 
 namespace Mercury
 {
-    // todo
+    void RenderResource::initialize(std::shared_ptr<RHI> rhi) {
+        m_rhi = rhi;
+        createAndMapStorageBuffer();
+    }
+
+    void RenderResource::clear() {
+        StorageBuffer& storage_buffer = m_storage_buffer;
+        if (storage_buffer._global_upload_ringbuffer == nullptr)
+        {
+            return;
+        }
+        // 环形缓冲区是创建时由VMA持久映射的（MAPPED_BIT），没有经过mapMemory，不能调用unmapMemory：映射随allocation一起释放
+        storage_buffer._global_upload_ringbuffer_memory_pointer = nullptr;
+        m_rhi->destroyBuffer(storage_buffer._global_upload_ringbuffer, storage_buffer._global_upload_ringbuffer_allocation);
+        storage_buffer._global_upload_ringbuffer = nullptr;
+        storage_buffer._global_upload_ringbuffer_allocation = nullptr;
+    }
+
+    // 每帧开始时把当前帧分段的末尾指针重置到起点，上一轮使用这段内存的帧已由帧时间线保证执行完毕
     void RenderResource::resetRingBufferOffset(uint8_t current_frame_index) {
+        m_current_frame_index = current_frame_index;
+        m_storage_buffer._global_upload_ringbuffers_end[current_frame_index] =
+            m_storage_buffer._global_upload_ringbuffers_begin[current_frame_index];
+    }
+
+    RingBufferAllocation RenderResource::allocate(uint32_t size, uint32_t alignment) {
+        StorageBuffer& storage_buffer = m_storage_buffer;
+
+        // alignment为0时视为不需要对齐；其余必须是2的幂（Vulkan的各类offset alignment均满足）
+        if (alignment == 0)
+        {
+            alignment = 1;
+        }
+        assert((alignment & (alignment - 1)) == 0 && "ringbuffer alignment must be a power of two");
+
+        uint32_t& end = storage_buffer._global_upload_ringbuffers_end[m_current_frame_index];
+        uint32_t offset = (end + (alignment - 1)) & ~(alignment - 1);
+        uint32_t segment_end = storage_buffer._global_upload_ringbuffers_begin[m_current_frame_index] +
+            storage_buffer._global_upload_ringbuffers_size[m_current_frame_index];
+        // 用剩余空间比较，避免offset + size在uint32上回绕后通过检查
+        if (offset > segment_end || size > segment_end - offset)
+        {
+            throw std::runtime_error("global upload ringbuffer overflow!");
+        }
+        end = offset + size;
+
+        RingBufferAllocation allocation;
+        allocation.buffer = storage_buffer._global_upload_ringbuffer;
+        allocation.offset = offset;
+        allocation.mapped_data = static_cast<uint8_t*>(storage_buffer._global_upload_ringbuffer_memory_pointer) + offset;
+        return allocation;
+    }
+
+    void RenderResource::createAndMapStorageBuffer() {
+        StorageBuffer& storage_buffer = m_storage_buffer;
+        uint32_t frames_in_flight = VulkanRHI::k_max_frames_in_flight;
+
+        RHIPhysicalDeviceLimits limits = m_rhi->getPhysicalDeviceLimits();
+        storage_buffer._min_uniform_buffer_offset_alignment = static_cast<uint32_t>(limits.minUniformBufferOffsetAlignment);
+        storage_buffer._min_storage_buffer_offset_alignment = static_cast<uint32_t>(limits.minStorageBufferOffsetAlignment);
+
+        // 按帧均分，每段起点对齐到最大的offset alignment
+        uint32_t segment_alignment = std::max(storage_buffer._min_uniform_buffer_offset_alignment,
+            storage_buffer._min_storage_buffer_offset_alignment);
+        uint32_t segment_size = (k_global_upload_ringbuffer_size / frames_in_flight) & ~(segment_alignment - 1);
+
+        storage_buffer._global_upload_ringbuffers_begin.resize(frames_in_flight);
+        storage_buffer._global_upload_ringbuffers_end.resize(frames_in_flight);
+        storage_buffer._global_upload_ringbuffers_size.resize(frames_in_flight);
+        for (uint32_t i = 0; i < frames_in_flight; ++i)
+        {
+            storage_buffer._global_upload_ringbuffers_begin[i] = segment_size * i;
+            storage_buffer._global_upload_ringbuffers_end[i] = segment_size * i;
+            storage_buffer._global_upload_ringbuffers_size[i] = segment_size;
+        }
+
+        RHIBufferCreateInfo buffer_create_info{};
+        buffer_create_info.sType = RHI_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_create_info.size = segment_size * frames_in_flight;
+        buffer_create_info.usage = RHI_BUFFER_USAGE_UNIFORM_BUFFER_BIT | RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+            RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT | RHI_BUFFER_USAGE_INDEX_BUFFER_BIT;
+        buffer_create_info.sharingMode = RHI_SHARING_MODE_EXCLUSIVE;
+
+        // 要求HOST_COHERENT，CPU写入后无需flush即对GPU可见
+        RHIAllocationCreateInfo allocation_create_info{};
+        allocation_create_info.flags = RHI_ALLOCATION_CREATE_MAPPED_BIT | RHI_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+        allocation_create_info.usage = RHI_MEMORY_USAGE_AUTO;
+        allocation_create_info.requiredFlags = RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+        RHIAllocationInfo allocation_info{};
+        m_rhi->createBuffer(&buffer_create_info,
+            &allocation_create_info,
+            storage_buffer._global_upload_ringbuffer,
+            storage_buffer._global_upload_ringbuffer_allocation,
+            &allocation_info);
+
+        // 持久映射：整个生命周期内只映射一次
+        storage_buffer._global_upload_ringbuffer_memory_pointer = allocation_info.pMappedData;
     }
 } // namespace Mercury
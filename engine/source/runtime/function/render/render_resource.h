@@ -1,14 +1,54 @@
 #pragma once
 
 #include "runtime/function/render/render_resource_base.h"
+#include "runtime/function/render/interface/rhi.h"
+
 #include <cstdint> // for uint8_t
+#include <memory>
+#include <vector>
 
 
 namespace Mercury
 {
+    // 环形缓冲区中的一次子分配：所在的buffer、字节偏移（可直接作为dynamic offset绑定）以及已映射的CPU地址
+    struct RingBufferAllocation
+    {
+        RHIBuffer* buffer{ nullptr };
+        uint32_t offset{ 0 };
+        void* mapped_data{ nullptr };
+    };
+
+    struct StorageBuffer
+    {
+        // limits
+        uint32_t _min_uniform_buffer_offset_alignment{ 256 };
+        uint32_t _min_storage_buffer_offset_alignment{ 256 };
+
+        // 持久映射、host可见的全局上传环形缓冲区，按k_max_frames_in_flight均分，每一帧只在自己的分段内线性分配
+        RHIBuffer* _global_upload_ringbuffer{ nullptr };
+        RHIAllocation* _global_upload_ringbuffer_allocation{ nullptr };
+        void* _global_upload_ringbuffer_memory_pointer{ nullptr };
+        std::vector<uint32_t> _global_upload_ringbuffers_begin;
+        std::vector<uint32_t> _global_upload_ringbuffers_end;
+        std::vector<uint32_t> _global_upload_ringbuffers_size;
+    };
+
     class RenderResource :public RenderResourceBase {
     public:
+        static uint32_t const k_global_upload_ringbuffer_size{ 1024 * 1024 * 32 };
+
+        void initialize(std::shared_ptr<RHI> rhi);
+        virtual void clear() override final;
         void resetRingBufferOffset(uint8_t current_frame_index);
+        // 从当前帧的分段中按alignment对齐分配size字节，不触发任何驱动分配
+        RingBufferAllocation allocate(uint32_t size, uint32_t alignment);
+
+        StorageBuffer m_storage_buffer;
+
+    private:
+        void createAndMapStorageBuffer();
+
+        std::shared_ptr<RHI> m_rhi;
+        uint8_t m_current_frame_index{ 0 };
     };
 } // namespace Mercury
-
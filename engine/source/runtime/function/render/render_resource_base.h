@@ -3,6 +3,9 @@
 namespace Mercury
 {
     class RenderResourceBase {
-
+    public:
+        virtual ~RenderResourceBase() {}
+        // 释放从RHI创建的资源，需要在RHI销毁设备之前调用
+        virtual void clear() = 0;
     };
 } // namespace Mercury
@@ -0,0 +1,33 @@
+#include "runtime/function/render/render_swap_context.h"
+
+#include <utility>
+
+namespace Mercury
+{
+    void RenderSwapContext::publishLogicSwapData()
+    {
+        uint64_t logic_frame_index = m_swap_data[m_logic_index].logic_frame_index;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::swap(m_logic_index, m_ready_index);
+            m_is_ready_fresh = true;
+        }
+
+        // 换回来的快照可能是渲染线程几帧之前用过的，先清掉逻辑侧每帧都要重新填写的内容
+        RenderSwapData& logic_swap_data = m_swap_data[m_logic_index];
+        logic_swap_data.clear();
+        logic_swap_data.logic_frame_index = logic_frame_index + 1;
+    }
+
+    bool RenderSwapContext::acquireRenderSwapData()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_is_ready_fresh)
+        {
+            return false;
+        }
+        std::swap(m_render_index, m_ready_index);
+        m_is_ready_fresh = false;
+        return true;
+    }
+} // namespace Mercury
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace Mercury
+{
+    /*
+    * 逻辑侧每帧产出、渲染侧消费的数据快照（render proxy）。
+    * 渲染线程只读这份快照，不直接访问逻辑侧的对象，逻辑线程因此可以在渲染上一帧的同时修改场景。
+    */
+    struct RenderSwapData
+    {
+        uint64_t logic_frame_index{ 0 };
+        float delta_time{ 0.f };
+        // 本帧逻辑所用输入的采样时刻，渲染侧据此统计输入到present的延迟
+        std::chrono::steady_clock::time_point input_sample_time{};
+
+        // 相机，列主序
+        bool has_proj_view_matrix{ false };
+        float proj_view_matrix[16] = {};
+
+        void clear()
+        {
+            has_proj_view_matrix = false;
+        }
+    };
+
+    /*
+    * 逻辑线程与渲染线程之间的三缓冲：逻辑线程写一份、渲染线程读一份、第三份是最近一次发布的结果。
+    * 发布和获取只交换下标，双方都不需要等待对方处理完整个快照。
+    * 逻辑线程比渲染线程快时，未被渲染的旧快照会被新快照覆盖。
+    */
+    class RenderSwapContext
+    {
+    public:
+        // 逻辑线程：当前正在写入的快照
+        RenderSwapData& getLogicSwapData() { return m_swap_data[m_logic_index]; }
+        // 逻辑线程：发布写好的快照，并拿到一份新的快照用于下一帧
+        void publishLogicSwapData();
+
+        // 渲染线程：如果有新发布的快照就切换过去，返回是否切换
+        bool acquireRenderSwapData();
+        // 渲染线程：本帧使用的快照
+        const RenderSwapData& getRenderSwapData() const { return m_swap_data[m_render_index]; }
+
+    private:
+        RenderSwapData m_swap_data[3];
+        uint8_t m_logic_index{ 0 };
+        uint8_t m_render_index{ 1 };
+
+        // 只保护下面两个成员，临界区只有几次赋值
+        std::mutex m_mutex;
+        uint8_t m_ready_index{ 2 };
+        bool m_is_ready_fresh{ false };
+    };
+} // namespace Mercury
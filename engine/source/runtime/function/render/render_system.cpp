@@ -2,6 +2,12 @@
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
 #include "runtime/function/global/global_context.h"
 #include "runtime/function/render/render_pipeline.h"
+#include "runtime/function/render/render_resource.h"
+#include "runtime/core/base/profiler.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
 
 namespace Mercury
 {
@@ -10,9 +16,21 @@ namespace Mercury
         // render context initialize
         RHIInitInfo rhi_init_info;
         rhi_init_info.window_system = init_info.window_system;
+        rhi_init_info.pipeline_cache_path = init_info.pipeline_cache_path;
+        // 每个任务系统线程（包括主线程）都可以并行录制secondary command buffer
+        rhi_init_info.command_recording_worker_count = g_runtime_global_context.m_job_system->getWorkerCount();
         m_rhi = std::make_shared<VulkanRHI>();
         m_rhi->initialize(rhi_init_info);
 
+        // pipeline编译服务，需要在pipeline cache创建之后启动；编译任务在任务系统的线程上执行
+        m_pipeline_build_service = std::make_shared<PipelineBuildService>();
+        m_pipeline_build_service->initialize(g_runtime_global_context.m_job_system);
+
+        // global rendering resource（包括每帧的上传环形缓冲区）
+        std::shared_ptr<RenderResource> render_resource = std::make_shared<RenderResource>();
+        render_resource->initialize(m_rhi);
+        m_render_resource = render_resource;
+
         // initialize render pipeline
         RenderPipelineInitInfo pipeline_init_info;
         // pipeline_init_info.enable_fxaa = global_rendering_res.m_enable_fxaa; // todo
@@ -21,14 +39,69 @@ namespace Mercury
         m_render_pipeline->m_rhi = m_rhi;
         m_render_pipeline->initialize(pipeline_init_info);
 
+        m_frame_capture_dir = init_info.frame_capture_dir;
+        if (!m_frame_capture_dir.empty())
+        {
+            if (m_rhi->isHeadless())
+            {
+                std::filesystem::create_directories(m_frame_capture_dir);
+            }
+            else
+            {
+                std::cout << "frame capture is only supported in headless mode, ignored" << std::endl;
+                m_frame_capture_dir.clear();
+            }
+        }
+
     }
+    void RenderSystem::clear()
+    {
+        // 先让所有在编译中的pipeline完成，之后才能安全地写回pipeline cache
+        if (m_pipeline_build_service)
+        {
+            m_pipeline_build_service->clear();
+            m_pipeline_build_service.reset();
+        }
+        if (m_rhi)
+        {
+            // 等待GPU完成所有工作后再把pipeline cache写回磁盘
+            m_rhi->waitDeviceIdle();
+            m_rhi->savePipelineCache();
+        }
+        if (m_render_pipeline)
+        {
+            m_render_pipeline->clear();
+            m_render_pipeline.reset();
+        }
+        if (m_render_resource)
+        {
+            m_render_resource->clear();
+            m_render_resource.reset();
+        }
+        // 所有从RHI创建的资源都已释放，最后销毁设备和instance
+        if (m_rhi)
+        {
+            m_rhi->destroyDevice();
+            m_rhi.reset();
+        }
+    }
+
     std::shared_ptr<RHI> RenderSystem::getRHI() const
     {
         return m_rhi;
     }
 
+    std::shared_ptr<PipelineBuildService> RenderSystem::getPipelineBuildService() const
+    {
+        return m_pipeline_build_service;
+    }
+
 
     void  RenderSystem::tick(float delta_time) {
+        MERCURY_PROFILE_SCOPE("RenderSystem::tick");
+        // 取逻辑侧最新发布的快照，没有新快照时沿用上一份
+        const bool is_swap_data_fresh = processSwapData();
+
         // prepare render command context
         m_rhi->prepareContext();
 
@@ -52,7 +125,82 @@ namespace Mercury
         default:
             break;
         }
+
+        if (!m_frame_capture_dir.empty())
+        {
+            captureFrame();
+        }
+
+        // 沿用旧快照的帧没有新的输入，不计入延迟
+        if (is_swap_data_fresh)
+        {
+            updateInputToPresentLatency();
+        }
     }
-} // namespace Mercury
 
+    bool RenderSystem::processSwapData()
+    {
+        if (!m_swap_context.acquireRenderSwapData())
+        {
+            return false;
+        }
+
+        const RenderSwapData& swap_data = m_swap_context.getRenderSwapData();
+        if (swap_data.has_proj_view_matrix && g_runtime_global_context.m_debugdraw_manager)
+        {
+            g_runtime_global_context.m_debugdraw_manager->setProjViewMatrix(swap_data.proj_view_matrix);
+        }
+        return true;
+    }
+
+    void RenderSystem::updateInputToPresentLatency()
+    {
+        const RenderSwapData& swap_data = m_swap_context.getRenderSwapData();
+        if (swap_data.input_sample_time == std::chrono::steady_clock::time_point{})
+        {
+            return;
+        }
 
+        // 与帧率统计相同的指数滑动平均
+        const float alpha = 1.f / 100;
+        float latency = std::chrono::duration<float>(std::chrono::steady_clock::now() - swap_data.input_sample_time).count();
+        m_input_to_present_latency = m_input_to_present_latency == 0.f ?
+            latency : m_input_to_present_latency * (1 - alpha) + latency * alpha;
+    }
+
+    // 保存为二进制PPM（P6），格式足够简单，不需要引入图像库，回归测试可以直接逐字节比对
+    void RenderSystem::captureFrame()
+    {
+        MERCURY_PROFILE_SCOPE("RenderSystem::captureFrame");
+        std::vector<uint8_t> pixels;
+        if (!m_rhi->readbackPresentedImage(pixels))
+        {
+            return;
+        }
+
+        const RHIExtent2D extent = m_rhi->getSwapchainInfo().extent;
+        char file_name[32];
+        std::snprintf(file_name, sizeof(file_name), "frame_%06u.ppm", m_captured_frame_count++);
+        std::ofstream file(m_frame_capture_dir / file_name, std::ios::binary);
+        if (!file)
+        {
+            std::cout << "failed to open " << (m_frame_capture_dir / file_name).generic_string() << std::endl;
+            return;
+        }
+        file << "P6\n" << extent.width << " " << extent.height << "\n255\n";
+
+        // B8G8R8A8 -> R8G8B8
+        std::vector<uint8_t> row(extent.width * 3);
+        for (uint32_t y = 0; y < extent.height; ++y)
+        {
+            const uint8_t* src = pixels.data() + (size_t)y * extent.width * 4;
+            for (uint32_t x = 0; x < extent.width; ++x)
+            {
+                row[x * 3 + 0] = src[x * 4 + 2];
+                row[x * 3 + 1] = src[x * 4 + 1];
+                row[x * 3 + 2] = src[x * 4 + 0];
+            }
+            file.write(reinterpret_cast<const char*>(row.data()), row.size());
+        }
+    }
+} // namespace Mercury
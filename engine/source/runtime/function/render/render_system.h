@@ -1,11 +1,14 @@
 #pragma once
 
+#include <filesystem>
 #include <memory>
 
 #include "runtime/function/render/window_system.h"
 #include "runtime/function/render/interface/rhi.h"
 #include "runtime/function/render/debugdraw/debug_draw_manager.h"
+#include "runtime/function/render/pipeline_build_service.h"
 #include "runtime/function/render/render_pipeline_base.h"
+#include "runtime/function/render/render_swap_context.h"
 
 
 namespace Mercury
@@ -14,15 +17,32 @@ namespace Mercury
     {
         std::shared_ptr<WindowSystem> window_system;
         std::shared_ptr<DebugDrawManager> debugdraw_manager;
+        std::filesystem::path pipeline_cache_path;
+        std::filesystem::path frame_capture_dir; // 非空时把每帧画面回读并保存到该目录，仅headless模式可用
     };
 
     class RenderSystem {
     public:
         void initialize(RenderSystemInitInfo init_info);
+        void clear();
         std::shared_ptr<RHI> getRHI() const;
+        std::shared_ptr<PipelineBuildService> getPipelineBuildService() const;
+        // 逻辑侧通过它把每帧的render proxy交给渲染侧
+        RenderSwapContext& getSwapContext() { return m_swap_context; }
         void tick(float delta_time);
+        // 输入采样到提交present的平均耗时（秒），包含逻辑线程与渲染流水线带来的延迟，不包含显示器扫描
+        float getInputToPresentLatency() const { return m_input_to_present_latency; }
     private:
+        bool processSwapData();
+        void updateInputToPresentLatency();
+        void captureFrame();
+
+        RenderSwapContext m_swap_context;
+        float m_input_to_present_latency{ 0.f };
+        std::filesystem::path m_frame_capture_dir;
+        uint32_t m_captured_frame_count{ 0 };
         std::shared_ptr<RHI> m_rhi;
+        std::shared_ptr<PipelineBuildService> m_pipeline_build_service;
         RENDER_PIPELINE_TYPE m_render_pipeline_type{ RENDER_PIPELINE_TYPE::FORWARD_PIPELINE };
         std::shared_ptr<RenderResourceBase> m_render_resource;
         std::shared_ptr<RenderPipelineBase> m_render_pipeline;
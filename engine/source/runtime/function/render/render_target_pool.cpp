@@ -0,0 +1,114 @@
+#include "runtime/function/render/render_target_pool.h"
+
+#include <algorithm>
+
+namespace Mercury
+{
+    void RenderTargetPool::initialize(std::shared_ptr<RHI> rhi)
+    {
+        m_rhi = rhi;
+        // 桌面GPU通常没有LAZILY_ALLOCATED内存类型，此时transient render target退回到普通的device local内存
+        m_is_lazily_allocated_memory_supported = m_rhi->isMemoryPropertySupported(
+            RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | RHI_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+    }
+
+    void RenderTargetPool::clear()
+    {
+        for (auto& render_target : m_render_targets)
+        {
+            destroyRenderTarget(render_target.get());
+        }
+        m_render_targets.clear();
+        m_free_render_targets.clear();
+    }
+
+    RenderTarget* RenderTargetPool::acquire(const RenderTargetDesc& desc)
+    {
+        for (auto iter = m_free_render_targets.begin(); iter != m_free_render_targets.end(); ++iter)
+        {
+            if ((*iter)->desc == desc)
+            {
+                RenderTarget* render_target = *iter;
+                m_free_render_targets.erase(iter);
+                return render_target;
+            }
+        }
+        return createRenderTarget(desc);
+    }
+
+    void RenderTargetPool::release(RenderTarget* render_target)
+    {
+        if (render_target != nullptr)
+        {
+            m_free_render_targets.push_back(render_target);
+        }
+    }
+
+    void RenderTargetPool::trim()
+    {
+        for (RenderTarget* render_target : m_free_render_targets)
+        {
+            destroyRenderTarget(render_target);
+            m_render_targets.erase(std::find_if(m_render_targets.begin(), m_render_targets.end(),
+                [render_target](const std::unique_ptr<RenderTarget>& element) { return element.get() == render_target; }));
+        }
+        m_free_render_targets.clear();
+    }
+
+    RenderTarget* RenderTargetPool::createRenderTarget(const RenderTargetDesc& desc)
+    {
+        std::unique_ptr<RenderTarget> render_target = std::make_unique<RenderTarget>();
+        render_target->desc = desc;
+
+        RHIImageCreateInfo image_create_info{};
+        image_create_info.sType = RHI_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        image_create_info.imageType = RHI_IMAGE_TYPE_2D;
+        image_create_info.format = desc.format;
+        image_create_info.extent = { desc.width, desc.height, 1 };
+        image_create_info.mipLevels = 1;
+        image_create_info.arrayLayers = 1;
+        image_create_info.samples = RHI_SAMPLE_COUNT_1_BIT;
+        image_create_info.tiling = RHI_IMAGE_TILING_OPTIMAL;
+        image_create_info.usage = desc.usage;
+        image_create_info.sharingMode = RHI_SHARING_MODE_EXCLUSIVE;
+        image_create_info.initialLayout = RHI_IMAGE_LAYOUT_UNDEFINED;
+
+        RHIAllocationCreateInfo allocation_create_info{};
+        if (desc.is_transient)
+        {
+            // https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#memory-device-lazy_allocation
+            image_create_info.usage |= RHI_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        }
+        if (desc.is_transient && m_is_lazily_allocated_memory_supported)
+        {
+            allocation_create_info.usage = RHI_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+            allocation_create_info.requiredFlags = RHI_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+            render_target->is_lazily_allocated = true;
+        }
+        else
+        {
+            allocation_create_info.usage = RHI_MEMORY_USAGE_GPU_ONLY;
+            allocation_create_info.requiredFlags = RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        }
+
+        RHIAllocationInfo allocation_info{};
+        m_rhi->createImage(&image_create_info, &allocation_create_info, render_target->image, render_target->allocation, &allocation_info);
+        m_rhi->createImageView(render_target->image, desc.format, desc.aspect, RHI_IMAGE_VIEW_TYPE_2D, 1, 1, render_target->image_view);
+        render_target->size = allocation_info.size;
+        m_allocated_bytes += render_target->size;
+
+        m_render_targets.push_back(std::move(render_target));
+        return m_render_targets.back().get();
+    }
+
+    void RenderTargetPool::destroyRenderTarget(RenderTarget* render_target)
+    {
+        m_rhi->destroyImageView(render_target->image_view);
+        delete render_target->image_view;
+        m_rhi->destroyImage(render_target->image, render_target->allocation);
+        render_target->image_view = nullptr;
+        render_target->image = nullptr;
+        render_target->allocation = nullptr;
+        m_allocated_bytes -= render_target->size;
+    }
+} // namespace Mercury
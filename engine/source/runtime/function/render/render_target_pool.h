@@ -0,0 +1,67 @@
+#pragma once
+
+#include "runtime/function/render/interface/rhi.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Mercury
+{
+    struct RenderTargetDesc
+    {
+        RHIFormat format{ RHI_FORMAT_UNDEFINED };
+        RHIImageUsageFlags usage{ 0 };
+        RHIImageAspectFlags aspect{ RHI_IMAGE_ASPECT_COLOR_BIT };
+        uint32_t width{ 0 };
+        uint32_t height{ 0 };
+        // 内容只存在于一个render pass之内（loadOp不为LOAD、storeOp为DONT_CARE），可以使用TRANSIENT_ATTACHMENT和lazily allocated内存
+        bool is_transient{ false };
+
+        bool operator==(const RenderTargetDesc& rhs) const
+        {
+            return format == rhs.format && usage == rhs.usage && aspect == rhs.aspect &&
+                width == rhs.width && height == rhs.height && is_transient == rhs.is_transient;
+        }
+    };
+
+    struct RenderTarget
+    {
+        RenderTargetDesc desc;
+        RHIImage* image{ nullptr };
+        RHIImageView* image_view{ nullptr };
+        RHIAllocation* allocation{ nullptr };
+        RHIDeviceSize size{ 0 };
+        bool is_lazily_allocated{ false }; // 在tile-based GPU上不占用实际显存
+    };
+
+    /*
+    * 渲染目标池：按描述复用render target，而不是每次重新编译render graph/重建swapchain时全部销毁重建
+    * • acquire优先返回空闲列表中描述一致的render target
+    * • release只归还到空闲列表，trim时才真正销毁仍然空闲的render target
+    */
+    class RenderTargetPool
+    {
+    public:
+        void initialize(std::shared_ptr<RHI> rhi);
+        void clear();
+
+        RenderTarget* acquire(const RenderTargetDesc& desc);
+        void release(RenderTarget* render_target);
+        // 调用者需保证GPU不再使用空闲列表中的render target
+        void trim();
+
+        uint32_t getRenderTargetCount() const { return static_cast<uint32_t>(m_render_targets.size()); }
+        RHIDeviceSize getAllocatedBytes() const { return m_allocated_bytes; }
+
+    private:
+        RenderTarget* createRenderTarget(const RenderTargetDesc& desc);
+        void destroyRenderTarget(RenderTarget* render_target);
+
+        std::shared_ptr<RHI> m_rhi;
+        std::vector<std::unique_ptr<RenderTarget>> m_render_targets;
+        std::vector<RenderTarget*> m_free_render_targets;
+        bool m_is_lazily_allocated_memory_supported{ false };
+        RHIDeviceSize m_allocated_bytes{ 0 };
+    };
+} // namespace Mercury
@@ -81,6 +81,7 @@ namespace Mercury
     typedef uint64_t RHIDeviceSize;
     typedef uint32_t RHIFlags;
     typedef uint32_t RHISampleMask;
+    typedef uint32_t RHIAllocationCreateFlags;
 
     enum RHICullModeFlagBits {
         RHI_CULL_MODE_NONE = 0,
@@ -1090,6 +1091,14 @@ namespace Mercury
         RHI_VERTEX_INPUT_RATE_MAX_ENUM = 0x7FFFFFFF
     };
 
+    enum RHIIndexType : int {
+        RHI_INDEX_TYPE_UINT16 = 0,
+        RHI_INDEX_TYPE_UINT32 = 1,
+        RHI_INDEX_TYPE_NONE_KHR = 1000165000,
+        RHI_INDEX_TYPE_UINT8_EXT = 1000265000,
+        RHI_INDEX_TYPE_MAX_ENUM = 0x7FFFFFFF
+    };
+
     enum RHIPrimitiveTopology : int
     {
         RHI_PRIMITIVE_TOPOLOGY_POINT_LIST = 0,
@@ -1335,6 +1344,22 @@ namespace Mercury
         RHI_PIPELINE_BIND_POINT_MAX_ENUM = 0x7FFFFFFF
     };
 
+    enum RHIDescriptorType : int
+    {
+        RHI_DESCRIPTOR_TYPE_SAMPLER = 0,
+        RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER = 1,
+        RHI_DESCRIPTOR_TYPE_SAMPLED_IMAGE = 2,
+        RHI_DESCRIPTOR_TYPE_STORAGE_IMAGE = 3,
+        RHI_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER = 4,
+        RHI_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER = 5,
+        RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER = 6,
+        RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER = 7,
+        RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC = 8,
+        RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC = 9,
+        RHI_DESCRIPTOR_TYPE_INPUT_ATTACHMENT = 10,
+        RHI_DESCRIPTOR_TYPE_MAX_ENUM = 0x7FFFFFFF
+    };
+
     enum RHIPipelineStageFlagBits {
         RHI_PIPELINE_STAGE_TOP_OF_PIPE_BIT = 0x00000001,
         RHI_PIPELINE_STAGE_DRAW_INDIRECT_BIT = 0x00000002,
@@ -1425,6 +1450,41 @@ namespace Mercury
         RHI_COMPARE_OP_MAX_ENUM = 0x7FFFFFFF
     };
 
+    enum RHIFilter : int
+    {
+        RHI_FILTER_NEAREST = 0,
+        RHI_FILTER_LINEAR = 1,
+        RHI_FILTER_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    enum RHISamplerMipmapMode : int
+    {
+        RHI_SAMPLER_MIPMAP_MODE_NEAREST = 0,
+        RHI_SAMPLER_MIPMAP_MODE_LINEAR = 1,
+        RHI_SAMPLER_MIPMAP_MODE_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    enum RHISamplerAddressMode : int
+    {
+        RHI_SAMPLER_ADDRESS_MODE_REPEAT = 0,
+        RHI_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT = 1,
+        RHI_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE = 2,
+        RHI_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER = 3,
+        RHI_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE = 4,
+        RHI_SAMPLER_ADDRESS_MODE_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    enum RHIBorderColor : int
+    {
+        RHI_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK = 0,
+        RHI_BORDER_COLOR_INT_TRANSPARENT_BLACK = 1,
+        RHI_BORDER_COLOR_FLOAT_OPAQUE_BLACK = 2,
+        RHI_BORDER_COLOR_INT_OPAQUE_BLACK = 3,
+        RHI_BORDER_COLOR_FLOAT_OPAQUE_WHITE = 4,
+        RHI_BORDER_COLOR_INT_OPAQUE_WHITE = 5,
+        RHI_BORDER_COLOR_MAX_ENUM = 0x7FFFFFFF
+    };
+
     enum RHIStencilOp : int {
         RHI_STENCIL_OP_KEEP = 0,
         RHI_STENCIL_OP_ZERO = 1,
@@ -1437,9 +1497,144 @@ namespace Mercury
         RHI_STENCIL_OP_MAX_ENUM = 0x7FFFFFFF
     };
 
+    enum RHIPresentModeKHR {
+        RHI_PRESENT_MODE_IMMEDIATE_KHR = 0,
+        RHI_PRESENT_MODE_MAILBOX_KHR = 1,
+        RHI_PRESENT_MODE_FIFO_KHR = 2,
+        RHI_PRESENT_MODE_FIFO_RELAXED_KHR = 3,
+        RHI_PRESENT_MODE_MAX_ENUM_KHR = 0x7FFFFFFF
+    };
+
+    enum RHICommandBufferLevel {
+        RHI_COMMAND_BUFFER_LEVEL_PRIMARY = 0,
+        RHI_COMMAND_BUFFER_LEVEL_SECONDARY = 1,
+        RHI_COMMAND_BUFFER_LEVEL_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    enum RHICommandBufferUsageFlagBits {
+        RHI_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT = 0x00000001,
+        RHI_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT = 0x00000002,
+        RHI_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT = 0x00000004,
+        RHI_COMMAND_BUFFER_USAGE_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
+
     enum RHISubpassContents {
         RHI_SUBPASS_CONTENTS_INLINE = 0,
         RHI_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS = 1,
         RHI_SUBPASS_CONTENTS_MAX_ENUM = 0x7FFFFFFF
     };
+
+    enum RHIBufferUsageFlagBits {
+        RHI_BUFFER_USAGE_TRANSFER_SRC_BIT = 0x00000001,
+        RHI_BUFFER_USAGE_TRANSFER_DST_BIT = 0x00000002,
+        RHI_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT = 0x00000004,
+        RHI_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT = 0x00000008,
+        RHI_BUFFER_USAGE_UNIFORM_BUFFER_BIT = 0x00000010,
+        RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT = 0x00000020,
+        RHI_BUFFER_USAGE_INDEX_BUFFER_BIT = 0x00000040,
+        RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT = 0x00000080,
+        RHI_BUFFER_USAGE_INDIRECT_BUFFER_BIT = 0x00000100,
+        RHI_BUFFER_USAGE_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    enum RHIImageUsageFlagBits {
+        RHI_IMAGE_USAGE_TRANSFER_SRC_BIT = 0x00000001,
+        RHI_IMAGE_USAGE_TRANSFER_DST_BIT = 0x00000002,
+        RHI_IMAGE_USAGE_SAMPLED_BIT = 0x00000004,
+        RHI_IMAGE_USAGE_STORAGE_BIT = 0x00000008,
+        RHI_IMAGE_USAGE_COLOR_ATTACHMENT_BIT = 0x00000010,
+        RHI_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT = 0x00000020,
+        RHI_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT = 0x00000040,
+        RHI_IMAGE_USAGE_INPUT_ATTACHMENT_BIT = 0x00000080,
+        RHI_IMAGE_USAGE_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    enum RHIMemoryPropertyFlagBits {
+        RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT = 0x00000001,
+        RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT = 0x00000002,
+        RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT = 0x00000004,
+        RHI_MEMORY_PROPERTY_HOST_CACHED_BIT = 0x00000008,
+        RHI_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT = 0x00000010,
+        RHI_MEMORY_PROPERTY_PROTECTED_BIT = 0x00000020,
+        RHI_MEMORY_PROPERTY_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    enum RHISharingMode : int {
+        RHI_SHARING_MODE_EXCLUSIVE = 0,
+        RHI_SHARING_MODE_CONCURRENT = 1,
+        RHI_SHARING_MODE_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    enum RHIImageType : int {
+        RHI_IMAGE_TYPE_1D = 0,
+        RHI_IMAGE_TYPE_2D = 1,
+        RHI_IMAGE_TYPE_3D = 2,
+        RHI_IMAGE_TYPE_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    enum RHIImageTiling : int {
+        RHI_IMAGE_TILING_OPTIMAL = 0,
+        RHI_IMAGE_TILING_LINEAR = 1,
+        RHI_IMAGE_TILING_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    // 仿照VmaMemoryUsage：描述分配的内存将被如何使用，由分配器据此挑选合适的内存类型
+    enum RHIMemoryUsage : int {
+        RHI_MEMORY_USAGE_UNKNOWN = 0,
+        RHI_MEMORY_USAGE_GPU_ONLY = 1,
+        RHI_MEMORY_USAGE_CPU_ONLY = 2,
+        RHI_MEMORY_USAGE_CPU_TO_GPU = 3,
+        RHI_MEMORY_USAGE_GPU_TO_CPU = 4,
+        RHI_MEMORY_USAGE_CPU_COPY = 5,
+        RHI_MEMORY_USAGE_GPU_LAZILY_ALLOCATED = 6,
+        RHI_MEMORY_USAGE_AUTO = 7,
+        RHI_MEMORY_USAGE_AUTO_PREFER_DEVICE = 8,
+        RHI_MEMORY_USAGE_AUTO_PREFER_HOST = 9,
+        RHI_MEMORY_USAGE_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    // 仿照VmaAllocationCreateFlagBits
+    enum RHIAllocationCreateFlagBits {
+        RHI_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT = 0x00000001,
+        RHI_ALLOCATION_CREATE_NEVER_ALLOCATE_BIT = 0x00000002,
+        RHI_ALLOCATION_CREATE_MAPPED_BIT = 0x00000004,
+        RHI_ALLOCATION_CREATE_WITHIN_BUDGET_BIT = 0x00000100,
+        RHI_ALLOCATION_CREATE_CAN_ALIAS_BIT = 0x00000200,
+        RHI_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT = 0x00000400,
+        RHI_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT = 0x00000800,
+        RHI_ALLOCATION_CREATE_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    enum RHIImageAspectFlagBits {
+        RHI_IMAGE_ASPECT_COLOR_BIT = 0x00000001,
+        RHI_IMAGE_ASPECT_DEPTH_BIT = 0x00000002,
+        RHI_IMAGE_ASPECT_STENCIL_BIT = 0x00000004,
+        RHI_IMAGE_ASPECT_METADATA_BIT = 0x00000008,
+        RHI_IMAGE_ASPECT_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    enum RHIImageViewType : int {
+        RHI_IMAGE_VIEW_TYPE_1D = 0,
+        RHI_IMAGE_VIEW_TYPE_2D = 1,
+        RHI_IMAGE_VIEW_TYPE_3D = 2,
+        RHI_IMAGE_VIEW_TYPE_CUBE = 3,
+        RHI_IMAGE_VIEW_TYPE_1D_ARRAY = 4,
+        RHI_IMAGE_VIEW_TYPE_2D_ARRAY = 5,
+        RHI_IMAGE_VIEW_TYPE_CUBE_ARRAY = 6,
+        RHI_IMAGE_VIEW_TYPE_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    enum RHIDependencyFlagBits {
+        RHI_DEPENDENCY_BY_REGION_BIT = 0x00000001,
+        RHI_DEPENDENCY_DEVICE_GROUP_BIT = 0x00000004,
+        RHI_DEPENDENCY_VIEW_LOCAL_BIT = 0x00000002,
+        RHI_DEPENDENCY_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    enum RHIPipelineCreateFlagBits {
+        RHI_PIPELINE_CREATE_DISABLE_OPTIMIZATION_BIT = 0x00000001,
+        RHI_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT = 0x00000002,
+        RHI_PIPELINE_CREATE_DERIVATIVE_BIT = 0x00000004,
+        RHI_PIPELINE_CREATE_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
 } // namespace Mercury
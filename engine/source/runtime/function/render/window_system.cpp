@@ -4,11 +4,24 @@ namespace Mercury
 {
     WindowSystem::~WindowSystem()
     {
+        if (m_is_headless)
+        {
+            return;
+        }
         glfwDestroyWindow(m_window);
         glfwTerminate();
     }
 
     void WindowSystem::initialize(WindowCreateInfo create_info) {
+        m_is_headless = create_info.is_headless;
+        if (m_is_headless)
+        {
+            // 只记录离屏渲染的分辨率
+            m_width = create_info.width;
+            m_height = create_info.height;
+            return;
+        }
+
         if (!glfwInit()) // 尝试初始化glfw
         {                // TODO: 日志系统
             return;      // 失败后终止
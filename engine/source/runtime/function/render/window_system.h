@@ -11,6 +11,8 @@ namespace Mercury
         int height{ 720 };
         const char* title{ "Mercury" };
         bool is_fullscreen{ false };
+        // 不创建窗口也不初始化GLFW，用于没有显示设备的机器（例如CI上的性能与回归测试），渲染结果只存在于离屏图像中
+        bool is_headless{ false };
     };
 
     class WindowSystem
@@ -19,15 +21,20 @@ namespace Mercury
         WindowSystem() = default;
         ~WindowSystem();
         void initialize(WindowCreateInfo);
-        void pollEvents() const { glfwPollEvents(); };
-        bool shouldClose() const { return glfwWindowShouldClose(m_window); };
-        void setTitle(const char* title) { glfwSetWindowTitle(m_window, title); };
+        void pollEvents() const { if (m_window) glfwPollEvents(); };
+        bool shouldClose() const { return m_is_close_requested || (m_window && glfwWindowShouldClose(m_window)); };
+        void setTitle(const char* title) { if (m_window) glfwSetWindowTitle(m_window, title); };
+        // 由调用者决定何时退出，例如headless运行固定帧数之后
+        void requestClose() { m_is_close_requested = true; }
+        bool isHeadless() const { return m_is_headless; }
         GLFWwindow* WindowSystem::getWindow() const { return m_window; }
         std::array<int, 2> WindowSystem::getWindowSize() const { return std::array<int, 2>({m_width, m_height}); }
     private:
         GLFWwindow* m_window{ nullptr };
         int m_width{ 0 };
         int m_height{ 0 };
+        bool m_is_headless{ false };
+        bool m_is_close_requested{ false };
 
 
     };